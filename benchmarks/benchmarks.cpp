@@ -33,6 +33,8 @@
 #include <cstdlib>
 #include <memory>
 #include <functional>
+#include <random>
+#include <string>
 
 #include "benchmarks.hpp"
 
@@ -249,5 +251,51 @@ int main(){
         }
     }
 
+    /* the literal count drives the FDR domain and so the size of the
+     * reach table, which is what these runs compare; literals and data
+     * are drawn from all byte values so that the whole table is live.
+     * Planted 'a'/'b' matches mean nothing to random literals, so each table
+     * is built once and only run without them. */
+    for (u32 num_lits : {200, 2000, 20000}) {
+        std::mt19937 prng(num_lits);
+        std::uniform_int_distribution<int> dist(0, 255);
+        std::vector<ue2::hwlmLiteral> lits;
+        for (u32 j = 0; j < num_lits; j++) {
+            std::string s;
+            for (size_t k = 0; k < 8; k++) {
+                s += (char)dist(prng);
+            }
+            lits.emplace_back(s, false, j);
+        }
+        ue2::Grey grey;
+        grey.fdrAllowTeddy = false;
+        auto proto = ue2::fdrBuildProto(HWLM_ENGINE_FDR, lits, false,
+                                        ue2::get_current_target(), grey);
+        auto fdr = ue2::fdrBuildTable(*proto, grey);
+        assert(fdr != nullptr);
+        std::string label = "FDR " + std::to_string(num_lits) +
+                            " literals, " +
+                            std::to_string(fdr->tabSize / 1024) +
+                            " KB reach table";
+
+        for (size_t i = 0; i < std::size(sizes); i++) {
+            MicroBenchmark bench(label.c_str(), sizes[i]);
+            run_benchmarks(sizes[i], MAX_LOOPS / sizes[i], 0, false, bench,
+                [&](MicroBenchmark &b) {
+                    ctxt.clear();
+                    b.scratch.fdr_conf = nullptr;
+                    for (auto &c : b.buf) {
+                        c = dist(prng);
+                    }
+                },
+                [&](MicroBenchmark &b) {
+                    ctxt.clear();
+                    fdrExec(fdr.get(), b.buf.data(), b.size, 0, hlmSimpleCallback, &b.scratch, ~0ULL);
+                    return b.buf.data() + b.size;
+                }
+            );
+        }
+    }
+
     return 0;
 }
@@ -34,7 +34,13 @@
 #include "hwlm/noodle_build.h"
 #include "hwlm/noodle_engine.h"
 #include "hwlm/noodle_internal.h"
+#include "hwlm/hwlm_internal.h"
 #include "hwlm/hwlm_literal.h"
+#include "fdr/fdr.h"
+#include "fdr/fdr_compile.h"
+#include "fdr/fdr_internal.h"
+#include "grey.h"
+#include "util/target_info.h"
 #include "util/bytecode_ptr.h"
 #include "scratch.h"
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Engine-level benchmarks for the 32 and 64 state Sheng engines
+ * against McClellan on the same DFA.
+ *
+ * These engines are only selected where the target has a wide sheng runtime
+ * (target_t::has_wide_sheng()); this compares them with the McClellan DFA
+ * that would be used otherwise. DFAs are generated from a fixed seed:
+ *
+ *  - dense: every state is reachable from every other, sized for Sheng32
+ *    (17-32 states) or Sheng64 (33-64 states)
+ *  - core: a dense core of 17-64 states plus a tail of rarely visited
+ *    states, the shape McSheng64 is built for
+ *
+ * Each case prints one CSV row per engine on stdout:
+ *
+ *  - engine: sheng32, sheng64, mcsheng64 or mcclellan
+ *  - shape, states: the generated DFA
+ *  - bytes: buffer size
+ *  - mb_per_s: best-of-trials throughput
+ *  - matches_per_kb: callbacks per KB of data
+ *
+ * Nothing is printed for a DFA the wide engine cannot be built for, which is
+ * every DFA on a target without a wide sheng runtime.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "grey.h"
+#include "nfa/callback.h"
+#include "nfa/mcclellancompile.h"
+#include "nfa/mcsheng_compile.h"
+#include "nfa/nfa_api.h"
+#include "nfa/nfa_api_queue.h"
+#include "nfa/nfa_internal.h"
+#include "nfa/rdfa.h"
+#include "nfa/shengcompile.h"
+#include "util/bytecode_ptr.h"
+#include "util/compile_context.h"
+#include "util/report_manager.h"
+#include "util/target_info.h"
+#include "util/random_dfa.h"
+
+/** \brief bytes scanned per timing trial, split into repeated scans */
+#define TRIAL_BYTES  (16 << 20)
+#define TRIALS       3
+
+#define DFAS_PER_SHAPE 10
+#define REPORT_COUNT   3
+#define REPORT_RATE    30
+
+static const size_t buf_sizes[] = {16 << 10, 4 << 20};
+
+static size_t num_matches;
+
+static
+int countCallback(UNUSED u64a start, UNUSED u64a end, UNUSED ReportID id,
+                  UNUSED void *ctx) {
+    num_matches++;
+    return MO_CONTINUE_MATCHING;
+}
+
+static
+void scan(const NFA *nfa, std::vector<char> &state,
+          std::vector<char> &stream_state, const std::vector<u8> &buf) {
+    struct mq q;
+    q.nfa = nfa;
+    q.cur = 0;
+    q.end = 0;
+    q.state = state.data();
+    q.streamState = stream_state.data();
+    q.offset = 0;
+    q.buffer = buf.data();
+    q.length = buf.size();
+    q.history = nullptr;
+    q.hlength = 0;
+    q.scratch = nullptr; /* outfix DFAs do not use scratch */
+    q.report_current = 0;
+    q.cb = countCallback;
+    q.context = nullptr;
+    nfaQueueInitState(nfa, &q);
+    pushQueue(&q, MQE_START, 0);
+    pushQueue(&q, MQE_TOP, 0);
+    pushQueue(&q, MQE_END, buf.size());
+    nfaQueueExec(nfa, &q, buf.size());
+}
+
+static
+void benchEngine(const char *engine, const char *shape, u32 states,
+                 const NFA *nfa, const std::vector<u8> &buf) {
+    std::vector<char> state(nfa->scratchStateSize);
+    std::vector<char> stream_state(nfa->streamStateSize);
+    size_t reps = std::max<size_t>(1, TRIAL_BYTES / buf.size());
+    double best = 0.0;
+    for (u32 t = 0; t < TRIALS; t++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < reps; i++) {
+            scan(nfa, state, stream_state, buf);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, reps * buf.size() / dt / 1048576.0);
+    }
+    num_matches = 0;
+    scan(nfa, state, stream_state, buf);
+    printf("%s,%s,%u,%zu,%.1f,%.3f\n", engine, shape, states, buf.size(), best,
+           num_matches / (buf.size() / 1024.0));
+}
+
+int main() {
+    printf("engine,shape,states,bytes,mb_per_s,matches_per_kb\n");
+
+    ue2::Grey grey;
+    ue2::target_t target = ue2::get_current_target();
+    ue2::CompileContext cc(false, false, target, grey);
+    ue2::ReportManager rm(grey);
+    for (u32 i = 0; i < REPORT_COUNT; i++) {
+        rm.getInternalId(ue2::makeCallback(i, 0));
+        rm.setProgramOffset(i, i);
+    }
+
+    std::mt19937 prng(21);
+    std::vector<std::vector<u8>> bufs;
+    for (size_t size : buf_sizes) {
+        bufs.emplace_back(size);
+        for (auto &c : bufs.back()) {
+            c = prng();
+        }
+    }
+
+    for (u32 i = 0; i < 3 * DFAS_PER_SHAPE; i++) {
+        const char *shape = i < 2 * DFAS_PER_SHAPE ? "dense" : "core";
+        u32 core = i < DFAS_PER_SHAPE ? 17 + prng() % 16 : 33 + prng() % 32;
+        u32 tail = 0;
+        if (i >= 2 * DFAS_PER_SHAPE) {
+            core = 17 + prng() % 48;
+            tail = 30 + prng() % 200;
+        }
+        ue2::raw_dfa raw = makeRandomDfa(core, tail, REPORT_COUNT,
+                                         REPORT_RATE, 0, prng);
+        ue2::raw_dfa mc_raw = raw;
+
+        const char *engine;
+        ue2::bytecode_ptr<NFA> wide;
+        if (tail) {
+            /* skip DFAs that the 16 state McSheng would take */
+            ue2::raw_dfa mcsheng_raw = raw;
+            if (ue2::mcshengCompile(mcsheng_raw, cc, rm)) {
+                continue;
+            }
+            engine = "mcsheng64";
+            wide = ue2::mcshengCompile64(raw, cc, rm);
+        } else if (core <= 32) {
+            engine = "sheng32";
+            wide = ue2::sheng32Compile(raw, cc, rm, false);
+        } else {
+            engine = "sheng64";
+            wide = ue2::sheng64Compile(raw, cc, rm, false);
+        }
+        if (!wide) {
+            continue;
+        }
+        auto mcclellan = ue2::mcclellanCompile(mc_raw, cc, rm, false);
+        u32 states = (u32)raw.states.size();
+        for (const auto &buf : bufs) {
+            benchEngine(engine, shape, states, wide.get(), buf);
+            benchEngine("mcclellan", shape, states, mcclellan.get(), buf);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Engine-level benchmarks for the literal matchers (Noodle,
+ * multi-literal Noodle, Teddy and FDR).
+ *
+ * Literal sets are generated from a fixed seed and planted into random
+ * printable data at a fixed density, so numbers are comparable between
+ * builds. Each buffer is generated once per literal set, and every engine
+ * scans the same buffers. Each case prints one CSV row on stdout:
+ *
+ *  - engine: noodle, noodle-multi (two to NOOD_MULTI_MAX literals), teddy,
+ *    fdr
+ *  - literals, min_len, nocase: the generated literal set
+ *  - buckets: buckets used by the built Teddy/FDR engine
+ *  - bytes, planted_per_kb: buffer size and planted literal density
+ *  - mb_per_s: best-of-trials throughput
+ *  - matches_per_kb: callbacks per KB of data
+ *  - confirms_per_kb: candidates checked by the engine's confirm step per KB
+ *    of data; left empty unless the library was built with SCAN_STATS
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "grey.h"
+#include "scan_stats.h"
+#include "scratch.h"
+#include "fdr/fdr.h"
+#include "fdr/fdr_compile.h"
+#include "fdr/fdr_compile_internal.h"
+#include "fdr/fdr_engine_description.h"
+#include "fdr/fdr_internal.h"
+#include "fdr/teddy_engine_description.h"
+#include "hwlm/hwlm_build.h"
+#include "hwlm/hwlm_internal.h"
+#include "hwlm/hwlm_literal.h"
+#include "hwlm/noodle_build.h"
+#include "hwlm/noodle_engine.h"
+#include "hwlm/noodle_internal.h"
+#include "util/bytecode_ptr.h"
+#include "util/compare.h"
+#include "util/target_info.h"
+#include "util/ue2string.h"
+
+/** \brief bytes scanned per timing trial, split into repeated scans */
+#define TRIAL_BYTES  (16 << 20)
+#define TRIALS       3
+
+struct LitSetSpec {
+    u32 count;
+    u32 len;
+    bool nocase;
+};
+
+/* small sets sweep Noodle and Teddy bucket pressure, the rest sweep FDR
+ * table size, literal length and case sensitivity */
+static const LitSetSpec lit_sets[] = {
+    {1, 8, false},     {1, 8, true},      {1, 3, false},
+    {2, 8, false},     {3, 5, true},      {4, 8, false},
+    {16, 8, false},    {32, 8, false},    {64, 8, false},
+    {16, 3, false},    {16, 8, true},     {200, 8, false},
+    {2000, 8, false},  {2000, 4, false},  {2000, 8, true},
+    {20000, 8, false}, {20000, 8, true},  {60000, 8, false},
+};
+
+static const size_t buf_sizes[] = {1 << 10, 16 << 10, 256 << 10, 4 << 20};
+
+static const u32 planted_per_kb[] = {0, 1, 16};
+
+static size_t num_matches;
+
+static
+hwlmcb_rv_t countCallback(UNUSED size_t end, UNUSED u32 id,
+                          UNUSED struct hs_scratch *scratch) {
+    num_matches++;
+    return HWLM_CONTINUE_MATCHING;
+}
+
+static
+char randomChar(std::mt19937 &prng) {
+    std::uniform_int_distribution<int> dist(' ', '~');
+    return (char)dist(prng);
+}
+
+static
+std::vector<ue2::hwlmLiteral> makeLiterals(const LitSetSpec &spec,
+                                           std::mt19937 &prng) {
+    std::set<std::string> seen;
+    std::vector<ue2::hwlmLiteral> lits;
+    while (lits.size() < spec.count) {
+        std::string s;
+        for (u32 i = 0; i < spec.len; i++) {
+            s += randomChar(prng);
+        }
+        if (spec.nocase) {
+            ue2::upperString(s);
+        }
+        if (seen.insert(s).second) {
+            lits.emplace_back(s, spec.nocase, (u32)lits.size());
+        }
+    }
+    return lits;
+}
+
+static
+std::vector<u8> makeData(size_t size, u32 density,
+                         const std::vector<ue2::hwlmLiteral> &lits,
+                         std::mt19937 &prng) {
+    std::vector<u8> buf(size);
+    for (auto &c : buf) {
+        c = randomChar(prng);
+    }
+    size_t planted = size * density / 1024;
+    for (size_t i = 0; i < planted; i++) {
+        const auto &lit = lits[prng() % lits.size()];
+        size_t pos = prng() % (size - lit.s.size() + 1);
+        for (size_t j = 0; j < lit.s.size(); j++) {
+            u8 c = lit.s[j];
+            if (lit.nocase && (prng() & 1)) {
+                c = mytolower(c);
+            }
+            buf[pos + j] = c;
+        }
+    }
+    return buf;
+}
+
+struct Buffer {
+    size_t size;
+    u32 density;
+    std::vector<u8> data;
+};
+
+static
+std::vector<Buffer> makeBuffers(const std::vector<ue2::hwlmLiteral> &lits,
+                                std::mt19937 &prng) {
+    std::vector<Buffer> bufs;
+    for (size_t size : buf_sizes) {
+        for (u32 density : planted_per_kb) {
+            bufs.push_back({size, density,
+                            makeData(size, density, lits, prng)});
+        }
+    }
+    return bufs;
+}
+
+struct Result {
+    double mb_per_s;
+    double matches_per_kb;
+    double confirms_per_kb;
+};
+
+template<typename ScanFunc>
+static
+Result timeScans(const std::vector<u8> &buf, ScanFunc &&scan) {
+    size_t reps = std::max<size_t>(1, TRIAL_BYTES / buf.size());
+    double best = 0.0;
+    for (u32 t = 0; t < TRIALS; t++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < reps; i++) {
+            scan();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, reps * buf.size() / dt / 1048576.0);
+    }
+    num_matches = 0;
+#ifdef SCAN_STATS
+    hs_scan_stats_t stats = {};
+    scan_stats_current = &stats;
+    scan();
+    scan_stats_current = nullptr;
+    double confirms = stats.literal_confirms;
+#else
+    scan();
+    double confirms = 0.0;
+#endif
+    double kb = buf.size() / 1024.0;
+    return {best, num_matches / kb, confirms / kb};
+}
+
+static
+void printRow(const char *engine, const LitSetSpec &spec, u32 buckets,
+              const Buffer &buf, const Result &r) {
+    printf("%s,%u,%u,%d,%u,%zu,%u,%.1f,%.3f,", engine, spec.count, spec.len,
+           (int)spec.nocase, buckets, buf.size, buf.density, r.mb_per_s,
+           r.matches_per_kb);
+#ifdef SCAN_STATS
+    printf("%.3f", r.confirms_per_kb);
+#endif
+    printf("\n");
+}
+
+static
+void benchFdr(const char *engine, const LitSetSpec &spec,
+              const std::vector<ue2::hwlmLiteral> &lits,
+              const std::vector<Buffer> &bufs, const ue2::Grey &grey,
+              bool want_teddy) {
+    auto proto = ue2::fdrBuildProto(HWLM_ENGINE_FDR, lits, false,
+                                    ue2::get_current_target(), grey);
+    if (!proto || !!proto->teddyEng != want_teddy) {
+        return;
+    }
+    u32 buckets = proto->teddyEng ? proto->teddyEng->getNumBuckets()
+                                  : proto->fdrEng->getNumBuckets();
+    auto fdr = ue2::fdrBuildTable(*proto, grey);
+    if (!fdr) {
+        return;
+    }
+    struct hs_scratch scratch = {};
+    for (const auto &buf : bufs) {
+        Result r = timeScans(buf.data, [&] {
+            fdrExec(fdr.get(), buf.data.data(), buf.size, 0, countCallback,
+                    &scratch, HWLM_ALL_GROUPS);
+        });
+        printRow(engine, spec, buckets, buf, r);
+    }
+}
+
+static
+void benchNoodle(const LitSetSpec &spec,
+                 const std::vector<ue2::hwlmLiteral> &lits,
+                 const std::vector<Buffer> &bufs) {
+    auto nt = ue2::noodBuildTable(lits[0]);
+    struct hs_scratch scratch = {};
+    for (const auto &buf : bufs) {
+        Result r = timeScans(buf.data, [&] {
+            noodExec(nt.get(), buf.data.data(), buf.size, 0, countCallback,
+                     &scratch);
+        });
+        printRow("noodle", spec, 0, buf, r);
+    }
+}
+
+static
+void benchNoodleMulti(const LitSetSpec &spec,
+                      const std::vector<ue2::hwlmLiteral> &lits,
+                      const std::vector<Buffer> &bufs) {
+    auto nm = ue2::noodBuildMultiTable(lits);
+    struct hs_scratch scratch = {};
+    for (const auto &buf : bufs) {
+        Result r = timeScans(buf.data, [&] {
+            noodMultiExec(nm.get(), buf.data.data(), buf.size, 0,
+                          countCallback, &scratch, HWLM_ALL_GROUPS);
+        });
+        printRow("noodle-multi", spec, 0, buf, r);
+    }
+}
+
+int main() {
+    printf("engine,literals,min_len,nocase,buckets,bytes,planted_per_kb,"
+           "mb_per_s,matches_per_kb,confirms_per_kb\n");
+
+    for (const auto &spec : lit_sets) {
+        std::mt19937 prng(spec.count * 31 + spec.len * 2 + spec.nocase);
+        auto lits = makeLiterals(spec, prng);
+        auto bufs = makeBuffers(lits, prng);
+
+        if (spec.count == 1) {
+            benchNoodle(spec, lits, bufs);
+        } else if (spec.count <= NOOD_MULTI_MAX) {
+            benchNoodleMulti(spec, lits, bufs);
+        }
+
+        ue2::Grey grey;
+        benchFdr("teddy", spec, lits, bufs, grey, true);
+
+        grey.fdrAllowTeddy = false;
+        benchFdr("fdr", spec, lits, bufs, grey, false);
+    }
+
+    return 0;
+}
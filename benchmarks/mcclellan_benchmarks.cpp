@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Engine-level benchmarks for the lockstep multi-block McClellan scan
+ * (nfaExecMcClellanMulti_B) against scanning the same blocks one at a time
+ * with nfaExecMcClellan8_B/nfaExecMcClellan16_B.
+ *
+ * DFAs are generated from a fixed seed, and each lane scans its own random
+ * buffer. Each case prints one CSV row per scan method on stdout:
+ *
+ *  - method: single (one _B call per block) or multi (one
+ *    nfaExecMcClellanMulti_B call for all blocks)
+ *  - width: 8 or 16 bit McClellan
+ *  - states: states in each generated DFA
+ *  - accel: whether the DFAs were built with acceleration
+ *  - dfas: shared (every lane scans the same DFA) or mixed (one DFA per lane)
+ *  - lanes: number of blocks scanned together
+ *  - bytes: buffer size per lane
+ *  - mb_per_s: best-of-trials throughput over all lanes
+ *  - matches_per_kb: callbacks per KB of data
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "grey.h"
+#include "nfa/callback.h"
+#include "nfa/mcclellan.h"
+#include "nfa/mcclellancompile.h"
+#include "nfa/nfa_internal.h"
+#include "nfa/rdfa.h"
+#include "util/bytecode_ptr.h"
+#include "util/compile_context.h"
+#include "util/report_manager.h"
+#include "util/target_info.h"
+
+/** \brief bytes scanned per timing trial, split into repeated scans */
+#define TRIAL_BYTES  (16 << 20)
+#define TRIALS       3
+
+#define REPORT_COUNT 3
+
+struct DfaSpec {
+    u32 states;
+    bool accel;
+};
+
+/* 8 bit DFAs with and without acceleration, and 16 bit DFAs */
+static const DfaSpec dfa_specs[] = {
+    {100, false}, {100, true}, {240, false}, {1000, false}, {1000, true},
+};
+
+static const u32 lane_counts[] = {2, 4, 8};
+
+static const size_t buf_sizes[] = {16 << 10, 1 << 20};
+
+static size_t num_matches;
+
+static
+int countCallback(UNUSED u64a start, UNUSED u64a end, UNUSED ReportID id,
+                  UNUSED void *ctx) {
+    num_matches++;
+    return MO_CONTINUE_MATCHING;
+}
+
+/** \brief Random anchored DFA with a few byte classes. One state in four
+ * loops on every class but the first, to give the accelerator something to
+ * do. */
+static
+ue2::raw_dfa makeDfa(u32 nstates, std::mt19937 &prng) {
+    ue2::raw_dfa r(ue2::NFA_OUTFIX);
+    u32 nclass = 4 + prng() % 12;
+    r.alpha_size = nclass + 1;
+    for (u32 c = 0; c < N_CHARS; c++) {
+        r.alpha_remap[c] = prng() % nclass;
+    }
+    r.alpha_remap[ue2::TOP] = nclass;
+
+    for (u32 s = 0; s < nstates; s++) {
+        ue2::dstate d(r.alpha_size);
+        if (s != ue2::DEAD_STATE) {
+            bool self_loop = prng() % 4 == 0;
+            for (u32 a = 0; a < nclass; a++) {
+                if (self_loop && a) {
+                    d.next[a] = s;
+                } else {
+                    d.next[a] = 1 + prng() % (nstates - 1);
+                }
+            }
+            d.next[nclass] = 1;
+            if (prng() % 30 == 0) {
+                d.reports.insert(prng() % REPORT_COUNT);
+            }
+        }
+        r.states.push_back(d);
+    }
+    r.start_anchored = 1;
+    r.start_floating = ue2::DEAD_STATE;
+    return r;
+}
+
+static
+void scanSingle(const std::vector<mcclellan_multi_block> &blocks) {
+    for (const auto &b : blocks) {
+        if (b.nfa->type == MCCLELLAN_NFA_8) {
+            nfaExecMcClellan8_B(b.nfa, b.offset, b.buffer, b.length, b.cb,
+                                b.context);
+        } else {
+            nfaExecMcClellan16_B(b.nfa, b.offset, b.buffer, b.length, b.cb,
+                                 b.context);
+        }
+    }
+}
+
+static
+void scanMulti(const std::vector<mcclellan_multi_block> &blocks) {
+    nfaExecMcClellanMulti_B(blocks.data(), (u32)blocks.size());
+}
+
+template<typename ScanFunc>
+static
+void bench(const char *method, u32 width, const DfaSpec &spec,
+           const char *dfas, const std::vector<mcclellan_multi_block> &blocks,
+           ScanFunc &&scan) {
+    size_t bytes = blocks.size() * blocks[0].length;
+    size_t reps = std::max<size_t>(1, TRIAL_BYTES / bytes);
+    double best = 0.0;
+    for (u32 t = 0; t < TRIALS; t++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < reps; i++) {
+            scan(blocks);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, reps * bytes / dt / 1048576.0);
+    }
+    num_matches = 0;
+    scan(blocks);
+    printf("%s,%u,%u,%d,%s,%zu,%zu,%.1f,%.3f\n", method, width, spec.states,
+           (int)spec.accel, dfas, blocks.size(), blocks[0].length, best,
+           num_matches / (bytes / 1024.0));
+}
+
+int main() {
+    printf("method,width,states,accel,dfas,lanes,bytes,mb_per_s,"
+           "matches_per_kb\n");
+
+    ue2::target_t target = ue2::get_current_target();
+    std::mt19937 prng(22);
+
+    u32 max_lanes = lane_counts[ARRAY_LENGTH(lane_counts) - 1];
+    std::vector<std::vector<u8>> bufs;
+    for (size_t size : buf_sizes) {
+        for (u32 i = 0; i < max_lanes; i++) {
+            bufs.emplace_back(size);
+            for (auto &c : bufs.back()) {
+                c = prng();
+            }
+        }
+    }
+
+    for (const auto &spec : dfa_specs) {
+        ue2::Grey grey;
+        grey.accelerateDFA = spec.accel;
+        ue2::CompileContext cc(false, false, target, grey);
+        ue2::ReportManager rm(grey);
+        for (u32 i = 0; i < REPORT_COUNT; i++) {
+            rm.getInternalId(ue2::makeCallback(i, 0));
+            rm.setProgramOffset(i, i);
+        }
+
+        std::vector<ue2::bytecode_ptr<NFA>> nfas;
+        while (nfas.size() < max_lanes) {
+            ue2::raw_dfa raw = makeDfa(spec.states, prng);
+            auto nfa = ue2::mcclellanCompile(raw, cc, rm, false);
+            /* keep all lanes the same width, so that mixed lanes run
+             * together */
+            if (nfa && (nfas.empty() || nfa->type == nfas[0]->type)) {
+                nfas.push_back(std::move(nfa));
+            }
+        }
+        u32 width = nfas[0]->type == MCCLELLAN_NFA_8 ? 8 : 16;
+
+        for (size_t b = 0; b < ARRAY_LENGTH(buf_sizes); b++) {
+            for (u32 lanes : lane_counts) {
+                for (bool shared : {true, false}) {
+                    std::vector<mcclellan_multi_block> blocks;
+                    for (u32 i = 0; i < lanes; i++) {
+                        const auto &nfa = nfas[shared ? 0 : i];
+                        const auto &buf = bufs[b * max_lanes + i];
+                        blocks.push_back({nfa.get(), 0, buf.data(), buf.size(),
+                                          countCallback, nullptr});
+                    }
+                    const char *dfas = shared ? "shared" : "mixed";
+                    bench("single", width, spec, dfas, blocks, scanSingle);
+                    bench("multi", width, spec, dfas, blocks, scanMulti);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief On-disk cache of compiled pattern databases.
+ *
+ * A cache file holds a magic number, the length of the cache key, the key
+ * itself and then the serialized database. The file name is derived from a
+ * hash of the key, but the full key is always compared on load, so a hash
+ * collision simply results in a cache miss.
+ */
+#include "compile_cache.h"
+
+#include "allocator.h"
+#include "crc32.h"
+#include "hs_common.h"
+#include "ue2common.h"
+#include "util/traffic_model.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace ue2 {
+
+static const u32 CACHE_MAGIC = 0x48534443; // "HSDC"
+
+namespace {
+
+struct FileCloser {
+    void operator()(FILE *f) const { fclose(f); }
+};
+
+using file_ptr = unique_ptr<FILE, FileCloser>;
+
+} // namespace
+
+template<typename T>
+static
+void appendValue(string &key, const T &val) {
+    key.append(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+static
+void appendExt(string &key, const hs_expr_ext *ext) {
+    // Only fields selected by ext->flags affect the compile; the others may
+    // hold arbitrary values and must not perturb the key.
+    unsigned long long flags = ext ? ext->flags : 0;
+    appendValue(key, flags);
+    appendValue(key, flags & HS_EXT_FLAG_MIN_OFFSET ? ext->min_offset : 0ULL);
+    appendValue(key, flags & HS_EXT_FLAG_MAX_OFFSET ? ext->max_offset : 0ULL);
+    appendValue(key, flags & HS_EXT_FLAG_MIN_LENGTH ? ext->min_length : 0ULL);
+    appendValue(key, flags & HS_EXT_FLAG_EDIT_DISTANCE ? ext->edit_distance
+                                                       : 0U);
+    appendValue(key, flags & HS_EXT_FLAG_HAMMING_DISTANCE
+                         ? ext->hamming_distance
+                         : 0U);
+}
+
+string makeCompileCacheKey(const char *const *expressions,
+                           const unsigned *flags, const unsigned *ids,
+                           const hs_expr_ext *const *ext, const size_t *lens,
+                           unsigned elements, unsigned mode,
+                           const hs_platform_info &platform,
+                           const TrafficModel *traffic) {
+    if (!expressions || !elements) {
+        return string();
+    }
+
+    string key(hs_version());
+    key.push_back('\0');
+    appendValue(key, mode);
+    appendValue(key, platform.tune);
+    appendValue(key, platform.cpu_features);
+    appendValue(key, platform.reserved1);
+    appendValue(key, platform.reserved2);
+    appendValue(key, traffic ? 1U : 0U);
+    if (traffic) {
+        appendValue(key, traffic->digest());
+    }
+    appendValue(key, lens ? 1U : 0U);
+    appendValue(key, elements);
+
+    for (unsigned i = 0; i < elements; i++) {
+        if (!expressions[i]) {
+            return string();
+        }
+        u64a len = lens ? lens[i] : strlen(expressions[i]);
+        appendValue(key, len);
+        key.append(expressions[i], len);
+        appendValue(key, flags ? flags[i] : 0U);
+        appendValue(key, ids ? ids[i] : 0U);
+        appendExt(key, ext ? ext[i] : nullptr);
+    }
+
+    return key;
+}
+
+string compileCachePath(const char *cache_dir, const string &key) {
+    u32 crc = Crc32c_ComputeBuf(0, key.data(), key.size());
+    char name[32];
+    snprintf(name, sizeof(name), "%08x-%08llx.hsdb", crc,
+             (unsigned long long)key.size());
+
+    string path(cache_dir);
+    if (!path.empty() && path.back() != '/'
+#if defined(_WIN32)
+        && path.back() != '\\'
+#endif
+        ) {
+        path.push_back('/');
+    }
+    return path + name;
+}
+
+hs_database_t *loadCachedDatabase(const string &path, const string &key) {
+    file_ptr f(fopen(path.c_str(), "rb"));
+    if (!f) {
+        return nullptr;
+    }
+
+    u32 magic = 0;
+    u64a keylen = 0;
+    if (fread(&magic, sizeof(magic), 1, f.get()) != 1 ||
+        fread(&keylen, sizeof(keylen), 1, f.get()) != 1 ||
+        magic != CACHE_MAGIC || keylen != key.size()) {
+        DEBUG_PRINTF("cache file %s has bad header\n", path.c_str());
+        return nullptr;
+    }
+
+    vector<char> buf(key.size());
+    if (fread(buf.data(), 1, buf.size(), f.get()) != buf.size() ||
+        memcmp(buf.data(), key.data(), key.size()) != 0) {
+        DEBUG_PRINTF("cache file %s is for a different key\n", path.c_str());
+        return nullptr;
+    }
+
+    buf.clear();
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f.get())) > 0) {
+        buf.insert(buf.end(), chunk, chunk + n);
+    }
+    if (ferror(f.get()) || buf.empty()) {
+        return nullptr;
+    }
+
+    hs_database_t *db = nullptr;
+    if (hs_deserialize_database(buf.data(), buf.size(), &db) != HS_SUCCESS) {
+        DEBUG_PRINTF("cache file %s has a bad database\n", path.c_str());
+        return nullptr;
+    }
+
+    DEBUG_PRINTF("loaded database from %s\n", path.c_str());
+    return db;
+}
+
+void storeCachedDatabase(const string &path, const string &key,
+                         const hs_database_t *db) {
+    char *bytes = nullptr;
+    size_t length = 0;
+    if (hs_serialize_database(db, &bytes, &length) != HS_SUCCESS) {
+        return;
+    }
+
+    // Unique per process and per write, so that concurrent writers, whether
+    // in other processes or on other threads of this one, do not collide.
+    static atomic<u64a> tmp_counter(0);
+    string tmp = path + "." + to_string(getpid()) + "." +
+                 to_string(tmp_counter.fetch_add(1)) + ".tmp";
+
+    bool ok = false;
+    {
+        file_ptr f(fopen(tmp.c_str(), "wb"));
+        if (f) {
+            u32 magic = CACHE_MAGIC;
+            u64a keylen = key.size();
+            ok = fwrite(&magic, sizeof(magic), 1, f.get()) == 1 &&
+                 fwrite(&keylen, sizeof(keylen), 1, f.get()) == 1 &&
+                 fwrite(key.data(), 1, key.size(), f.get()) == key.size() &&
+                 fwrite(bytes, 1, length, f.get()) == length;
+            ok = (fclose(f.release()) == 0) && ok;
+        }
+    }
+    hs_misc_free(bytes);
+
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        DEBUG_PRINTF("failed to write cache file %s\n", path.c_str());
+        remove(tmp.c_str());
+    }
+}
+
+} // namespace ue2
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief On-disk cache of compiled pattern databases.
+ */
+
+#ifndef COMPILER_COMPILE_CACHE_H
+#define COMPILER_COMPILE_CACHE_H
+
+#include "hs_compile.h"
+
+#include <string>
+
+namespace ue2 {
+
+class TrafficModel;
+
+/**
+ * \brief Builds the key identifying a compile in the cache.
+ *
+ * The key covers everything that affects the compiled database: the library
+ * version, the expressions with their flags, ids and extended parameters, the
+ * mode, the target platform and the traffic model, if any. Pure literal
+ * compiles pass their lengths in \p lens, and regular expression compiles
+ * pass nullptr; the two never share a key. Returns an empty key if the
+ * arguments are not valid enough to describe a compile, in which case the
+ * cache is bypassed.
+ */
+std::string makeCompileCacheKey(const char *const *expressions,
+                                const unsigned *flags, const unsigned *ids,
+                                const hs_expr_ext *const *ext,
+                                const size_t *lens,
+                                unsigned elements, unsigned mode,
+                                const hs_platform_info &platform,
+                                const TrafficModel *traffic = nullptr);
+
+/** \brief Returns the path of the cache file for the given key. */
+std::string compileCachePath(const char *cache_dir, const std::string &key);
+
+/**
+ * \brief Loads the database for the given key from a cache file.
+ *
+ * Returns nullptr if the file does not exist, is unreadable, was written for
+ * a different key or holds a database that cannot be deserialized.
+ */
+hs_database_t *loadCachedDatabase(const std::string &path,
+                                  const std::string &key);
+
+/**
+ * \brief Writes a database to a cache file for the given key.
+ *
+ * This is best effort: failures are ignored. The file is written under a
+ * temporary name and renamed into place, so concurrent readers never see a
+ * partially written file.
+ */
+void storeCachedDatabase(const std::string &path, const std::string &key,
+                         const hs_database_t *db);
+
+} // namespace ue2
+
+#endif // COMPILER_COMPILE_CACHE_H
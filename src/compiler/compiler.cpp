@@ -322,6 +322,19 @@ void addExpression(NG &ng, unsigned index, const char *expression,
         return;
     }
 
+    auto pe = parseExpression(cc, index, expression, flags, ext, id);
+    addParsedExpression(ng, *pe);
+}
+
+unique_ptr<ParsedExpression> parseExpression(const CompileContext &cc,
+                                             unsigned index,
+                                             const char *expression,
+                                             unsigned flags,
+                                             const hs_expr_ext *ext,
+                                             ReportID id) {
+    assert(expression);
+    assert(!(flags & HS_FLAG_COMBINATION));
+
     // Ensure that our pattern isn't too long (in characters).
     size_t maxlen = cc.grey.limitPatternLength + 1;
     if (strnlen(expression, maxlen) >= maxlen) {
@@ -330,28 +343,35 @@ void addExpression(NG &ng, unsigned index, const char *expression,
 
     // Do per-expression processing: errors here will result in an exception
     // being thrown up to our caller
-    ParsedExpression pe(index, expression, flags, id, ext);
-    dumpExpression(pe, "orig", cc.grey);
+    auto pe = std::make_unique<ParsedExpression>(index, expression, flags, id,
+                                                 ext);
+    dumpExpression(*pe, "orig", cc.grey);
 
     // Apply prefiltering transformations if desired.
-    if (pe.expr.prefilter) {
-        prefilterTree(pe.component, ParseMode(flags));
-        dumpExpression(pe, "prefiltered", cc.grey);
+    if (pe->expr.prefilter) {
+        prefilterTree(pe->component, ParseMode(flags));
+        dumpExpression(*pe, "prefiltered", cc.grey);
     }
 
     // Expressions containing zero-width assertions and other extended pcre
     // types aren't supported yet. This call will throw a ParseError exception
     // if the component tree contains such a construct.
-    checkUnsupported(*pe.component);
+    checkUnsupported(*pe->component);
 
-    pe.component->checkEmbeddedStartAnchor(true);
-    pe.component->checkEmbeddedEndAnchor(true);
+    pe->component->checkEmbeddedStartAnchor(true);
+    pe->component->checkEmbeddedEndAnchor(true);
 
     if (cc.grey.optimiseComponentTree) {
-        optimise(pe);
-        dumpExpression(pe, "opt", cc.grey);
+        optimise(*pe);
+        dumpExpression(*pe, "opt", cc.grey);
     }
 
+    return pe;
+}
+
+void addParsedExpression(NG &ng, ParsedExpression &pe) {
+    const CompileContext &cc = ng.cc;
+
     DEBUG_PRINTF("component=%p, nfaId=%u, reportId=%u\n",
                  pe.component.get(), pe.expr.index, pe.expr.report);
 
@@ -438,7 +458,9 @@ static
 bytecode_ptr<RoseEngine> generateRoseEngine(NG &ng) {
     const u32 minWidth =
         ng.minWidth.is_finite() ? verify_u32(ng.minWidth) : ROSE_BOUND_INF;
-    auto rose = ng.rose->buildRose(minWidth);
+    const u32 maxWidth =
+        ng.maxWidth.is_finite() ? verify_u32(ng.maxWidth) : ROSE_BOUND_INF;
+    auto rose = ng.rose->buildRose(minWidth, maxWidth);
 
     if (!rose) {
         DEBUG_PRINTF("error building rose\n");
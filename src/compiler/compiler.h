@@ -116,6 +116,44 @@ struct BuiltExpression {
 void addExpression(NG &ng, unsigned index, const char *expression,
                    unsigned flags, const hs_expr_ext *ext, ReportID report);
 
+/**
+ * Parse an expression and apply the transformations that depend only on the
+ * expression itself (prefiltering, component tree optimisation). This does
+ * not touch the global NG object, so expressions may be parsed concurrently.
+ *
+ * Logical combinations (@ref HS_FLAG_COMBINATION) are not handled here; they
+ * must be passed to @ref addExpression.
+ *
+ * @param cc
+ *      Global compile context for this compile.
+ * @param index
+ *      The index of the expression (used for errors)
+ * @param expression
+ *      NULL-terminated PCRE expression
+ * @param flags
+ *      The full set of Hyperscan flags associated with this rule.
+ * @param ext
+ *      Struct containing extra parameters for this expression, or NULL if
+ *      none.
+ * @param report
+ *      The identifier to associate with the expression; returned by engine on
+ *      match.
+ */
+std::unique_ptr<ParsedExpression>
+parseExpression(const CompileContext &cc, unsigned index,
+                const char *expression, unsigned flags,
+                const hs_expr_ext *ext, ReportID report);
+
+/**
+ * Add an expression prepared by @ref parseExpression to the compiler.
+ *
+ * @param ng
+ *      The global NG object.
+ * @param pe
+ *      The parsed expression.
+ */
+void addParsedExpression(NG &ng, ParsedExpression &pe);
+
 void addLitExpression(NG &ng, unsigned index, const char *expression,
                       unsigned flags, const hs_expr_ext *ext, ReportID id,
                       size_t expLength);
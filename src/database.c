@@ -289,6 +289,118 @@ hs_error_t HS_CDECL hs_deserialize_database(const char *bytes,
     return HS_SUCCESS;
 }
 
+/** \brief Alignment of the bytecode in a database image, relative to the
+ * start of the image. Images must be loaded at an address with at least this
+ * alignment. */
+#define DB_IMAGE_ALIGN 64
+
+/** \brief Offset of the bytecode in a database image. */
+static really_inline
+u32 db_image_bytecode_offset(void) {
+    // As db_copy_bytecode does for a database at an aligned address: this
+    // keeps the bytecode within the sizeof(hs_database) + length footprint.
+    return offsetof(struct hs_database, bytes) & ~(DB_IMAGE_ALIGN - 1);
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_serialize_database_image(const hs_database_t *db,
+                                                char **bytes,
+                                                size_t *length) {
+    if (!db || !bytes || !length) {
+        return HS_INVALID;
+    }
+
+    if (!db_correctly_aligned(db)) {
+        return HS_BAD_ALIGN;
+    }
+
+    hs_error_t ret = validDatabase(db);
+    if (ret != HS_SUCCESS) {
+        return ret;
+    }
+
+    size_t image_len = sizeof(struct hs_database) + db->length;
+
+    char *out = hs_misc_alloc(image_len);
+    ret = hs_check_alloc(out);
+    if (ret != HS_SUCCESS) {
+        hs_misc_free(out);
+        return ret;
+    }
+
+    memset(out, 0, image_len);
+
+    // The image is a database laid out as it would be at an address aligned
+    // to DB_IMAGE_ALIGN, so that it can be used in place.
+    struct hs_database header;
+    memset(&header, 0, sizeof(header));
+    header.magic = db->magic;
+    header.version = db->version;
+    header.length = db->length;
+    header.platform = db->platform;
+    header.crc32 = db->crc32;
+    header.reserved0 = db->reserved0;
+    header.reserved1 = db->reserved1;
+    header.bytecode = db_image_bytecode_offset();
+
+    memcpy(out, &header, offsetof(struct hs_database, padding));
+    memcpy(out + header.bytecode, hs_get_bytecode(db), db->length);
+
+    *bytes = out;
+    *length = image_len;
+    return HS_SUCCESS;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_deserialize_database_in_place(const char *bytes,
+                                                     const size_t length,
+                                                     const hs_database_t **db) {
+    if (!bytes || !db) {
+        return HS_INVALID;
+    }
+
+    *db = NULL;
+
+    if (!ISALIGNED_N(bytes, DB_IMAGE_ALIGN)) {
+        return HS_BAD_ALIGN;
+    }
+
+    if (length < sizeof(struct hs_database)) {
+        return HS_INVALID;
+    }
+
+    const struct hs_database *image = (const struct hs_database *)bytes;
+
+    hs_error_t ret = validDatabase(image);
+    if (ret != HS_SUCCESS) {
+        return ret;
+    }
+
+    if (length != sizeof(struct hs_database) + image->length) {
+        DEBUG_PRINTF("bad length %zu, expecting %zu\n", length,
+                     sizeof(struct hs_database) + image->length);
+        return HS_INVALID;
+    }
+
+    if (image->bytecode != db_image_bytecode_offset()) {
+        DEBUG_PRINTF("bad bytecode offset %u\n", image->bytecode);
+        return HS_INVALID;
+    }
+
+    ret = db_check_platform(image->platform);
+    if (ret != HS_SUCCESS) {
+        return ret;
+    }
+
+    ret = db_check_crc(image);
+    if (ret != HS_SUCCESS) {
+        return ret;
+    }
+
+    *db = image;
+    return HS_SUCCESS;
+}
+
 HS_PUBLIC_API
 hs_error_t HS_CDECL hs_database_size(const hs_database_t *db, size_t *size) {
     if (!size) {
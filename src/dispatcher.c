@@ -126,6 +126,23 @@ CREATE_DISPATCH(hs_error_t, hs_scan, const hs_database_t *db, const char *data,
                 unsigned length, unsigned flags, hs_scratch_t *scratch,
                 match_event_handler onEvent, void *userCtx);
 
+CREATE_DISPATCH(hs_error_t, hs_scan_matches, const hs_database_t *db,
+                const char *data, unsigned int length, unsigned int flags,
+                hs_scratch_t *scratch, hs_match_t *matches,
+                unsigned int capacity, unsigned int *count,
+                unsigned long long *total);
+
+CREATE_DISPATCH(hs_error_t, hs_scan_count, const hs_database_t *db,
+                const char *data, unsigned int length, unsigned int flags,
+                hs_scratch_t *scratch, unsigned long long *counts,
+                unsigned int capacity);
+
+CREATE_DISPATCH(hs_error_t, hs_scan_parallel, const hs_database_t *db,
+                const char *data, unsigned int length, unsigned int flags,
+                hs_scratch_t *const *scratch, unsigned int count,
+                hs_executor_t executor, void *executor_context,
+                match_event_handler onEvent, void *context);
+
 CREATE_DISPATCH(hs_error_t, hs_stream_size, const hs_database_t *database,
                 size_t *stream_size);
 
@@ -141,6 +158,11 @@ CREATE_DISPATCH(hs_error_t, hs_scan_stream, hs_stream_t *id, const char *data,
                 unsigned int length, unsigned int flags, hs_scratch_t *scratch,
                 match_event_handler onEvent, void *ctxt);
 
+CREATE_DISPATCH(hs_error_t, hs_scan_stream_batch, hs_stream_t *const *ids,
+                const char *const *data, const unsigned int *length,
+                unsigned int count, unsigned int flags, hs_scratch_t *scratch,
+                match_batch_event_handler onEvent, void *ctxt);
+
 CREATE_DISPATCH(hs_error_t, hs_close_stream, hs_stream_t *id,
                 hs_scratch_t *scratch, match_event_handler onEvent, void *ctxt);
 
@@ -171,6 +193,13 @@ CREATE_DISPATCH(hs_error_t, hs_deserialize_database, const char *bytes,
 CREATE_DISPATCH(hs_error_t, hs_deserialize_database_at, const char *bytes,
                 const size_t length, hs_database_t *db);
 
+CREATE_DISPATCH(hs_error_t, hs_serialize_database_image,
+                const hs_database_t *db, char **bytes, size_t *length);
+
+CREATE_DISPATCH(hs_error_t, hs_deserialize_database_in_place,
+                const char *bytes, const size_t length,
+                const hs_database_t **db);
+
 CREATE_DISPATCH(hs_error_t, hs_serialized_database_info, const char *bytes,
                 size_t length, char **info);
 
@@ -769,6 +769,12 @@ hwlm_error_t fdr_engine_exec(const struct FDR *fdr,
 #define ONLY_AVX2(func) NULL
 #endif
 
+#if defined(HAVE_AVX512)
+#define ONLY_WIDE_TEDDY(func) func
+#else
+#define ONLY_WIDE_TEDDY(func) NULL
+#endif
+
 typedef hwlm_error_t (*FDRFUNCTYPE)(const struct FDR *fdr,
                                     const struct FDR_Runtime_Args *a,
                                     hwlm_group_t control);
@@ -793,6 +799,14 @@ static const FDRFUNCTYPE funcs[] = {
     fdr_exec_teddy_msks3_pck,
     fdr_exec_teddy_msks4,
     fdr_exec_teddy_msks4_pck,
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks1),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks1_pck),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks2),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks2_pck),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks3),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks3_pck),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks4),
+    ONLY_WIDE_TEDDY(fdr_exec_wide_teddy_msks4_pck),
 };
 
 #define FAKE_HISTORY_SIZE 16
@@ -47,6 +47,7 @@
 #include "util/math.h"
 #include "util/noncopyable.h"
 #include "util/target_info.h"
+#include "util/traffic_model.h"
 #include "util/ue2string.h"
 #include "util/verify_types.h"
 
@@ -311,9 +312,25 @@ struct Chunk {
     u32 length;   //!< how long things in the chunk are
 };
 
+/**
+ * \brief Weight of modelled traffic hits against the structural score used
+ * for bucket assignment.
+ *
+ * With this weight, a literal whose tail appears once per thousand bytes of
+ * traffic costs about as much as a one-byte literal on random data.
+ */
+static constexpr double TRAFFIC_WEIGHT = 1000.0;
+
+/**
+ * \brief Splits the sorted literals into chunks, the units of bucket
+ * assignment. If \a hot is not empty, literals marked in it are given chunks
+ * of their own (along with any identical literals) so that they can be placed
+ * in a bucket away from the others.
+ */
 static
 vector<Chunk> assignChunks(const vector<hwlmLiteral> &lits,
-                           const map<u32, u32> &lenCounts) {
+                           const map<u32, u32> &lenCounts,
+                           const vector<bool> &hot) {
     const u32 CHUNK_MAX = 512;
     const u32 MAX_CONSIDERED_LENGTH = 16;
 
@@ -349,7 +366,8 @@ vector<Chunk> assignChunks(const vector<hwlmLiteral> &lits,
 
         if ((currentSize < MAX_CONSIDERED_LENGTH &&
              (lit.s.size() != currentSize)) ||
-            (currentSize != 1 && ((i - chunkStartID) >= maxPerChunk))) {
+            (currentSize != 1 && ((i - chunkStartID) >= maxPerChunk)) ||
+            (!hot.empty() && i != 0 && (hot[i] || hot[i - 1]))) {
             currentSize = lit.s.size();
             if (!chunks.empty()) {
                 chunks.back().count = i - chunkStartID;
@@ -381,10 +399,18 @@ next_literal:
     return chunks;
 }
 
+/**
+ * \brief Assigns the literals to buckets, sorting \a lits in the process.
+ *
+ * Buckets are built from runs of literals of similar length, chosen to
+ * minimise the expected confirm work on random data and, if \a traffic is
+ * given, on the modelled traffic as well.
+ */
 static
 map<BucketIndex, vector<LiteralIndex>> assignStringsToBuckets(
                                     vector<hwlmLiteral> &lits,
-                                    const FDREngineDescription &eng) {
+                                    const FDREngineDescription &eng,
+                                    const TrafficModel *traffic) {
     const double MAX_SCORE = numeric_limits<double>::max();
 
     assert(!lits.empty()); // Shouldn't be called with no literals.
@@ -417,7 +443,35 @@ map<BucketIndex, vector<LiteralIndex>> assignStringsToBuckets(
                     return a.nocase > b.nocase;
                 });
 
-    vector<Chunk> chunks = assignChunks(lits, lenCounts);
+    Scorer scorer;
+
+    // With a traffic model, each literal's modelled hit rate is added to the
+    // score of its bucket, scaled like confirm work. hitSums holds prefix
+    // sums over the sorted literals, and hot literals get their own chunks.
+    vector<double> hitSums;
+    vector<bool> hot;
+    if (traffic) {
+        hitSums.reserve(lits.size() + 1);
+        hitSums.emplace_back(0.0);
+        hot.reserve(lits.size());
+        for (const auto &lit : lits) {
+            double p = literalTrafficProb(lit, *traffic);
+            hitSums.emplace_back(hitSums.back() + p);
+            hot.emplace_back(TRAFFIC_WEIGHT * p * 3 >
+                             scorer(min(lit.s.size(), (size_t)8), 1));
+        }
+    }
+
+    auto score_range = [&](const Chunk &first, const Chunk &end, u32 cnt) {
+        double score = scorer(first.length, cnt);
+        if (traffic) {
+            double hits = hitSums[end.first_id] - hitSums[first.first_id];
+            score += TRAFFIC_WEIGHT * hits * (2 + cnt);
+        }
+        return score;
+    };
+
+    vector<Chunk> chunks = assignChunks(lits, lenCounts, hot);
 
     const u32 numChunks = chunks.size();
     const u32 numBuckets = eng.getNumBuckets();
@@ -427,14 +481,12 @@ map<BucketIndex, vector<LiteralIndex>> assignStringsToBuckets(
     boost::multi_array<pair<double, u32>, 2> t(
         boost::extents[numChunks][numBuckets]);
 
-    Scorer scorer;
-
     for (u32 j = 0; j < numChunks; j++) {
         u32 cnt = 0;
         for (u32 k = j; k < numChunks; ++k) {
             cnt += chunks[k].count;
         }
-        t[j][0] = {scorer(chunks[j].length, cnt), 0};
+        t[j][0] = {score_range(chunks[j], chunks[numChunks - 1], cnt), 0};
     }
 
     for (u32 i = 1; i < numBuckets; i++) {
@@ -442,7 +494,7 @@ map<BucketIndex, vector<LiteralIndex>> assignStringsToBuckets(
             pair<double, u32> best = {MAX_SCORE, 0};
             u32 cnt = chunks[j].count;
             for (u32 k = j + 1; k < numChunks - 1; k++) {
-                auto score = scorer(chunks[j].length, cnt);
+                auto score = score_range(chunks[j], chunks[k], cnt);
                 if (score > best.first) {
                     break; // now worse locally than our best score, give up
                 }
@@ -635,6 +687,135 @@ bytecode_ptr<FDR> FDRCompiler::build() {
     return setupFDR();
 }
 
+/**
+ * \brief Probability under the traffic model that the table entry looked up
+ * at a given offset keeps the state bit for suffix position \a pos of a bucket
+ * alive. \a dist is the traffic's distribution over table indices.
+ */
+static
+double positionAcceptProb(const FDREngineDescription &eng,
+                          const vector<LiteralIndex> &vl,
+                          const vector<hwlmLiteral> &lits,
+                          SuffixPositionInString pos,
+                          const vector<double> &dist) {
+    map<u32, unordered_set<u32>> m2;
+    if (getMultiEntriesAtPosition(eng, vl, lits, pos, m2)) {
+        return 1.0;
+    }
+
+    // Walk the accepted table indices as setupTab() does, counting each once.
+    vector<bool> seen(eng.getNumTableEntries());
+    double p = 0;
+    for (const auto &elem : m2) {
+        u32 dc = elem.first;
+        u32 v = ~dc;
+        do {
+            u32 b2 = v & dc;
+            for (const u32 &mskVal : elem.second) {
+                u32 val = (mskVal & ~dc) | b2;
+                if (!seen[val]) {
+                    seen[val] = true;
+                    p += dist[val];
+                }
+            }
+            v = (v + (dc & -dc)) | ~dc;
+        } while (v != ~dc);
+    }
+    return min(p, 1.0);
+}
+
+/**
+ * \brief Picks the domain bits and stride for an FDR engine with the given
+ * bucket assignment that minimise the modelled cost of scanning the traffic,
+ * and returns that cost in cycles per byte.
+ *
+ * The model charges each table lookup more as the table outgrows the L1
+ * cache, and each bucket its confirm cost times the probability that it
+ * fires. A bucket fires when every position checked survives, which at
+ * stride s is only the positions in one residue class mod s; it always fires
+ * at least as often as its literals actually occur.
+ */
+static
+double tuneEngineForTraffic(
+        FDREngineDescription &eng, const vector<hwlmLiteral> &lits,
+        const map<BucketIndex, vector<LiteralIndex>> &bucketToLits,
+        bool make_small, const TrafficModel &traffic) {
+    const u32 LOOKUP_BYTES = 8;
+    size_t count;
+    size_t msl = minLenCount(lits, &count);
+
+    vector<double> hitProbs;
+    for (const auto &m : bucketToLits) {
+        double p = 0;
+        for (const auto &id : m.second) {
+            p += literalTrafficProb(lits[id], traffic);
+        }
+        hitProbs.emplace_back(p);
+    }
+
+    double best_cost = numeric_limits<double>::max();
+    u32 best_bits = eng.bits;
+    u32 best_stride = eng.stride;
+
+    for (u32 domain = 9; domain <= 15; domain++) {
+        // Keep tables for small builds within 16KB.
+        if (make_small && domain > 11) {
+            break;
+        }
+
+        FDREngineDescription cand(eng);
+        cand.bits = domain;
+        vector<double> dist = traffic.domainDist(domain);
+
+        // Survival probability of each (bucket, position) state bit.
+        vector<array<double, LOOKUP_BYTES>> accept;
+        for (const auto &m : bucketToLits) {
+            array<double, LOOKUP_BYTES> a;
+            for (u32 pos = 0; pos < LOOKUP_BYTES; pos++) {
+                a[pos] = positionAcceptProb(cand, m.second, lits, pos, dist);
+            }
+            accept.emplace_back(a);
+        }
+
+        for (u32 stride = 1; stride <= 4; stride *= 2) {
+            // As in chooseEngine(): large domains are only used at stride 1.
+            if ((domain > 13 && stride > 1) || msl < stride) {
+                continue;
+            }
+
+            double lookup = 0.75 + 0.25 * (domain > 12 ? domain - 12 : 0);
+            double cost = lookup / stride + 0.25;
+
+            u32 i = 0;
+            for (const auto &m : bucketToLits) {
+                double fire = 0;
+                for (u32 r = 0; r < stride; r++) {
+                    double p = 1.0;
+                    for (u32 pos = r; pos < LOOKUP_BYTES; pos += stride) {
+                        p *= accept[i][pos];
+                    }
+                    fire += p / stride;
+                }
+                fire = max(fire, hitProbs[i]);
+                cost += TRAFFIC_CONFIRM_COST * fire * (2 + m.second.size());
+                i++;
+            }
+
+            DEBUG_PRINTF("domain=%u, stride=%u -> cost=%f\n", domain, stride,
+                         cost);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_bits = domain;
+                best_stride = stride;
+            }
+        }
+    }
+
+    eng.bits = best_bits;
+    eng.stride = best_stride;
+    return best_cost;
+}
+
 static
 bool isSuffix(const hwlmLiteral &lit1, const hwlmLiteral &lit2) {
     const auto &s1 = lit1.s;
@@ -833,14 +1014,63 @@ void addIncludedInfo(
 
 } // namespace
 
+/**
+ * \brief Builds both Teddy and FDR prototypes tuned for the traffic model and
+ * returns the one with the lower modelled scanning cost.
+ */
+static
+unique_ptr<HWLMProto> fdrBuildProtoForTraffic(u8 engType,
+                                              const vector<hwlmLiteral> &lits,
+                                              bool make_small,
+                                              const target_t &target,
+                                              const Grey &grey,
+                                              const TrafficModel &traffic) {
+    unique_ptr<HWLMProto> best;
+    double best_cost = numeric_limits<double>::max();
+
+    if (grey.fdrAllowTeddy) {
+        best = teddyBuildProtoHinted(engType, lits, make_small, HINT_INVALID,
+                                     target, &traffic);
+        if (best) {
+            best_cost = teddyTrafficCost(*best, traffic);
+            DEBUG_PRINTF("teddy cost %f\n", best_cost);
+        }
+    }
+
+    auto des = chooseEngine(target, lits, make_small);
+    if (!des) {
+        return best;
+    }
+
+    vector<hwlmLiteral> fdr_lits = lits;
+    auto bucketToLits = assignStringsToBuckets(fdr_lits, *des, &traffic);
+    double cost = tuneEngineForTraffic(*des, fdr_lits, bucketToLits,
+                                       make_small, traffic);
+    DEBUG_PRINTF("fdr cost %f (bits=%u, stride=%u)\n", cost, des->bits,
+                 des->stride);
+    if (cost >= best_cost) {
+        return best;
+    }
+
+    addIncludedInfo(fdr_lits, des->getNumBuckets(), bucketToLits);
+    return std::make_unique<HWLMProto>(engType, std::move(des), fdr_lits,
+                                       bucketToLits, make_small);
+}
+
 static
 unique_ptr<HWLMProto> fdrBuildProtoInternal(u8 engType,
                                             vector<hwlmLiteral> &lits,
                                             bool make_small,
                                             const target_t &target,
-                                            const Grey &grey, u32 hint) {
+                                            const Grey &grey, u32 hint,
+                                            const TrafficModel *traffic) {
     DEBUG_PRINTF("cpu has %s\n", target.has_avx2() ? "avx2" : "no-avx2");
 
+    if (traffic && hint == HINT_INVALID) {
+        return fdrBuildProtoForTraffic(engType, lits, make_small, target,
+                                       grey, *traffic);
+    }
+
     if (grey.fdrAllowTeddy) {
         auto proto = teddyBuildProtoHinted(engType, lits, make_small, hint,
                                            target);
@@ -864,7 +1094,7 @@ unique_ptr<HWLMProto> fdrBuildProtoInternal(u8 engType,
         des->stride = 1;
     }
 
-    auto bucketToLits = assignStringsToBuckets(lits, *des);
+    auto bucketToLits = assignStringsToBuckets(lits, *des, nullptr);
     addIncludedInfo(lits, des->getNumBuckets(), bucketToLits);
     auto proto =
         std::make_unique<HWLMProto>(engType, std::move(des), lits, bucketToLits,
@@ -874,9 +1104,10 @@ unique_ptr<HWLMProto> fdrBuildProtoInternal(u8 engType,
 
 unique_ptr<HWLMProto> fdrBuildProto(u8 engType, vector<hwlmLiteral> lits,
                                     bool make_small, const target_t &target,
-                                    const Grey &grey) {
+                                    const Grey &grey,
+                                    const TrafficModel *traffic) {
     return fdrBuildProtoInternal(engType, lits, make_small, target, grey,
-                                 HINT_INVALID);
+                                 HINT_INVALID, traffic);
 }
 
 static
@@ -904,7 +1135,7 @@ unique_ptr<HWLMProto> fdrBuildProtoHinted(u8 engType,
                                           const target_t &target,
                                           const Grey &grey) {
     return fdrBuildProtoInternal(engType, lits, make_small, target, grey,
-                                 hint);
+                                 hint, nullptr);
 }
 
 #endif
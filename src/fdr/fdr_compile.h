@@ -43,6 +43,7 @@ struct FDR;
 
 namespace ue2 {
 
+class TrafficModel;
 struct hwlmLiteral;
 struct Grey;
 struct target_t;
@@ -58,11 +59,19 @@ std::unique_ptr<HWLMProto> fdrBuildProtoHinted(
                                           const Grey &grey);
 #endif
 
+/**
+ * \brief Builds a literal matcher prototype, using Teddy if it is suitable and
+ * FDR otherwise.
+ *
+ * If \a traffic is given, both are considered and tuned to minimise the
+ * modelled cost of scanning that traffic.
+ */
 std::unique_ptr<HWLMProto> fdrBuildProto(
                                      u8 engType,
                                      std::vector<hwlmLiteral> lits,
                                      bool make_small, const target_t &target,
-                                     const Grey &grey);
+                                     const Grey &grey,
+                                     const TrafficModel *traffic = nullptr);
 
 /** \brief Returns size in bytes of the given FDR engine. */
 size_t fdrSize(const struct FDR *fdr);
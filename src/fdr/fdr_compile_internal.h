@@ -54,6 +54,7 @@ typedef u32 PositionInBucket;  // zero is 'we are matching right now!",
 
 class EngineDescription;
 class FDREngineDescription;
+class TrafficModel;
 struct hwlmStreamingControl;
 struct Grey;
 
@@ -82,6 +83,20 @@ size_t maxLen(const std::vector<hwlmLiteral> &lits);
 size_t minLenCount(const std::vector<hwlmLiteral> &lits, size_t *count);
 u32 absdiff(u32 i, u32 j);
 
+/**
+ * \brief Modelled cost, in cycles, of one confirm attempt per literal in a
+ * bucket (plus two for the attempt itself), used when tuning a literal matcher
+ * for a traffic model.
+ */
+static constexpr double TRAFFIC_CONFIRM_COST = 4.0;
+
+/**
+ * \brief Probability under the traffic model that the tail of the literal
+ * seen by the first stage of FDR or Teddy occurs at a given offset; a lower
+ * bound on how often its bucket fires.
+ */
+double literalTrafficProb(const hwlmLiteral &lit, const TrafficModel &traffic);
+
 } // namespace ue2
 
 #endif
@@ -28,6 +28,7 @@
 
 #include "fdr_compile_internal.h"
 #include "hwlm/hwlm_literal.h"
+#include "util/traffic_model.h"
 
 #include <algorithm>
 #include <vector>
@@ -62,4 +63,11 @@ u32 absdiff(u32 i, u32 j) {
     return (i > j) ? (i - j) : (j - i);
 }
 
+double literalTrafficProb(const hwlmLiteral &lit,
+                          const TrafficModel &traffic) {
+    // Neither FDR nor Teddy look at more than the last eight bytes.
+    const size_t len = min(lit.s.size(), (size_t)8);
+    return traffic.stringProb(lit.s.substr(lit.s.size() - len), lit.nocase);
+}
+
 } // namespace ue2
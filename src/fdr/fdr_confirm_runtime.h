@@ -46,6 +46,7 @@ void confWithBit(const struct FDRConfirm *fdrc, const struct FDR_Runtime_Args *a
     assert(i < a->len);
     assert(i >= a->start_offset);
     assert(ISALIGNED(fdrc));
+    SCAN_STAT_ADD(literal_confirms, 1);
 
     const u8 * buf = a->buf;
     u32 c = CONF_HASH_CALL(conf_key, fdrc->andmsk, fdrc->mult,
@@ -66,6 +67,9 @@ void confWithBit(const struct FDRConfirm *fdrc, const struct FDR_Runtime_Args *a
     do {
         assert(ISALIGNED(li));
 
+        // literal ids are the offsets of their Rose programs
+        SCAN_PROFILE_PROGRAM_BEGIN(scratch->core_info.rose, li->id);
+
         if (unlikely((conf_key & li->msk) != li->v)) {
             goto out;
         }
@@ -95,6 +99,7 @@ void confWithBit(const struct FDRConfirm *fdrc, const struct FDR_Runtime_Args *a
         *last_match = li->id;
         *control = a->cb(i, li->id, scratch);
     out:
+        SCAN_PROFILE_END();
         oldNext = li->next; // oldNext is either 0 or an 'adjust' value
         li++;
     } while (oldNext);
@@ -172,8 +172,7 @@ void dumpTeddy(const Teddy *teddy, FILE *f) {
     const u8 *rdmsk = baseMsk + ROUNDUP_CL(maskLen);
     if (maskWidth == 1) { // reinforcement table in Teddy
         dumpTeddyReinforced(rdmsk, maskWidth, f);
-    } else { // dup nibble mask table in Fat Teddy
-        assert(maskWidth == 2);
+    } else if (maskWidth == 2) { // dup nibble mask table in Fat Teddy
         dumpTeddyDupMasks(rdmsk, des->numMasks, f);
     }
     dumpConfirms(teddy, teddy->confOffset, des->getNumBuckets(), f);
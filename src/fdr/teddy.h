@@ -107,4 +107,39 @@ hwlm_error_t fdr_exec_fat_teddy_msks4_pck(const struct FDR *fdr,
 
 #endif /* HAVE_AVX2 */
 
+#if defined(HAVE_AVX512)
+hwlm_error_t fdr_exec_wide_teddy_msks1(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks1_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks2(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks2_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks3(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks3_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks4(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control);
+
+hwlm_error_t fdr_exec_wide_teddy_msks4_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control);
+
+#endif /* HAVE_AVX512 */
+
 #endif /* TEDDY_H_ */
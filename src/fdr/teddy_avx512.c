@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Teddy literal matcher: AVX-512 wide (32 bucket) engine runtime.
+ *
+ * Wide Teddy extends fat Teddy from two to four 128-bit lanes: each 16-byte
+ * block of input is broadcast to all four lanes, and lane w looks up the
+ * nibble masks for buckets 8w to 8w+7.
+ */
+
+#include "fdr_internal.h"
+#include "flood_runtime.h"
+#include "teddy.h"
+#include "teddy_internal.h"
+#include "teddy_runtime_common.h"
+#include "util/arch.h"
+#include "util/simd_utils.h"
+
+#if defined(HAVE_AVX512)
+
+#define CONF_WIDE_CHUNK(chunk, bucket, off, reason, conf_fn)                \
+do {                                                                        \
+    if (unlikely(chunk != (TEDDY_CONF_TYPE)~0ULL)) {                        \
+        chunk = ~chunk;                                                     \
+        conf_fn(&chunk, bucket, off, confBase, reason, a, ptr,              \
+                &control, &last_match);                                     \
+        CHECK_HWLM_TERMINATE_MATCHING;                                      \
+    }                                                                       \
+} while(0)
+
+/*
+ * The lookup leaves the result for bucket group w, position p in byte p of
+ * lane w. The confirm wants each position's 32 bucket bits together, so we
+ * transpose: a 4x4 dword transpose across lanes, then a 4x4 byte transpose
+ * within each lane. Both use the same index pattern.
+ */
+static const u32 ALIGN_CL_DIRECTIVE wide_teddy_dword_perm[16] = {
+    0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+};
+
+static const u8 ALIGN_CL_DIRECTIVE wide_teddy_byte_perm[64] = {
+    0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+    0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+    0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+    0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+};
+
+#define CONFIRM_WIDE_TEDDY(var, offset, reason, conf_fn)                    \
+do {                                                                        \
+    if (unlikely(diff512(var, ones512()))) {                                \
+        union {                                                             \
+            m512 v;                                                         \
+            TEDDY_CONF_TYPE c[sizeof(m512) / sizeof(TEDDY_CONF_TYPE)];      \
+        } u;                                                                \
+        u.v = pshufb_m512(vpermd512(load512(wide_teddy_dword_perm), var),   \
+                          load512(wide_teddy_byte_perm));                   \
+        const u32 positions = sizeof(TEDDY_CONF_TYPE) / sizeof(u32);        \
+        for (u32 i = 0; i < ARRAY_LENGTH(u.c); i++) {                       \
+            CONF_WIDE_CHUNK(u.c[i], 32, offset + i * positions, reason,     \
+                            conf_fn);                                       \
+        }                                                                   \
+    }                                                                       \
+} while(0)
+
+static really_inline
+const m512 *getMaskBase_wide(const struct Teddy *teddy) {
+    return (const m512 *)((const u8 *)teddy + ROUNDUP_CL(sizeof(struct Teddy)));
+}
+
+static really_inline
+m512 vectoredLoad4x128(m512 *p_mask, const u8 *ptr, const size_t start_offset,
+                       const u8 *lo, const u8 *hi,
+                       const u8 *buf_history, size_t len_history,
+                       const u32 nMasks) {
+    m128 p_mask128;
+    m512 ret = set1_4x128(vectoredLoad128(&p_mask128, ptr, start_offset, lo,
+                                          hi, buf_history, len_history,
+                                          nMasks));
+    *p_mask = set1_4x128(p_mask128);
+    return ret;
+}
+
+static really_inline
+m512 prep_conf_wide_teddy_m1(const m512 *maskBase, m512 val) {
+    m512 mask = set1_64x8(0xf);
+    m512 lo = and512(val, mask);
+    m512 hi = and512(rshift64_m512(val, 4), mask);
+    return or512(pshufb_m512(maskBase[0 * 2], lo),
+                 pshufb_m512(maskBase[0 * 2 + 1], hi));
+}
+
+static really_inline
+m512 prep_conf_wide_teddy_m2(const m512 *maskBase, m512 *old_1, m512 val) {
+    m512 mask = set1_64x8(0xf);
+    m512 lo = and512(val, mask);
+    m512 hi = and512(rshift64_m512(val, 4), mask);
+    m512 r = prep_conf_wide_teddy_m1(maskBase, val);
+
+    m512 res_1 = or512(pshufb_m512(maskBase[1 * 2], lo),
+                       pshufb_m512(maskBase[1 * 2 + 1], hi));
+    m512 res_shifted_1 = vpalignr512(res_1, *old_1, 16 - 1);
+    *old_1 = res_1;
+    return or512(r, res_shifted_1);
+}
+
+static really_inline
+m512 prep_conf_wide_teddy_m3(const m512 *maskBase, m512 *old_1, m512 *old_2,
+                             m512 val) {
+    m512 mask = set1_64x8(0xf);
+    m512 lo = and512(val, mask);
+    m512 hi = and512(rshift64_m512(val, 4), mask);
+    m512 r = prep_conf_wide_teddy_m2(maskBase, old_1, val);
+
+    m512 res_2 = or512(pshufb_m512(maskBase[2 * 2], lo),
+                       pshufb_m512(maskBase[2 * 2 + 1], hi));
+    m512 res_shifted_2 = vpalignr512(res_2, *old_2, 16 - 2);
+    *old_2 = res_2;
+    return or512(r, res_shifted_2);
+}
+
+static really_inline
+m512 prep_conf_wide_teddy_m4(const m512 *maskBase, m512 *old_1, m512 *old_2,
+                             m512 *old_3, m512 val) {
+    m512 mask = set1_64x8(0xf);
+    m512 lo = and512(val, mask);
+    m512 hi = and512(rshift64_m512(val, 4), mask);
+    m512 r = prep_conf_wide_teddy_m3(maskBase, old_1, old_2, val);
+
+    m512 res_3 = or512(pshufb_m512(maskBase[3 * 2], lo),
+                       pshufb_m512(maskBase[3 * 2 + 1], hi));
+    m512 res_shifted_3 = vpalignr512(res_3, *old_3, 16 - 3);
+    *old_3 = res_3;
+    return or512(r, res_shifted_3);
+}
+
+#define FDR_EXEC_WIDE_TEDDY_RES_OLD_1                                       \
+do {                                                                        \
+} while(0)
+
+#define FDR_EXEC_WIDE_TEDDY_RES_OLD_2                                       \
+    m512 res_old_1 = zeroes512();
+
+#define FDR_EXEC_WIDE_TEDDY_RES_OLD_3                                       \
+    m512 res_old_1 = zeroes512();                                           \
+    m512 res_old_2 = zeroes512();
+
+#define FDR_EXEC_WIDE_TEDDY_RES_OLD_4                                       \
+    m512 res_old_1 = zeroes512();                                           \
+    m512 res_old_2 = zeroes512();                                           \
+    m512 res_old_3 = zeroes512();
+
+#define FDR_EXEC_WIDE_TEDDY_RES_OLD(n) FDR_EXEC_WIDE_TEDDY_RES_OLD_##n
+
+#define PREP_CONF_WIDE_FN_1(mask_base, val)                                 \
+    prep_conf_wide_teddy_m1(mask_base, val)
+
+#define PREP_CONF_WIDE_FN_2(mask_base, val)                                 \
+    prep_conf_wide_teddy_m2(mask_base, &res_old_1, val)
+
+#define PREP_CONF_WIDE_FN_3(mask_base, val)                                 \
+    prep_conf_wide_teddy_m3(mask_base, &res_old_1, &res_old_2, val)
+
+#define PREP_CONF_WIDE_FN_4(mask_base, val)                                 \
+    prep_conf_wide_teddy_m4(mask_base, &res_old_1, &res_old_2, &res_old_3, \
+                            val)
+
+#define PREP_CONF_WIDE_FN(mask_base, val, n)                                \
+    PREP_CONF_WIDE_FN_##n(mask_base, val)
+
+#define FDR_EXEC_WIDE_TEDDY(fdr, a, control, n_msk, conf_fn)                \
+do {                                                                        \
+    const u8 *buf_end = a->buf + a->len;                                    \
+    const u8 *ptr = a->buf + a->start_offset;                               \
+    u32 floodBackoff = FLOOD_BACKOFF_START;                                 \
+    const u8 *tryFloodDetect = a->firstFloodDetect;                         \
+    u32 last_match = ones_u32;                                              \
+    const struct Teddy *teddy = (const struct Teddy *)fdr;                  \
+    const size_t iterBytes = 32;                                            \
+    DEBUG_PRINTF("params: buf %p len %zu start_offset %zu\n",               \
+                 a->buf, a->len, a->start_offset);                          \
+                                                                            \
+    const m512 *maskBase = getMaskBase_wide(teddy);                         \
+    const u32 *confBase = getConfBase(teddy);                               \
+                                                                            \
+    FDR_EXEC_WIDE_TEDDY_RES_OLD(n_msk);                                     \
+    const u8 *mainStart = ROUNDUP_PTR(ptr, 16);                             \
+    DEBUG_PRINTF("derive: ptr: %p mainstart %p\n", ptr, mainStart);         \
+    if (ptr < mainStart) {                                                  \
+        ptr = mainStart - 16;                                               \
+        m512 p_mask;                                                        \
+        m512 val_0 = vectoredLoad4x128(&p_mask, ptr, a->start_offset,       \
+                                       a->buf, buf_end,                     \
+                                       a->buf_history, a->len_history,      \
+                                       n_msk);                              \
+        m512 r_0 = PREP_CONF_WIDE_FN(maskBase, val_0, n_msk);               \
+        r_0 = or512(r_0, p_mask);                                           \
+        CONFIRM_WIDE_TEDDY(r_0, 0, VECTORING, conf_fn);                     \
+        ptr += 16;                                                          \
+    }                                                                       \
+                                                                            \
+    if (ptr + 16 <= buf_end) {                                              \
+        m512 r_0 = PREP_CONF_WIDE_FN(maskBase, set1_4x128(load128(ptr)),    \
+                                     n_msk);                                \
+        CONFIRM_WIDE_TEDDY(r_0, 0, VECTORING, conf_fn);                     \
+        ptr += 16;                                                          \
+    }                                                                       \
+                                                                            \
+    for ( ; ptr + iterBytes <= buf_end; ptr += iterBytes) {                 \
+        __builtin_prefetch(ptr + (iterBytes * 4));                          \
+        CHECK_FLOOD;                                                        \
+        m512 r_0 = PREP_CONF_WIDE_FN(maskBase, set1_4x128(load128(ptr)),    \
+                                     n_msk);                                \
+        CONFIRM_WIDE_TEDDY(r_0, 0, NOT_CAUTIOUS, conf_fn);                  \
+        m512 r_1 = PREP_CONF_WIDE_FN(maskBase,                              \
+                                     set1_4x128(load128(ptr + 16)), n_msk); \
+        CONFIRM_WIDE_TEDDY(r_1, 16, NOT_CAUTIOUS, conf_fn);                 \
+    }                                                                       \
+                                                                            \
+    if (ptr + 16 <= buf_end) {                                              \
+        m512 r_0 = PREP_CONF_WIDE_FN(maskBase, set1_4x128(load128(ptr)),    \
+                                     n_msk);                                \
+        CONFIRM_WIDE_TEDDY(r_0, 0, NOT_CAUTIOUS, conf_fn);                  \
+        ptr += 16;                                                          \
+    }                                                                       \
+                                                                            \
+    assert(ptr + 16 > buf_end);                                             \
+    if (ptr < buf_end) {                                                    \
+        m512 p_mask;                                                        \
+        m512 val_0 = vectoredLoad4x128(&p_mask, ptr, 0, ptr, buf_end,       \
+                                       a->buf_history, a->len_history,      \
+                                       n_msk);                              \
+        m512 r_0 = PREP_CONF_WIDE_FN(maskBase, val_0, n_msk);               \
+        r_0 = or512(r_0, p_mask);                                           \
+        CONFIRM_WIDE_TEDDY(r_0, 0, VECTORING, conf_fn);                     \
+    }                                                                       \
+                                                                            \
+    return HWLM_SUCCESS;                                                    \
+} while(0)
+
+hwlm_error_t fdr_exec_wide_teddy_msks1(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 1, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks1_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 1, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks2(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 2, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks2_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 2, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks3(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 3, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks3_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 3, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks4(const struct FDR *fdr,
+                                       const struct FDR_Runtime_Args *a,
+                                       hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 4, do_confWithBit_teddy);
+}
+
+hwlm_error_t fdr_exec_wide_teddy_msks4_pck(const struct FDR *fdr,
+                                           const struct FDR_Runtime_Args *a,
+                                           hwlm_group_t control) {
+    FDR_EXEC_WIDE_TEDDY(fdr, a, control, 4, do_confWithBit_teddy);
+}
+
+#endif // HAVE_AVX512
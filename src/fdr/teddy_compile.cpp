@@ -50,6 +50,7 @@
 #include "util/popcount.h"
 #include "util/small_vector.h"
 #include "util/target_info.h"
+#include "util/traffic_model.h"
 #include "util/verify_types.h"
 
 #include <algorithm>
@@ -75,6 +76,12 @@ namespace {
 /** \brief Max number of Teddy masks we use. */
 static constexpr size_t MAX_NUM_MASKS = 4;
 
+/**
+ * \brief Scale applied to modelled traffic probabilities to bring them into
+ * the fixed-point range of TeddySet::probability().
+ */
+static constexpr double TRAFFIC_PROB_SCALE = 1099511627776.0; // 2^40
+
 class TeddyCompiler : noncopyable {
     const TeddyEngineDescription &eng;
     const Grey &grey;
@@ -118,8 +125,26 @@ class TeddySet {
      */
     small_vector<u32, LITS_PER_SET> litIds;
 
+    /** \brief Traffic model used in place of random data, if any. */
+    const TrafficModel *traffic;
+
+    /** \brief Sum of the modelled traffic hit rates of our literals. */
+    double hitProb = 0;
+
+    /** \brief Modelled probability of firing on the traffic. */
+    double trafficProb = 0;
+
+    void updateTrafficProb() {
+        double p = 1.0;
+        for (u32 i = 0; i < len; i++) {
+            p *= traffic->nibbleProb(nibbleSets[i * 2], nibbleSets[i * 2 + 1]);
+        }
+        trafficProb = max(p, hitProb);
+    }
+
 public:
-    explicit TeddySet(u32 len_in) : len(len_in), nibbleSets(len_in * 2, 0) {}
+    explicit TeddySet(u32 len_in, const TrafficModel *traffic_in = nullptr)
+        : len(len_in), nibbleSets(len_in * 2, 0), traffic(traffic_in) {}
     size_t litCount() const { return litIds.size(); }
     const small_vector<u32, LITS_PER_SET> &getLits() const { return litIds; }
 
@@ -167,13 +192,20 @@ public:
         }
         litIds.emplace_back(lit_id);
         sort_and_unique(litIds);
+        if (traffic) {
+            hitProb = literalTrafficProb(lit, *traffic);
+            updateTrafficProb();
+        }
     }
 
     // return a value p from 0 .. MAXINT64 that gives p/MAXINT64
     // likelihood of this TeddySet firing a first-stage accept
     // if it was given a bucket of its own and random data were
-    // to be passed in
+    // to be passed in (or the modelled traffic, if we have one)
     u64a probability() const {
+        if (traffic) {
+            return (u64a)(trafficProb * TRAFFIC_PROB_SCALE);
+        }
         u64a val = 1;
         for (size_t i = 0; i < nibbleSets.size(); i++) {
             val *= popcount32((u32)nibbleSets[i]);
@@ -215,6 +247,11 @@ public:
         m.litIds.insert(m.litIds.end(), b.litIds.begin(), b.litIds.end());
         sort_and_unique(m.litIds);
 
+        if (m.traffic) {
+            m.hitProb += b.hitProb;
+            m.updateTrafficProb();
+        }
+
         return m;
     }
 };
@@ -222,11 +259,12 @@ public:
 static
 bool pack(const vector<hwlmLiteral> &lits,
           const TeddyEngineDescription &eng,
-          map<BucketIndex, std::vector<LiteralIndex>> &bucketToLits) {
+          map<BucketIndex, std::vector<LiteralIndex>> &bucketToLits,
+          const TrafficModel *traffic) {
     set<TeddySet> sts;
 
     for (u32 i = 0; i < lits.size(); i++) {
-        TeddySet ts(eng.numMasks);
+        TeddySet ts(eng.numMasks, traffic);
         ts.addLiteral(i, lits[i]);
         sts.insert(ts);
     }
@@ -564,6 +602,8 @@ bytecode_ptr<FDR> TeddyCompiler::build() {
     size_t reinforcedDupMaskLen = RTABLE_SIZE * maskWidth;
     if (maskWidth == 2) { // dup nibble mask table in Fat Teddy
         reinforcedDupMaskLen = maskLen * 2;
+    } else if (maskWidth == 4) { // Wide Teddy has no extra tables
+        reinforcedDupMaskLen = 0;
     }
 
     auto floodTable = setupFDRFloodControl(lits, eng, grey);
@@ -608,8 +648,7 @@ bytecode_ptr<FDR> TeddyCompiler::build() {
         // Write reinforcement masks.
         u8 *reinforcedMsk = baseMsk + ROUNDUP_CL(maskLen);
         fillReinforcedTable(bucketToLits, lits, reinforcedMsk, maskWidth);
-    } else { // dup nibble mask table in Fat Teddy
-        assert(maskWidth == 2);
+    } else if (maskWidth == 2) { // dup nibble mask table in Fat Teddy
         u8 *dupMsk = baseMsk + ROUNDUP_CL(maskLen);
         fillDupNibbleMasks(bucketToLits, lits, eng.numMasks,
 			   reinforcedDupMaskLen, dupMsk);
@@ -623,7 +662,8 @@ static
 bool assignStringsToBuckets(
                 const vector<hwlmLiteral> &lits,
                 TeddyEngineDescription &eng,
-                map<BucketIndex, vector<LiteralIndex>> &bucketToLits) {
+                map<BucketIndex, vector<LiteralIndex>> &bucketToLits,
+                const TrafficModel *traffic) {
     assert(eng.numMasks <= MAX_NUM_MASKS);
     if (lits.size() > eng.getNumBuckets() * TEDDY_BUCKET_LOAD) {
         DEBUG_PRINTF("too many literals: %zu\n", lits.size());
@@ -641,7 +681,7 @@ bool assignStringsToBuckets(
     }
 #endif
 
-    if (!pack(lits, eng, bucketToLits)) {
+    if (!pack(lits, eng, bucketToLits, traffic)) {
         DEBUG_PRINTF("more lits (%zu) than buckets (%u), can't pack.\n",
                      lits.size(), eng.getNumBuckets());
         return false;
@@ -660,7 +700,8 @@ bytecode_ptr<FDR> teddyBuildTable(const HWLMProto &proto, const Grey &grey) {
 
 unique_ptr<HWLMProto> teddyBuildProtoHinted(
                         u8 engType, const vector<hwlmLiteral> &lits,
-                        bool make_small, u32 hint, const target_t &target) {
+                        bool make_small, u32 hint, const target_t &target,
+                        const TrafficModel *traffic) {
     unique_ptr<TeddyEngineDescription> des;
     if (hint == HINT_INVALID) {
         des = chooseTeddyEngine(target, lits);
@@ -672,7 +713,7 @@ unique_ptr<HWLMProto> teddyBuildProtoHinted(
     }
 
     map<BucketIndex, std::vector<LiteralIndex>> bucketToLits;
-    if (!assignStringsToBuckets(lits, *des, bucketToLits)) {
+    if (!assignStringsToBuckets(lits, *des, bucketToLits, traffic)) {
         return nullptr;
     }
 
@@ -680,4 +721,33 @@ unique_ptr<HWLMProto> teddyBuildProtoHinted(
                                        bucketToLits, make_small);
 }
 
+double teddyTrafficCost(const HWLMProto &proto, const TrafficModel &traffic) {
+    assert(proto.teddyEng);
+    const TeddyEngineDescription &eng = *proto.teddyEng;
+
+    // Each mask costs a shuffle pair per block; fat and wide Teddy run
+    // their masks over two or four lanes of a wider register.
+    double cost = 0.1 * (1 + eng.numMasks);
+    if (eng.getNumBuckets() > 16) {
+        cost *= 2.0;
+    } else if (eng.getNumBuckets() > 8) {
+        cost *= 1.5;
+    }
+
+    for (const auto &m : proto.bucketToLits) {
+        TeddySet ts(eng.numMasks, &traffic);
+        for (const auto &id : m.second) {
+            TeddySet lit_ts(eng.numMasks, &traffic);
+            lit_ts.addLiteral(id, proto.lits[id]);
+            ts = ts.litCount() ? merge(ts, lit_ts) : lit_ts;
+        }
+        double fire = ts.probability() / TRAFFIC_PROB_SCALE;
+        cost += TRAFFIC_CONFIRM_COST * fire * (2 + m.second.size());
+    }
+
+    DEBUG_PRINTF("teddy %u: masks=%u, buckets=%u -> cost=%f\n", eng.getID(),
+                 eng.numMasks, eng.getNumBuckets(), cost);
+    return cost;
+}
+
 } // namespace ue2
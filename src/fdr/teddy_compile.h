@@ -45,6 +45,7 @@ struct FDR;
 namespace ue2 {
 
 class TeddyEngineDescription;
+class TrafficModel;
 struct Grey;
 struct hwlmLiteral;
 struct target_t;
@@ -53,7 +54,14 @@ bytecode_ptr<FDR> teddyBuildTable(const HWLMProto &proto, const Grey &grey);
 
 std::unique_ptr<HWLMProto> teddyBuildProtoHinted(
                           u8 engType, const std::vector<hwlmLiteral> &lits,
-                          bool make_small, u32 hint, const target_t &target);
+                          bool make_small, u32 hint, const target_t &target,
+                          const TrafficModel *traffic = nullptr);
+
+/**
+ * \brief Returns the modelled cost, in cycles per byte, of scanning traffic
+ * resembling the model with the given Teddy prototype.
+ */
+double teddyTrafficCost(const HWLMProto &proto, const TrafficModel &traffic);
 } // namespace ue2
 
 #endif // TEDDY_COMPILE_H
@@ -68,6 +68,15 @@ void getTeddyDescriptions(vector<TeddyEngineDescription> *out) {
         { 16, 0, 3, 8, true },
         { 17, 0, 4, 8, false },
         { 18, 0, 4, 8, true },
+        // Wide Teddy (32 buckets) runs on AVX-512.
+        { 19, 0 | HS_CPU_FEATURES_AVX512, 1, 32, false },
+        { 20, 0 | HS_CPU_FEATURES_AVX512, 1, 32, true },
+        { 21, 0 | HS_CPU_FEATURES_AVX512, 2, 32, false },
+        { 22, 0 | HS_CPU_FEATURES_AVX512, 2, 32, true },
+        { 23, 0 | HS_CPU_FEATURES_AVX512, 3, 32, false },
+        { 24, 0 | HS_CPU_FEATURES_AVX512, 3, 32, true },
+        { 25, 0 | HS_CPU_FEATURES_AVX512, 4, 32, false },
+        { 26, 0 | HS_CPU_FEATURES_AVX512, 4, 32, true },
     };
     out->clear();
     for (const auto &def : defns) {
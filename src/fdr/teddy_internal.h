@@ -39,6 +39,7 @@
  * * |     | reinforcement mask table for bucket 8..15 (FAT teddy)
  * * |     |
  * * |-----|
+ * *         (none for WIDE teddy, 32 buckets)
  * * |     | confirm
  * * |     |
  * * |     |
@@ -64,6 +64,7 @@ Grey::Grey(void) :
                    allowDecoratedLiteral(true),
                    allowApproximateMatching(true),
                    allowNoodle(true),
+                   noodleMaxLiterals(4),
                    fdrAllowTeddy(true),
                    fdrAllowFlood(true),
                    violetAvoidSuffixes(true),
@@ -241,6 +242,7 @@ void applyGreyOverrides(Grey *g, const string &s) {
         G_UPDATE(allowCastle);
         G_UPDATE(allowDecoratedLiteral);
         G_UPDATE(allowNoodle);
+        G_UPDATE(noodleMaxLiterals);
         G_UPDATE(allowApproximateMatching);
         G_UPDATE(fdrAllowTeddy);
         G_UPDATE(fdrAllowFlood);
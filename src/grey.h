@@ -65,6 +65,7 @@ struct Grey {
     bool allowApproximateMatching;
 
     bool allowNoodle;
+    u32 noodleMaxLiterals; //!< max literals in an HWLM table for Noodle
     bool fdrAllowTeddy;
     bool fdrAllowFlood;
 
@@ -35,6 +35,7 @@
 #include "hs_compile.h"
 #include "hs_internal.h"
 #include "database.h"
+#include "compiler/compile_cache.h"
 #include "compiler/compiler.h"
 #include "compiler/error.h"
 #include "nfagraph/ng.h"
@@ -50,19 +51,33 @@
 #elif defined(ARCH_ARM32) || defined(ARCH_AARCH64)
 #endif
 #include "util/depth.h"
+#include "util/parallel.h"
 #include "util/popcount.h"
 #include "util/target_info.h"
+#include "util/traffic_model.h"
 
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <exception>
 #include <limits.h>
+#include <memory>
 #include <string>
 #include <vector>
 
 using namespace std;
 using namespace ue2;
 
+/** \brief A traffic profile, as built by hs_traffic_add(). */
+struct hs_traffic {
+    /** \brief Number of times byte a was immediately followed by byte b, at
+     * pairs[a][b]. */
+    unsigned long long pairs[256][256];
+
+    /** \brief Total of all the pair counts. */
+    unsigned long long total;
+};
+
 /** \brief Cheap check that no unexpected mode flags are on. */
 static
 bool validModeFlags(unsigned int mode) {
@@ -71,7 +86,9 @@ bool validModeFlags(unsigned int mode) {
                                        | HS_MODE_VECTORED
                                        | HS_MODE_SOM_HORIZON_LARGE
                                        | HS_MODE_SOM_HORIZON_MEDIUM
-                                       | HS_MODE_SOM_HORIZON_SMALL;
+                                       | HS_MODE_SOM_HORIZON_SMALL
+                                       | HS_MODE_EXISTENCE
+                                       | HS_MODE_COUNT;
 
     return !(mode & ~allModeFlags);
 }
@@ -118,9 +135,57 @@ bool checkMode(unsigned int mode, hs_compile_error **comp_error) {
         }
     }
 
+    // Existence and count modes replace the callback in block mode only, and
+    // are alternatives to each other.
+    unsigned matchMode = mode & (HS_MODE_EXISTENCE | HS_MODE_COUNT);
+    if (matchMode) {
+        if (!(mode & HS_MODE_BLOCK)) {
+            *comp_error = generateCompileError("Invalid parameter: the "
+                    "HS_MODE_EXISTENCE and HS_MODE_COUNT mode flags may only "
+                    "be set in block mode.", -1);
+            return false;
+        }
+        if ((matchMode & (matchMode - 1)) != 0) {
+            *comp_error = generateCompileError("Invalid parameter: only one "
+                    "of HS_MODE_EXISTENCE and HS_MODE_COUNT can be set.", -1);
+            return false;
+        }
+    }
+
     return true;
 }
 
+/**
+ * \brief Check that an expression's flags and extended parameters can be
+ * supported in the given mode; throws CompileError if not.
+ *
+ * Matches found by logical combinations and stored SOM matches are delivered
+ * straight to the callback, bypassing the specialised reports used by the
+ * existence and count modes. A min_length constraint is satisfied with SOM,
+ * so it cannot be counted either.
+ */
+static
+void checkExpressionMode(unsigned mode, unsigned flags,
+                         const hs_expr_ext *ext) {
+    if (!(mode & (HS_MODE_EXISTENCE | HS_MODE_COUNT))) {
+        return;
+    }
+    if (flags & HS_FLAG_COMBINATION) {
+        throw CompileError("HS_FLAG_COMBINATION is not supported with the "
+                           "HS_MODE_EXISTENCE or HS_MODE_COUNT mode flags.");
+    }
+    if ((mode & HS_MODE_COUNT) && (flags & HS_FLAG_SOM_LEFTMOST)) {
+        throw CompileError("HS_FLAG_SOM_LEFTMOST is not supported with the "
+                           "HS_MODE_COUNT mode flag.");
+    }
+    if ((mode & HS_MODE_COUNT) && ext &&
+        (ext->flags & HS_EXT_FLAG_MIN_LENGTH) && ext->min_length &&
+        !(flags & HS_FLAG_PREFILTER)) {
+        throw CompileError("The min_length extended parameter is not "
+                           "supported with the HS_MODE_COUNT mode flag.");
+    }
+}
+
 static
 bool checkPlatform(const hs_platform_info *p, hs_compile_error **comp_error) {
     static constexpr u32 HS_TUNE_LAST = HS_TUNE_FAMILY_ICX;
@@ -167,12 +232,89 @@ unsigned getSomPrecision(unsigned mode) {
 
 namespace ue2 {
 
+/** \brief The traffic profile in the compile options, if any. */
+static
+const hs_traffic_t *optionsTraffic(const hs_compile_options_t *options) {
+    if (!options || !(options->flags & HS_COMPILE_OPT_TRAFFIC)) {
+        return nullptr;
+    }
+    return options->traffic;
+}
+
+/** \brief The cache directory in the compile options, if any. */
+static
+const char *optionsCacheDir(const hs_compile_options_t *options) {
+    if (!options || !(options->flags & HS_COMPILE_OPT_CACHE_DIR)) {
+        return nullptr;
+    }
+    return options->cache_dir;
+}
+
+static
+shared_ptr<const TrafficModel> makeTrafficModel(const hs_traffic_t *traffic) {
+    if (!traffic) {
+        return nullptr;
+    }
+    return make_shared<TrafficModel>(&traffic->pairs[0][0]);
+}
+
+/** \brief Cheap check that no unexpected compile option flags are on. */
+static
+bool validOptionFlags(const hs_compile_options_t *options) {
+    static const unsigned long long allOptFlags = HS_COMPILE_OPT_THREADS
+                                                | HS_COMPILE_OPT_TRAFFIC
+                                                | HS_COMPILE_OPT_CACHE_DIR;
+
+    return !options || !(options->flags & ~allOptFlags);
+}
+
+/** \brief Validate the compile options passed to a compile call. */
+static
+bool checkOptions(const hs_compile_options_t *options,
+                  hs_compile_error **comp_error) {
+    if (!validOptionFlags(options)) {
+        *comp_error = generateCompileError("Invalid parameter: "
+                "unrecognised compile option flags.", -1);
+        return false;
+    }
+
+    const hs_traffic_t *traffic = optionsTraffic(options);
+    if (traffic && !traffic->total) {
+        *comp_error = generateCompileError("Invalid parameter: traffic "
+                                           "profile has no byte pairs.", -1);
+        return false;
+    }
+
+    if (options && (options->flags & HS_COMPILE_OPT_CACHE_DIR) &&
+        !options->cache_dir) {
+        *comp_error = generateCompileError("Invalid parameter: cache "
+                                           "directory is NULL.", -1);
+        return false;
+    }
+    return true;
+}
+
+/** \brief Thread count for the CompileContext, where zero means one thread
+ * per hardware thread. */
+static
+u32 compileThreads(const hs_compile_options_t *options) {
+    if (!options || !(options->flags & HS_COMPILE_OPT_THREADS) ||
+        !options->threads) {
+        return 1;
+    }
+    if (options->threads == HS_COMPILE_THREADS_ALL) {
+        return 0;
+    }
+    return options->threads;
+}
+
 hs_error_t
 hs_compile_multi_int(const char *const *expressions, const unsigned *flags,
                      const unsigned *ids, const hs_expr_ext *const *ext,
                      unsigned elements, unsigned mode,
                      const hs_platform_info_t *platform, hs_database_t **db,
-                     hs_compile_error_t **comp_error, const Grey &g) {
+                     hs_compile_error_t **comp_error, const Grey &g,
+                     const hs_compile_options_t *options) {
     // Check the args: note that it's OK for flags, ids or ext to be null.
     if (!comp_error) {
         if (db) {
@@ -220,6 +362,12 @@ hs_compile_multi_int(const char *const *expressions, const unsigned *flags,
         return HS_COMPILER_ERROR;
     }
 
+    if (!checkOptions(options, comp_error)) {
+        *db = nullptr;
+        assert(*comp_error); // set by checkOptions.
+        return HS_COMPILER_ERROR;
+    }
+
     if (elements > g.limitPatternCount) {
         *db = nullptr;
         *comp_error = generateCompileError("Number of patterns too large", -1);
@@ -235,14 +383,50 @@ hs_compile_multi_int(const char *const *expressions, const unsigned *flags,
                                     : get_current_target();
 
     try {
-        CompileContext cc(isStreaming, isVectored, target_info, g);
+        CompileContext cc(isStreaming, isVectored, target_info, g,
+                          mode & HS_MODE_EXISTENCE, mode & HS_MODE_COUNT,
+                          compileThreads(options),
+                          makeTrafficModel(optionsTraffic(options)));
         NG ng(cc, elements, somPrecision);
 
+        // Expressions can be parsed independently, so with multiple threads
+        // we do this up front. Any parse errors are held until the serial
+        // loop below reaches that expression, so that we report the same
+        // error as a single-threaded compile would.
+        vector<unique_ptr<ParsedExpression>> parsed;
+        vector<exception_ptr> parseErrors;
+        if (cc.numThreads > 1 && elements > 1) {
+            parsed.resize(elements);
+            parseErrors.resize(elements);
+            parallel_for(cc.numThreads, elements, [&](size_t i) {
+                unsigned f = flags ? flags[i] : 0;
+                if (f & HS_FLAG_COMBINATION) {
+                    return; // handled by addExpression
+                }
+                try {
+                    parsed[i] = parseExpression(cc, i, expressions[i], f,
+                                                ext ? ext[i] : nullptr,
+                                                ids ? ids[i] : 0);
+                } catch (...) {
+                    parseErrors[i] = current_exception();
+                }
+            });
+        }
+
         for (unsigned int i = 0; i < elements; i++) {
             // Add this expression to the compiler
             try {
-                addExpression(ng, i, expressions[i], flags ? flags[i] : 0,
-                              ext ? ext[i] : nullptr, ids ? ids[i] : 0);
+                checkExpressionMode(mode, flags ? flags[i] : 0,
+                                    ext ? ext[i] : nullptr);
+                if (!parsed.empty() && parseErrors[i]) {
+                    rethrow_exception(parseErrors[i]);
+                } else if (!parsed.empty() && parsed[i]) {
+                    addParsedExpression(ng, *parsed[i]);
+                    parsed[i].reset();
+                } else {
+                    addExpression(ng, i, expressions[i], flags ? flags[i] : 0,
+                                  ext ? ext[i] : nullptr, ids ? ids[i] : 0);
+                }
             } catch (CompileError &e) {
                 /* Caught a parse error:
                  * throw it upstream as a CompileError with a specific index */
@@ -292,7 +476,8 @@ hs_compile_lit_multi_int(const char *const *expressions, const unsigned *flags,
                          const unsigned *ids, const hs_expr_ext *const *ext,
                          const size_t *lens, unsigned elements, unsigned mode,
                          const hs_platform_info_t *platform, hs_database_t **db,
-                         hs_compile_error_t **comp_error, const Grey &g) {
+                         hs_compile_error_t **comp_error, const Grey &g,
+                         const hs_compile_options_t *options) {
     // Check the args: note that it's OK for flags, ids or ext to be null.
     if (!comp_error) {
         if (db) {
@@ -344,6 +529,12 @@ hs_compile_lit_multi_int(const char *const *expressions, const unsigned *flags,
         return HS_COMPILER_ERROR;
     }
 
+    if (!checkOptions(options, comp_error)) {
+        *db = nullptr;
+        assert(*comp_error); // set by checkOptions.
+        return HS_COMPILER_ERROR;
+    }
+
     if (elements > g.limitPatternCount) {
         *db = nullptr;
         *comp_error = generateCompileError("Number of patterns too large", -1);
@@ -359,12 +550,17 @@ hs_compile_lit_multi_int(const char *const *expressions, const unsigned *flags,
                                     : get_current_target();
 
     try {
-        CompileContext cc(isStreaming, isVectored, target_info, g);
+        CompileContext cc(isStreaming, isVectored, target_info, g,
+                          mode & HS_MODE_EXISTENCE, mode & HS_MODE_COUNT,
+                          compileThreads(options),
+                          makeTrafficModel(optionsTraffic(options)));
         NG ng(cc, elements, somPrecision);
 
         for (unsigned int i = 0; i < elements; i++) {
             // Add this expression to the compiler
             try {
+                checkExpressionMode(mode, flags ? flags[i] : 0,
+                                    ext ? ext[i] : nullptr);
                 addLitExpression(ng, i, expressions[i], flags ? flags[i] : 0,
                                  ext ? ext[i] : nullptr, ids ? ids[i] : 0,
                                  lens[i]);
@@ -412,6 +608,73 @@ hs_compile_lit_multi_int(const char *const *expressions, const unsigned *flags,
     }
 }
 
+/** \brief Compiles a pattern set, or a pure literal set if \p literal is
+ * set, going through the on-disk cache if the options name a cache
+ * directory. */
+static
+hs_error_t compileWithCache(bool literal, const char *const *expressions,
+                            const unsigned *flags, const unsigned *ids,
+                            const hs_expr_ext *const *ext, const size_t *lens,
+                            unsigned elements, unsigned mode,
+                            const hs_platform_info_t *platform,
+                            const hs_compile_options_t *options,
+                            hs_database_t **db, hs_compile_error_t **error) {
+    auto compile = [&]() {
+        if (literal) {
+            return hs_compile_lit_multi_int(expressions, flags, ids, ext, lens,
+                                            elements, mode, platform, db,
+                                            error, Grey(), options);
+        }
+        return hs_compile_multi_int(expressions, flags, ids, ext, elements,
+                                    mode, platform, db, error, Grey(), options);
+    };
+
+    // Invalid options are left for the compiler to report.
+    const char *cache_dir = optionsCacheDir(options);
+    const hs_traffic_t *traffic = optionsTraffic(options);
+    if (!cache_dir || !db || !validOptionFlags(options) ||
+        (traffic && !traffic->total) || (literal && !lens)) {
+        return compile();
+    }
+
+    // The key must track the platform we are compiling for, so resolve a NULL
+    // platform to the current host.
+    hs_platform_info_t host;
+    if (!platform) {
+        hs_populate_platform(&host);
+    }
+    const hs_platform_info_t &target = platform ? *platform : host;
+
+    string key;
+    try {
+        key = makeCompileCacheKey(expressions, flags, ids, ext, lens, elements,
+                                  mode, target,
+                                  makeTrafficModel(traffic).get());
+    } catch (const std::bad_alloc &) {
+        // Leave the key empty and compile without the cache.
+    }
+    if (key.empty()) {
+        // Invalid arguments; let the compiler report the error.
+        return compile();
+    }
+
+    string path = compileCachePath(cache_dir, key);
+    hs_database_t *cached = loadCachedDatabase(path, key);
+    if (cached) {
+        *db = cached;
+        if (error) {
+            *error = nullptr;
+        }
+        return HS_SUCCESS;
+    }
+
+    hs_error_t err = compile();
+    if (err == HS_SUCCESS) {
+        storeCachedDatabase(path, key, *db);
+    }
+    return err;
+}
+
 } // namespace ue2
 
 extern "C" HS_PUBLIC_API
@@ -457,6 +720,20 @@ hs_error_t HS_CDECL hs_compile_ext_multi(const char * const *expressions,
                                 platform, db, error, Grey());
 }
 
+extern "C" HS_PUBLIC_API
+hs_error_t HS_CDECL hs_compile_ext_multi_opts(const char *const *expressions,
+                                     const unsigned *flags, const unsigned *ids,
+                                     const hs_expr_ext * const *ext,
+                                     unsigned elements, unsigned mode,
+                                     const hs_platform_info_t *platform,
+                                     const hs_compile_options_t *options,
+                                     hs_database_t **db,
+                                     hs_compile_error_t **error) {
+    const size_t *lens = nullptr; // unused for this call.
+    return compileWithCache(false, expressions, flags, ids, ext, lens,
+                            elements, mode, platform, options, db, error);
+}
+
 extern "C" HS_PUBLIC_API
 hs_error_t HS_CDECL hs_compile_lit(const char *expression, unsigned flags,
                                    const size_t len, unsigned mode,
@@ -492,6 +769,21 @@ hs_error_t HS_CDECL hs_compile_lit_multi(const char * const *expressions,
                                     Grey());
 }
 
+extern "C" HS_PUBLIC_API
+hs_error_t HS_CDECL hs_compile_lit_multi_opts(const char * const *expressions,
+                                         const unsigned *flags,
+                                         const unsigned *ids,
+                                         const size_t *lens,
+                                         unsigned elements, unsigned mode,
+                                         const hs_platform_info_t *platform,
+                                         const hs_compile_options_t *options,
+                                         hs_database_t **db,
+                                         hs_compile_error_t **error) {
+    const hs_expr_ext * const *ext = nullptr; // unused for this call.
+    return compileWithCache(true, expressions, flags, ids, ext, lens,
+                            elements, mode, platform, options, db, error);
+}
+
 static
 hs_error_t hs_expression_info_int(const char *expression, unsigned int flags,
                                   const hs_expr_ext_t *ext, unsigned int mode,
@@ -633,6 +925,50 @@ hs_error_t HS_CDECL hs_populate_platform(hs_platform_info_t *platform) {
     return HS_SUCCESS;
 }
 
+extern "C" HS_PUBLIC_API
+hs_error_t HS_CDECL hs_alloc_traffic(hs_traffic_t **traffic) {
+    if (!traffic) {
+        return HS_INVALID;
+    }
+    *traffic = nullptr;
+
+    hs_traffic_t *t = (hs_traffic_t *)hs_misc_alloc(sizeof(hs_traffic_t));
+    hs_error_t err = hs_check_alloc(t);
+    if (err != HS_SUCCESS) {
+        hs_misc_free(t);
+        return err;
+    }
+
+    memset(t, 0, sizeof(*t));
+    *traffic = t;
+    return HS_SUCCESS;
+}
+
+extern "C" HS_PUBLIC_API
+hs_error_t HS_CDECL hs_traffic_add(hs_traffic_t *traffic, const char *data,
+                                   size_t length) {
+    if (!traffic || (!data && length)) {
+        return HS_INVALID;
+    }
+
+    const u8 *buf = (const u8 *)data;
+    for (size_t i = 1; i < length; i++) {
+        traffic->pairs[buf[i - 1]][buf[i]]++;
+    }
+    if (length > 1) {
+        traffic->total += length - 1;
+    }
+    return HS_SUCCESS;
+}
+
+extern "C" HS_PUBLIC_API
+hs_error_t HS_CDECL hs_free_traffic(hs_traffic_t *traffic) {
+    if (traffic) {
+        hs_misc_free(traffic);
+    }
+    return HS_SUCCESS;
+}
+
 extern "C" HS_PUBLIC_API
 hs_error_t HS_CDECL hs_free_compile_error(hs_compile_error_t *error) {
 #if defined(FAT_RUNTIME)
@@ -166,6 +166,71 @@ hs_error_t HS_CDECL hs_deserialize_database_at(const char *bytes,
                                                const size_t length,
                                                hs_database_t *db);
 
+/**
+ * Serialize a pattern database to a memory image that can be used in place,
+ * without being copied, by @ref hs_deserialize_database_in_place().
+ *
+ * Unlike the output of @ref hs_serialize_database(), the image is laid out
+ * exactly as the database itself, so it can be written to a file and later
+ * mapped into memory (for example with `mmap()`) by any number of processes,
+ * which then share the same pages. Like a serialized database, an image can
+ * only be used with the same version of Hyperscan on a compatible platform;
+ * it is additionally specific to the host's data layout (such as its
+ * endianness and word size).
+ *
+ * @param db
+ *      A compiled pattern database.
+ *
+ * @param bytes
+ *      On success, a pointer to an array of bytes will be returned here.
+ *      These bytes can be subsequently relocated or written to disk. The
+ *      caller is responsible for freeing this block.
+ *
+ * @param length
+ *      On success, the number of bytes in the generated image will be
+ *      returned here.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, @ref HS_NOMEM if the byte array cannot be
+ *      allocated, other values may be returned if errors are detected.
+ */
+hs_error_t HS_CDECL hs_serialize_database_image(const hs_database_t *db,
+                                                char **bytes, size_t *length);
+
+/**
+ * Use a database image previously generated by @ref
+ * hs_serialize_database_image() in place.
+ *
+ * The image is validated (including its checksum) but not copied: on
+ * success, the returned database points at the image itself, which must
+ * remain valid and unmodified for as long as the database is used. The image
+ * is only ever read, so it may be in read-only memory such as a shared file
+ * mapping. The image must be aligned to a 64-byte boundary; memory returned
+ * by `mmap()` always is.
+ *
+ * The returned database must not be passed to @ref hs_free_database(); it is
+ * released by releasing the image.
+ *
+ * @param bytes
+ *      A 64-byte aligned byte array generated by @ref
+ *      hs_serialize_database_image().
+ *
+ * @param length
+ *      The length of the byte array generated by @ref
+ *      hs_serialize_database_image().
+ *
+ * @param db
+ *      On success, a pointer to the database within @p bytes will be returned
+ *      here. This database can then be used for scanning.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, @ref HS_BAD_ALIGN if @p bytes is not
+ *      suitably aligned, other values on failure.
+ */
+hs_error_t HS_CDECL hs_deserialize_database_in_place(const char *bytes,
+                                                     const size_t length,
+                                                     const hs_database_t **db);
+
 /**
  * Provides the size of the stream state allocated by a single stream opened
  * against the given database.
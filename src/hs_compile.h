@@ -162,6 +162,113 @@ typedef struct hs_platform_info {
     unsigned long long reserved2;
 } hs_platform_info_t;
 
+/**
+ * A traffic profile: a histogram of adjacent byte pairs in a sample of the
+ * traffic that a database is expected to scan, used to tune its literal
+ * matchers; see @ref hs_compile_options_t::traffic.
+ *
+ * The structure is opaque. It is allocated with @ref hs_alloc_traffic(),
+ * filled with @ref hs_traffic_add() and freed with @ref hs_free_traffic().
+ */
+struct hs_traffic;
+
+/**
+ * A type containing a traffic profile.
+ */
+typedef struct hs_traffic hs_traffic_t;
+
+/**
+ * Options that apply to a compile as a whole, for the compile functions that
+ * take them, such as @ref hs_compile_ext_multi_opts().
+ *
+ * As with @ref hs_expr_ext_t, the compiler only reads the fields whose flags
+ * are set in hs_compile_options::flags, so a structure built against an older
+ * version of this header remains valid when later versions add fields. A
+ * structure with no flags set gives the same compile as a NULL options
+ * pointer, and as the compile functions that do not take options.
+ */
+typedef struct hs_compile_options {
+    /**
+     * Flags governing which parts of this structure are to be used by the
+     * compiler. See @ref HS_COMPILE_OPT.
+     */
+    unsigned long long flags;
+
+    /**
+     * The number of threads to compile with. Independent parts of the
+     * compile, such as parsing each expression and building the engines for
+     * different parts of the pattern set, are spread across these threads, of
+     * which the calling thread is always one. Zero compiles on the calling
+     * thread only, as does one, and @ref HS_COMPILE_THREADS_ALL uses one
+     * thread per hardware thread on the host. The compiled database does not
+     * depend on the number of threads used. To use this parameter, set the
+     * @ref HS_COMPILE_OPT_THREADS flag in the hs_compile_options::flags field.
+     */
+    unsigned int threads;
+
+    /**
+     * A traffic profile to tune the database for. The literal matchers in the
+     * database are built to minimise the work expected on traffic resembling
+     * the profile, rather than on uniformly random data: literals that are
+     * common in the traffic are kept apart from each other, and the matcher
+     * type and table layout are chosen by their modelled cost on the traffic.
+     * Matching results do not depend on the profile, only scanning
+     * performance does. The profile is not retained after the compile call,
+     * and a profile without any byte pairs is rejected. To use this
+     * parameter, set the @ref HS_COMPILE_OPT_TRAFFIC flag in the
+     * hs_compile_options::flags field.
+     */
+    const hs_traffic_t *traffic;
+
+    /**
+     * A directory holding an on-disk cache of compiled databases. Before
+     * compiling, the compiler looks in this directory for a database
+     * previously compiled from exactly the same inputs: the library version,
+     * the expressions with their flags, ids and extended parameters, the
+     * mode, the target platform and the traffic profile, if any. If one
+     * is found it is deserialized and returned without compiling; otherwise
+     * the database is compiled and written to the cache for subsequent calls.
+     * The other options are not part of the key, as the compiled database
+     * does not depend on them.
+     *
+     * Writing to the cache is best effort: if the directory does not exist or
+     * cannot be written, the compiled database is still returned. Cache files
+     * are written atomically, so a cache directory may be shared between
+     * processes. When no platform is given, the key includes the features of
+     * the current host, so a cache shared between different machines will not
+     * return a database tuned for another host. To use this parameter, set
+     * the @ref HS_COMPILE_OPT_CACHE_DIR flag in the hs_compile_options::flags
+     * field.
+     */
+    const char *cache_dir;
+} hs_compile_options_t;
+
+/**
+ * @defgroup HS_COMPILE_OPT hs_compile_options_t flags
+ *
+ * These flags are used in @ref hs_compile_options_t::flags to indicate which
+ * fields are used.
+ *
+ * @{
+ */
+
+/** Flag indicating that the hs_compile_options::threads field is used. */
+#define HS_COMPILE_OPT_THREADS      1ULL
+
+/** Flag indicating that the hs_compile_options::traffic field is used. */
+#define HS_COMPILE_OPT_TRAFFIC      2ULL
+
+/** Flag indicating that the hs_compile_options::cache_dir field is used. */
+#define HS_COMPILE_OPT_CACHE_DIR    4ULL
+
+/** @} */
+
+/**
+ * Value for @ref hs_compile_options_t::threads requesting one compile thread
+ * per hardware thread on the host.
+ */
+#define HS_COMPILE_THREADS_ALL 0xffffffffU
+
 /**
  * A type containing information related to an expression that is returned by
  * @ref hs_expression_info() or @ref hs_expression_ext_info.
@@ -539,6 +646,75 @@ hs_error_t HS_CDECL hs_compile_ext_multi(const char *const *expressions,
                                 const hs_platform_info_t *platform,
                                 hs_database_t **db, hs_compile_error_t **error);
 
+/**
+ * The multiple regular expression compiler with extended parameter support
+ * and compile options.
+ *
+ * This function behaves in the same way as @ref hs_compile_ext_multi(), but
+ * applies the given @p options, such as the number of threads to compile
+ * with, a traffic profile to tune the database for or a directory to cache
+ * compiled databases in. It can stand in for @ref hs_compile() and @ref
+ * hs_compile_multi() as well, as both are special cases of @ref
+ * hs_compile_ext_multi().
+ *
+ * @param expressions
+ *      Array of NULL-terminated expressions to compile, as for @ref
+ *      hs_compile_ext_multi().
+ *
+ * @param flags
+ *      Array of flags which modify the behaviour of each expression, as for
+ *      @ref hs_compile_ext_multi().
+ *
+ * @param ids
+ *      An array of integers specifying the ID number to be associated with the
+ *      corresponding pattern in the expressions array, as for @ref
+ *      hs_compile_ext_multi().
+ *
+ * @param ext
+ *      An array of pointers to filled @ref hs_expr_ext_t structures, as for
+ *      @ref hs_compile_ext_multi().
+ *
+ * @param elements
+ *      The number of elements in the input arrays.
+ *
+ * @param mode
+ *      Compiler mode flags that affect the database as a whole, as for @ref
+ *      hs_compile_ext_multi().
+ *
+ * @param platform
+ *      If not NULL, the platform structure is used to determine the target
+ *      platform for the database. If NULL, a database suitable for running
+ *      on the current host platform is produced.
+ *
+ * @param options
+ *      The options for this compile, or NULL for the defaults. They are not
+ *      retained after this call.
+ *
+ * @param db
+ *      On success, a pointer to the generated database will be returned in
+ *      this parameter, or NULL on failure. The caller is responsible for
+ *      deallocating the buffer using the @ref hs_free_database() function.
+ *
+ * @param error
+ *      If the compile fails, a pointer to a @ref hs_compile_error_t will be
+ *      returned, providing details of the error condition. The caller is
+ *      responsible for deallocating the buffer using the @ref
+ *      hs_free_compile_error() function.
+ *
+ * @return
+ *      @ref HS_SUCCESS is returned on successful compilation or cache load;
+ *      @ref HS_COMPILER_ERROR on failure, with details provided in the error
+ *      parameter.
+ */
+hs_error_t HS_CDECL hs_compile_ext_multi_opts(const char *const *expressions,
+                                const unsigned int *flags,
+                                const unsigned int *ids,
+                                const hs_expr_ext_t *const *ext,
+                                unsigned int elements, unsigned int mode,
+                                const hs_platform_info_t *platform,
+                                const hs_compile_options_t *options,
+                                hs_database_t **db, hs_compile_error_t **error);
+
 /**
  * The basic pure literal expression compiler.
  *
@@ -696,6 +872,72 @@ hs_error_t HS_CDECL hs_compile_lit_multi(const char * const *expressions,
                                          hs_database_t **db,
                                          hs_compile_error_t **error);
 
+/**
+ * The multiple pure literal expression compiler with compile options.
+ *
+ * This function behaves in the same way as @ref hs_compile_lit_multi(), but
+ * applies the given @p options, such as the number of threads to compile
+ * with, a traffic profile to tune the database for or a directory to cache
+ * compiled databases in. It can stand in for @ref hs_compile_lit() as well.
+ *
+ * @param expressions
+ *      Array of pure literal expressions, as for @ref hs_compile_lit_multi().
+ *
+ * @param flags
+ *      Array of flags which modify the behaviour of each expression, as for
+ *      @ref hs_compile_lit_multi().
+ *
+ * @param ids
+ *      An array of integers specifying the ID number to be associated with the
+ *      corresponding pattern in the expressions array, as for @ref
+ *      hs_compile_lit_multi().
+ *
+ * @param lens
+ *      Array of lengths of the text content of each pure literal expression,
+ *      as for @ref hs_compile_lit_multi().
+ *
+ * @param elements
+ *      The number of elements in the input arrays.
+ *
+ * @param mode
+ *      Compiler mode flags that affect the database as a whole, as for @ref
+ *      hs_compile_lit_multi().
+ *
+ * @param platform
+ *      If not NULL, the platform structure is used to determine the target
+ *      platform for the database. If NULL, a database suitable for running
+ *      on the current host platform is produced.
+ *
+ * @param options
+ *      The options for this compile, or NULL for the defaults, as for @ref
+ *      hs_compile_ext_multi_opts().
+ *
+ * @param db
+ *      On success, a pointer to the generated database will be returned in
+ *      this parameter, or NULL on failure. The caller is responsible for
+ *      deallocating the buffer using the @ref hs_free_database() function.
+ *
+ * @param error
+ *      If the compile fails, a pointer to a @ref hs_compile_error_t will be
+ *      returned, providing details of the error condition. The caller is
+ *      responsible for deallocating the buffer using the @ref
+ *      hs_free_compile_error() function.
+ *
+ * @return
+ *      @ref HS_SUCCESS is returned on successful compilation or cache load;
+ *      @ref HS_COMPILER_ERROR on failure, with details provided in the error
+ *      parameter.
+ */
+hs_error_t HS_CDECL hs_compile_lit_multi_opts(const char * const *expressions,
+                                         const unsigned *flags,
+                                         const unsigned *ids,
+                                         const size_t *lens,
+                                         unsigned elements, unsigned mode,
+                                         const hs_platform_info_t *platform,
+                                         const hs_compile_options_t *options,
+                                         hs_database_t **db,
+                                         hs_compile_error_t **error);
+
 /**
  * Free an error structure generated by @ref hs_compile(), @ref
  * hs_compile_multi() or @ref hs_compile_ext_multi().
@@ -853,6 +1095,48 @@ hs_error_t HS_CDECL hs_expression_ext_info(const char *expression,
  */
 hs_error_t HS_CDECL hs_populate_platform(hs_platform_info_t *platform);
 
+/**
+ * Allocates an empty traffic profile.
+ *
+ * @param traffic
+ *      On success, a pointer to the new profile is returned in this
+ *      parameter. The caller is responsible for freeing it with @ref
+ *      hs_free_traffic().
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, other values on failure.
+ */
+hs_error_t HS_CDECL hs_alloc_traffic(hs_traffic_t **traffic);
+
+/**
+ * Adds the byte pairs in a block of sample traffic to a traffic profile.
+ *
+ * @param traffic
+ *      The profile to update.
+ *
+ * @param data
+ *      The sample data. Pairs are not counted across separate calls.
+ *
+ * @param length
+ *      The length of the sample data in bytes.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, other values on failure.
+ */
+hs_error_t HS_CDECL hs_traffic_add(hs_traffic_t *traffic, const char *data,
+                                   size_t length);
+
+/**
+ * Frees a traffic profile allocated with @ref hs_alloc_traffic().
+ *
+ * @param traffic
+ *      The profile to free. A NULL pointer is ignored.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, other values on failure.
+ */
+hs_error_t HS_CDECL hs_free_traffic(hs_traffic_t *traffic);
+
 /**
  * @defgroup HS_PATTERN_FLAG Pattern flags
  *
@@ -1209,6 +1493,35 @@ hs_error_t HS_CDECL hs_populate_platform(hs_platform_info_t *platform);
  */
 #define HS_MODE_SOM_HORIZON_SMALL   (1U << 26)
 
+/**
+ * Compiler mode flag: existence-only block mode database.
+ *
+ * The database only answers whether any pattern matches. No match callbacks
+ * are made: scanning stops at the first match and @ref hs_scan() returns @ref
+ * HS_SCAN_TERMINATED, or @ref HS_SUCCESS if nothing matched. As matches need
+ * not be delivered in order or without duplicates, the runtime can skip the
+ * work it would otherwise do to guarantee this.
+ *
+ * This flag may only be used with @ref HS_MODE_BLOCK, and may not be combined
+ * with @ref HS_MODE_COUNT or with the @ref HS_FLAG_COMBINATION expression flag.
+ */
+#define HS_MODE_EXISTENCE           (1U << 27)
+
+/**
+ * Compiler mode flag: count-only block mode database.
+ *
+ * The database counts matches per expression rather than delivering them to a
+ * callback. It must be scanned with @ref hs_scan_count(), which produces
+ * the same counts as a callback counting the matches raised by @ref hs_scan()
+ * would, but without the cost of the callback or of ordering matches.
+ *
+ * This flag may only be used with @ref HS_MODE_BLOCK, and may not be combined
+ * with @ref HS_MODE_EXISTENCE, with the @ref HS_FLAG_SOM_LEFTMOST or @ref
+ * HS_FLAG_COMBINATION expression flags, or with a non-zero min_length
+ * extended parameter (see @ref HS_EXT_FLAG_MIN_LENGTH).
+ */
+#define HS_MODE_COUNT               (1U << 28)
+
 /** @} */
 
 #ifdef __cplusplus
@@ -43,17 +43,18 @@ namespace ue2 {
 struct Grey;
 
 /** \brief Internal use only: takes a Grey argument so that we can use it in
- * tools. */
+ * tools, and optional compile options. */
 hs_error_t hs_compile_multi_int(const char *const *expressions,
                                 const unsigned *flags, const unsigned *ids,
                                 const hs_expr_ext *const *ext,
                                 unsigned elements, unsigned mode,
                                 const hs_platform_info_t *platform,
                                 hs_database_t **db,
-                                hs_compile_error_t **comp_error, const Grey &g);
+                                hs_compile_error_t **comp_error, const Grey &g,
+                                const hs_compile_options_t *options = nullptr);
 
 /** \brief Internal use only: takes a Grey argument so that we can use it in
- * tools. */
+ * tools, and optional compile options. */
 hs_error_t hs_compile_lit_multi_int(const char *const *expressions,
                                     const unsigned *flags, const unsigned *ids,
                                     const hs_expr_ext *const *ext,
@@ -62,7 +63,9 @@ hs_error_t hs_compile_lit_multi_int(const char *const *expressions,
                                     const hs_platform_info_t *platform,
                                     hs_database_t **db,
                                     hs_compile_error_t **comp_error,
-                                    const Grey &g);
+                                    const Grey &g,
+                                    const hs_compile_options_t *options =
+                                        nullptr);
 } // namespace ue2
 
 extern "C"
@@ -128,6 +128,173 @@ typedef int (HS_CDECL *match_event_handler)(unsigned int id,
                                             unsigned int flags,
                                             void *context);
 
+/**
+ * Definition of the match event callback function type used by the batched
+ * scanning functions, such as @ref hs_scan_stream_batch().
+ *
+ * This behaves exactly as a @ref match_event_handler, but is additionally
+ * supplied with the index of the batch entry (stream or data block) that
+ * produced the match.
+ *
+ * @param index
+ *      The index into the arrays supplied to the batched scanning function of
+ *      the entry being scanned when the match was raised.
+ *
+ * @param id
+ *      The ID number of the expression that matched.
+ *
+ * @param from
+ *      The start of match offset, if a start of match flag is enabled for the
+ *      current pattern; see @ref match_event_handler for details.
+ *
+ * @param to
+ *      The offset after the last byte that matches the expression.
+ *
+ * @param flags
+ *      This is provided for future use and is unused at present.
+ *
+ * @param context
+ *      The pointer supplied by the user to the batched scanning function.
+ *
+ * @return
+ *      Non-zero if the matching should cease for the entry given by @p index,
+ *      else zero.
+ */
+typedef int (HS_CDECL *match_batch_event_handler)(unsigned int index,
+                                                  unsigned int id,
+                                                  unsigned long long from,
+                                                  unsigned long long to,
+                                                  unsigned int flags,
+                                                  void *context);
+
+/**
+ * A match record, as written to the caller's array by @ref hs_scan_matches().
+ */
+typedef struct hs_match {
+    /**
+     * The ID number of the expression that matched.
+     */
+    unsigned int id;
+
+    /**
+     * The start of match offset, if a start of match flag is enabled for the
+     * matching pattern; see @ref match_event_handler for details. Zero
+     * otherwise.
+     */
+    unsigned long long from;
+
+    /**
+     * The offset after the last byte that matches the expression.
+     */
+    unsigned long long to;
+} hs_match_t;
+
+/**
+ * Definition of a task, as handed to an @ref hs_executor_t by @ref
+ * hs_scan_parallel().
+ *
+ * @param context
+ *      The task context pointer supplied to the executor.
+ *
+ * @param index
+ *      The index of the task to run, from zero up to the task count supplied
+ *      to the executor.
+ */
+typedef void (HS_CDECL *hs_task_t)(void *context, unsigned int index);
+
+/**
+ * Definition of a caller-supplied executor, used by @ref hs_scan_parallel() to
+ * run its tasks on the caller's threads.
+ *
+ * The executor must call @p task once for each index from zero to @p count - 1
+ * (with @p task_context as its context pointer), and must return only once all
+ * of these calls have completed. The calls may be made concurrently from
+ * different threads and in any order.
+ *
+ * @param task
+ *      The task function to run.
+ *
+ * @param task_context
+ *      The context pointer to supply to each call to @p task.
+ *
+ * @param count
+ *      The number of tasks to run.
+ *
+ * @param context
+ *      The executor context pointer supplied to @ref hs_scan_parallel().
+ */
+typedef void (HS_CDECL *hs_executor_t)(hs_task_t task, void *task_context,
+                                       unsigned int count, void *context);
+
+/**
+ * Runtime statistics, accumulated by scans that use a scratch space registered
+ * with @ref hs_set_scan_stats().
+ *
+ * These counters describe the work done inside the matcher and are intended
+ * for tuning pattern sets; their exact values depend on the engines chosen at
+ * compile time and may change between releases.
+ */
+typedef struct hs_scan_stats {
+    /**
+     * The number of blocks scanned. Each stream write and each block of a
+     * vectored scan counts separately.
+     */
+    unsigned long long scans;
+
+    /** The number of bytes of data scanned. */
+    unsigned long long bytes_scanned;
+
+    /** The number of bytes skipped by acceleration in the literal matcher. */
+    unsigned long long literal_accel_skipped;
+
+    /** The number of bytes skipped by acceleration in automata engines. */
+    unsigned long long engine_accel_skipped;
+
+    /**
+     * The number of candidate positions checked by the literal matchers'
+     * confirm step.
+     */
+    unsigned long long literal_confirms;
+
+    /** The number of literal matches raised by the literal matchers. */
+    unsigned long long literal_matches;
+
+    /** The number of match program instructions executed. */
+    unsigned long long program_instructions;
+
+    /** The number of times an engine was run to catch up with a match. */
+    unsigned long long catchup_engine_runs;
+
+    /** The number of literal matches delayed for later processing. */
+    unsigned long long delayed_literals;
+
+    /** The number of matches reported to the user. */
+    unsigned long long reports;
+} hs_scan_stats_t;
+
+/**
+ * A scan cost profile, allocated by @ref hs_alloc_scan_profile() and
+ * registered with a scratch space by @ref hs_set_scan_profile().
+ *
+ * The contents of this structure are internal to the library.
+ */
+typedef struct hs_scan_profile hs_scan_profile_t;
+
+/**
+ * The scan time attributed to one expression by @ref hs_scan_profile_costs().
+ */
+typedef struct hs_expression_cost {
+    /** The expression ID given at compile time. */
+    unsigned int id;
+
+    /**
+     * The number of timer ticks attributed to the expression. On x86 these
+     * are timestamp counter cycles; on other platforms the unit is that of
+     * the platform's fastest monotonic counter.
+     */
+    unsigned long long ticks;
+} hs_expression_cost_t;
+
 /**
  * Open and initialise a stream.
  *
@@ -190,6 +357,70 @@ hs_error_t HS_CDECL hs_scan_stream(hs_stream_t *id, const char *data,
                                    hs_scratch_t *scratch,
                                    match_event_handler onEvent, void *ctxt);
 
+/**
+ * Write data to a number of opened streams in a single call.
+ *
+ * This is equivalent to calling @ref hs_scan_stream() for each entry in turn,
+ * writing @p data[i] to stream @p ids[i], but with the per-call argument and
+ * scratch checks performed once for the whole batch. The state of the next
+ * stream is prefetched while the current one is being scanned, which makes
+ * this call well suited to workloads with many streams receiving small
+ * writes.
+ *
+ * The streams need not have been opened against the same database, but the
+ * scratch space must be suitable for all of them. The same stream may appear
+ * more than once in a batch, in which case the writes are applied in array
+ * order.
+ *
+ * If the match callback requests that matching should cease, only the stream
+ * that raised the match is terminated (as with @ref hs_scan_stream()) and
+ * scanning continues with the next entry in the batch. Any other error halts
+ * the batch immediately; entries before the failing one will have been
+ * scanned.
+ *
+ * @param ids
+ *      An array of stream IDs (returned by @ref hs_open_stream()) to which the
+ *      data will be written.
+ *
+ * @param data
+ *      An array of pointers to the data to be written to each stream.
+ *
+ * @param length
+ *      An array of lengths (in bytes) of each data block to scan.
+ *
+ * @param count
+ *      Number of entries in the batch. This should correspond to the size of
+ *      the @p ids, @p data and @p length arrays.
+ *
+ * @param flags
+ *      Flags modifying the behaviour of the stream. This parameter is provided
+ *      for future use and is unused at present.
+ *
+ * @param scratch
+ *      A per-thread scratch space allocated by @ref hs_alloc_scratch().
+ *
+ * @param onEvent
+ *      Pointer to a match event callback function, which will be supplied the
+ *      index of the entry that raised each match. If a NULL pointer is given,
+ *      no matches will be returned.
+ *
+ * @param ctxt
+ *      The user defined pointer which will be passed to the callback function
+ *      when a match occurs.
+ *
+ * @return
+ *      Returns @ref HS_SUCCESS on success; @ref HS_SCAN_TERMINATED if any of
+ *      the streams in the batch has been terminated by the match callback;
+ *      other values on error.
+ */
+hs_error_t HS_CDECL hs_scan_stream_batch(hs_stream_t *const *ids,
+                                         const char *const *data,
+                                         const unsigned int *length,
+                                         unsigned int count, unsigned int flags,
+                                         hs_scratch_t *scratch,
+                                         match_batch_event_handler onEvent,
+                                         void *ctxt);
+
 /**
  * Close a stream.
  *
@@ -481,6 +712,192 @@ hs_error_t HS_CDECL hs_scan(const hs_database_t *db, const char *data,
                             hs_scratch_t *scratch, match_event_handler onEvent,
                             void *context);
 
+/**
+ * The parallel block (non-streaming) regular expression scanner.
+ *
+ * This scans a single large block of data using several threads. The block
+ * is split into chunks, one per scratch space supplied, which overlap by the
+ * maximum width of a match in the database. The chunks are scanned by the
+ * caller's @p executor, and their matches are then merged and delivered to @p
+ * onEvent on the calling thread, exactly as @ref hs_scan() would deliver
+ * them.
+ *
+ * A block can only be split if every pattern in the database has a bounded
+ * match width (see the max_width field reported by @ref hs_expression_info())
+ * and the database uses no logical combinations, @ref HS_FLAG_SINGLEMATCH, or
+ * min_offset or max_offset extended parameters. For other databases, and for
+ * blocks too short to be worth splitting, the block is scanned on the calling
+ * thread with the first scratch space.
+ *
+ * Matches are buffered in memory obtained from the misc allocator (see @ref
+ * hs_set_misc_allocator()) until all chunks have been scanned.
+ *
+ * @param db
+ *      A compiled pattern database.
+ *
+ * @param data
+ *      Pointer to the data to be scanned.
+ *
+ * @param length
+ *      The number of bytes to scan.
+ *
+ * @param flags
+ *      Flags modifying the behaviour of this function. This parameter is
+ *      provided for future use and is unused at present.
+ *
+ * @param scratch
+ *      An array of distinct scratch spaces allocated for this database, for
+ *      example with @ref hs_clone_scratch(). One chunk is scanned with each.
+ *
+ * @param count
+ *      The number of scratch spaces in the @p scratch array, which is the
+ *      maximum number of chunks the block will be split into.
+ *
+ * @param executor
+ *      The executor used to scan the chunks. If a NULL pointer is given, the
+ *      chunks are scanned in turn on the calling thread.
+ *
+ * @param executor_context
+ *      The context pointer passed to @p executor.
+ *
+ * @param onEvent
+ *      Pointer to a match event callback function. If a NULL pointer is given,
+ *      no matches will be returned.
+ *
+ * @param context
+ *      The user defined pointer which will be passed to the callback function.
+ *
+ * @return
+ *      Returns @ref HS_SUCCESS on success; @ref HS_SCAN_TERMINATED if the
+ *      match callback indicated that scanning should stop; @ref HS_NOMEM if
+ *      the matches could not be buffered; other values on error.
+ */
+hs_error_t HS_CDECL hs_scan_parallel(const hs_database_t *db, const char *data,
+                                     unsigned int length, unsigned int flags,
+                                     hs_scratch_t *const *scratch,
+                                     unsigned int count,
+                                     hs_executor_t executor,
+                                     void *executor_context,
+                                     match_event_handler onEvent,
+                                     void *context);
+
+/**
+ * The block (non-streaming) regular expression scanner, writing matches to
+ * an array.
+ *
+ * This behaves as @ref hs_scan(), except that rather than invoking a callback
+ * for each match, the matches are written in order to the caller-supplied @p
+ * matches array. This is useful for applications that process matches in
+ * bulk, such as those that only aggregate match counts.
+ *
+ * If the array fills up before the scan is complete, @ref
+ * HS_INSUFFICIENT_SPACE is returned and the array holds the first @p capacity
+ * matches. If @p total is not NULL, the scan then carries on to the end of the
+ * block, counting the matches it cannot write, so that the caller can
+ * allocate an array large enough for all of them and scan the block once
+ * more. Otherwise, scanning stops as soon as the array is full.
+ *
+ * @param db
+ *      A compiled pattern database.
+ *
+ * @param data
+ *      Pointer to the data to be scanned.
+ *
+ * @param length
+ *      The number of bytes to scan.
+ *
+ * @param flags
+ *      Flags modifying the behaviour of this function. This parameter is
+ *      provided for future use and is unused at present.
+ *
+ * @param scratch
+ *      A per-thread scratch space allocated by @ref hs_alloc_scratch() for this
+ *      database.
+ *
+ * @param matches
+ *      The array that matches will be written to. This is allowed to be NULL
+ *      only if @p capacity is zero, in which case the return value simply
+ *      indicates whether the block contains any match (and @p total, if
+ *      given, how many).
+ *
+ * @param capacity
+ *      The number of records in the @p matches array.
+ *
+ * @param count
+ *      On return, the number of matches written to the @p matches array.
+ *
+ * @param total
+ *      If not NULL, on return the total number of matches in the block,
+ *      including any that did not fit in the @p matches array. A call with a
+ *      @p capacity of zero can be used to size the array for a subsequent
+ *      scan.
+ *
+ * @return
+ *      Returns @ref HS_SUCCESS if all matches have been written to the array;
+ *      @ref HS_INSUFFICIENT_SPACE if there were more matches than the array
+ *      could hold; other values on error.
+ */
+hs_error_t HS_CDECL hs_scan_matches(const hs_database_t *db, const char *data,
+                                    unsigned int length, unsigned int flags,
+                                    hs_scratch_t *scratch, hs_match_t *matches,
+                                    unsigned int capacity, unsigned int *count,
+                                    unsigned long long *total);
+
+/**
+ * The block (non-streaming) regular expression scanner for count-only
+ * databases.
+ *
+ * This is the scan function for databases compiled with the @ref
+ * HS_MODE_COUNT mode flag. Rather than invoking a callback for each match, it
+ * counts the matches for each expression. The counts are those that a
+ * callback passed to @ref hs_scan() would have seen for a database compiled
+ * without @ref HS_MODE_COUNT.
+ *
+ * Counts are indexed by the position of the expression in the array passed
+ * to the compiler, not by its id, so the size of the count array does not
+ * depend on the ids used. If several expressions share an id, all of their
+ * matches are counted against the first of them, and the entries for the
+ * others are zero.
+ *
+ * @param db
+ *      A compiled pattern database, which must have been compiled with @ref
+ *      HS_MODE_COUNT.
+ *
+ * @param data
+ *      Pointer to the data to be scanned.
+ *
+ * @param length
+ *      The number of bytes to scan.
+ *
+ * @param flags
+ *      Flags modifying the behaviour of this function. This parameter is
+ *      provided for future use and is unused at present.
+ *
+ * @param scratch
+ *      A per-thread scratch space allocated by @ref hs_alloc_scratch() for this
+ *      database.
+ *
+ * @param counts
+ *      An array of match counts indexed by expression index. On return, the
+ *      first @p capacity entries hold the number of matches for each
+ *      expression.
+ *
+ * @param capacity
+ *      The number of entries in the @p counts array. An array with one entry
+ *      for each expression compiled into the database is always large
+ *      enough.
+ *
+ * @return
+ *      Returns @ref HS_SUCCESS on success; @ref HS_INSUFFICIENT_SPACE if the
+ *      @p counts array is too small; @ref HS_DB_MODE_ERROR if the database was
+ *      not compiled with @ref HS_MODE_COUNT; other values on error.
+ */
+hs_error_t HS_CDECL hs_scan_count(const hs_database_t *db, const char *data,
+                                  unsigned int length, unsigned int flags,
+                                  hs_scratch_t *scratch,
+                                  unsigned long long *counts,
+                                  unsigned int capacity);
+
 /**
  * The vectored regular expression scanner.
  *
@@ -608,6 +1025,137 @@ hs_error_t HS_CDECL hs_scratch_size(const hs_scratch_t *scratch,
  */
 hs_error_t HS_CDECL hs_free_scratch(hs_scratch_t *scratch);
 
+/**
+ * Registers a statistics structure to be updated by scans that use the given
+ * scratch space.
+ *
+ * Each scan made with @p scratch adds its counts to the fields of @p stats,
+ * which the caller should zero before use. The structure must remain valid
+ * until it is unregistered by passing NULL, or the scratch is freed. Scratch
+ * spaces created by @ref hs_clone_scratch() start with no statistics
+ * registered; reallocation by @ref hs_alloc_scratch() preserves the
+ * registration.
+ *
+ * For @ref hs_scan_parallel(), each chunk's work is counted in the statistics
+ * of the scratch space that scanned it.
+ *
+ * Statistics are only collected if the library was built with the
+ * `SCAN_STATS` option; otherwise, registering a structure fails and scans are
+ * unaffected.
+ *
+ * @param scratch
+ *      A per-thread scratch space allocated by @ref hs_alloc_scratch() or @ref
+ *      hs_clone_scratch().
+ *
+ * @param stats
+ *      The statistics structure to update, or NULL to stop collecting.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success; @ref HS_INVALID if the library was built
+ *      without statistics support and @p stats is not NULL. Other errors may
+ *      be returned if invalid parameters are specified.
+ */
+hs_error_t HS_CDECL hs_set_scan_stats(hs_scratch_t *scratch,
+                                      hs_scan_stats_t *stats);
+
+/**
+ * Allocate a scan cost profile for the given database.
+ *
+ * A profile attributes the time spent scanning to the expressions in the
+ * database: time spent in the match programs, automata engines and literal
+ * confirmation that serve an expression is charged to it. Work shared by
+ * several expressions is split evenly among them; time that cannot be tied to
+ * any expression, such as the literal matcher's main loop, is reported
+ * separately as unattributed.
+ *
+ * Profiling is only available if the library was built with the
+ * `SCAN_PROFILE` option, which adds a timer read to every program and engine
+ * invocation; it is intended for finding expensive patterns, not for
+ * production use.
+ *
+ * @param db
+ *      The compiled pattern database to be profiled.
+ *
+ * @param profile
+ *      On success, a pointer to the allocated profile, with all counts zero.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success; @ref HS_INVALID if the library or the
+ *      database was built without profiling support. Other errors may be
+ *      returned if invalid parameters are specified.
+ */
+hs_error_t HS_CDECL hs_alloc_scan_profile(const hs_database_t *db,
+                                          hs_scan_profile_t **profile);
+
+/**
+ * Registers a scan cost profile to be updated by scans that use the given
+ * scratch space.
+ *
+ * Only scans of the database the profile was allocated for are attributed
+ * to its expressions. A profile must not be registered with more than one
+ * scratch space at a time, and must remain valid until it is unregistered by
+ * passing NULL, or the scratch is freed. Scratch spaces created by @ref
+ * hs_clone_scratch() start with no profile registered.
+ *
+ * @param scratch
+ *      A per-thread scratch space allocated by @ref hs_alloc_scratch() or @ref
+ *      hs_clone_scratch().
+ *
+ * @param profile
+ *      The profile to update, or NULL to stop profiling.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success; @ref HS_INVALID if the library was built
+ *      without profiling support and @p profile is not NULL. Other errors may
+ *      be returned if invalid parameters are specified.
+ */
+hs_error_t HS_CDECL hs_set_scan_profile(hs_scratch_t *scratch,
+                                        hs_scan_profile_t *profile);
+
+/**
+ * Retrieve the per-expression costs gathered by a scan cost profile, most
+ * expensive first.
+ *
+ * @param profile
+ *      A profile allocated by @ref hs_alloc_scan_profile().
+ *
+ * @param costs
+ *      An array of @p capacity entries to receive the costs of the most
+ *      expensive expressions. May be NULL if @p capacity is zero.
+ *
+ * @param capacity
+ *      The number of entries in @p costs.
+ *
+ * @param count
+ *      On success, the number of entries written to @p costs. May be NULL.
+ *
+ * @param unattributed
+ *      On success, the number of ticks not attributed to any expression. May
+ *      be NULL.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, other values on failure.
+ */
+hs_error_t HS_CDECL hs_scan_profile_costs(const hs_scan_profile_t *profile,
+                                          hs_expression_cost_t *costs,
+                                          unsigned int capacity,
+                                          unsigned int *count,
+                                          unsigned long long *unattributed);
+
+/**
+ * Free a scan cost profile previously allocated by @ref
+ * hs_alloc_scan_profile().
+ *
+ * The profile must not be registered with any scratch space.
+ *
+ * @param profile
+ *      The profile to be freed. NULL may also be safely provided.
+ *
+ * @return
+ *      @ref HS_SUCCESS on success, other values on failure.
+ */
+hs_error_t HS_CDECL hs_free_scan_profile(hs_scan_profile_t *profile);
+
 /**
  * Callback 'from' return value, indicating that the start of this match was
  * too early to be tracked with the requested SOM_HORIZON precision.
@@ -33,6 +33,7 @@
 #include "hwlm.h"
 #include "hwlm_internal.h"
 #include "noodle_engine.h"
+#include "scan_stats.h"
 #include "scratch.h"
 #include "ue2common.h"
 #include "fdr/fdr.h"
@@ -193,13 +194,22 @@ hwlm_error_t hwlmExec(const struct HWLM *t, const u8 *buf, size_t len,
         return noodExec(HWLM_C_DATA(t), buf, len, start, cb, scratch);
     }
 
+    if (t->type == HWLM_ENGINE_NOOD_MULTI) {
+        DEBUG_PRINTF("calling noodMultiExec\n");
+        return noodMultiExec(HWLM_C_DATA(t), buf, len, start, cb, scratch,
+                             groups);
+    }
+
     assert(t->type == HWLM_ENGINE_FDR);
     const union AccelAux *aa = &t->accel0;
     if ((groups & ~t->accel1_groups) == 0) {
         DEBUG_PRINTF("using hq accel %hhu\n", t->accel1.accel_type);
         aa = &t->accel1;
     }
+    UNUSED const size_t accel_start = start;
     do_accel_block(aa, buf, len, &start);
+    SCAN_STAT_ADD(literal_accel_skipped,
+                  start > accel_start ? start - accel_start : 0);
     DEBUG_PRINTF("calling frankie (groups=%08llx, start=%zu)\n", groups, start);
     return fdrExec(HWLM_C_DATA(t), buf, len, start, cb, scratch, groups);
 }
@@ -235,13 +245,27 @@ hwlm_error_t hwlmExecStreaming(const struct HWLM *t, size_t len, size_t start,
         }
     }
 
+    if (t->type == HWLM_ENGINE_NOOD_MULTI) {
+        DEBUG_PRINTF("calling noodMultiExec\n");
+        if (start) {
+            return noodMultiExec(HWLM_C_DATA(t), buf, len, start, cb, scratch,
+                                 groups);
+        } else {
+            return noodMultiExecStreaming(HWLM_C_DATA(t), hbuf, hlen, buf, len,
+                                          cb, scratch, groups);
+        }
+    }
+
     assert(t->type == HWLM_ENGINE_FDR);
     const union AccelAux *aa = &t->accel0;
     if ((groups & ~t->accel1_groups) == 0) {
         DEBUG_PRINTF("using hq accel %hhu\n", t->accel1.accel_type);
         aa = &t->accel1;
     }
+    UNUSED const size_t accel_start = start;
     do_accel_streaming(aa, hbuf, hlen, buf, len, &start);
+    SCAN_STAT_ADD(literal_accel_skipped,
+                  start > accel_start ? start - accel_start : 0);
     DEBUG_PRINTF("calling frankie (groups=%08llx, start=%zu)\n", groups, start);
     return fdrExecStreaming(HWLM_C_DATA(t), hbuf, hlen, buf, len, start, cb,
                             scratch, groups);
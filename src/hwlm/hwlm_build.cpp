@@ -38,6 +38,7 @@
 #include "hwlm_literal.h"
 #include "noodle_engine.h"
 #include "noodle_build.h"
+#include "noodle_internal.h"
 #include "scratch.h"
 #include "ue2common.h"
 #include "fdr/fdr_compile.h"
@@ -48,6 +49,7 @@
 #include "util/compile_error.h"
 #include "util/ue2string.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <vector>
@@ -117,6 +119,24 @@ bool isNoodleable(const vector<hwlmLiteral> &lits,
     return true;
 }
 
+static
+bool isMultiNoodleable(const vector<hwlmLiteral> &lits,
+                       const CompileContext &cc) {
+    if (!cc.grey.allowNoodle) {
+        return false;
+    }
+
+    const size_t max_lits = min(size_t{cc.grey.noodleMaxLiterals},
+                                size_t{NOOD_MULTI_MAX});
+    if (lits.size() < 2 || lits.size() > max_lits) {
+        DEBUG_PRINTF("%zu literals, not suitable for multi noodle\n",
+                     lits.size());
+        return false;
+    }
+
+    return true;
+}
+
 bytecode_ptr<HWLM> hwlmBuild(const HWLMProto &proto, const CompileContext &cc,
                              UNUSED hwlm_group_t expected_groups) {
     size_t engSize = 0;
@@ -133,6 +153,13 @@ bytecode_ptr<HWLM> hwlmBuild(const HWLMProto &proto, const CompileContext &cc,
             engSize = noodle.size();
         }
         eng = std::move(noodle);
+    } else if (proto.engType == HWLM_ENGINE_NOOD_MULTI) {
+        DEBUG_PRINTF("build multi noodle table\n");
+        auto noodle = noodBuildMultiTable(lits);
+        if (noodle) {
+            engSize = noodle.size();
+        }
+        eng = std::move(noodle);
     } else {
         DEBUG_PRINTF("building a new deal\n");
         auto fdr = fdrBuildTable(proto, cc.grey);
@@ -201,10 +228,13 @@ hwlmBuildProto(vector<hwlmLiteral> &lits, bool make_small,
     if (isNoodleable(lits, cc)) {
         DEBUG_PRINTF("build noodle table\n");
         proto = std::make_unique<HWLMProto>(HWLM_ENGINE_NOOD, lits);
+    } else if (isMultiNoodleable(lits, cc)) {
+        DEBUG_PRINTF("build multi noodle table\n");
+        proto = std::make_unique<HWLMProto>(HWLM_ENGINE_NOOD_MULTI, lits);
     } else {
         DEBUG_PRINTF("building a new deal\n");
         proto = fdrBuildProto(HWLM_ENGINE_FDR, lits, make_small,
-                              cc.target_info, cc.grey);
+                              cc.target_info, cc.grey, cc.traffic.get());
         if (!proto) {
             return nullptr;
         }
@@ -220,6 +250,9 @@ size_t hwlmSize(const HWLM *h) {
     case HWLM_ENGINE_NOOD:
         engSize = noodSize((const noodTable *)HWLM_C_DATA(h));
         break;
+    case HWLM_ENGINE_NOOD_MULTI:
+        engSize = noodMultiSize((const noodMultiTable *)HWLM_C_DATA(h));
+        break;
     case HWLM_ENGINE_FDR:
         engSize = fdrSize((const FDR *)HWLM_C_DATA(h));
         break;
@@ -247,6 +280,12 @@ size_t hwlmFloodProneSuffixLen(size_t numLiterals, const CompileContext &cc) {
         return NO_LIMIT;
     }
 
+    if (cc.grey.allowNoodle && numLiterals <= cc.grey.noodleMaxLiterals &&
+        numLiterals <= NOOD_MULTI_MAX) {
+        DEBUG_PRINTF("multi noodle\n");
+        return NO_LIMIT;
+    }
+
     if (cc.grey.fdrAllowTeddy) {
         if (numLiterals <= 48) {
             DEBUG_PRINTF("teddy\n");
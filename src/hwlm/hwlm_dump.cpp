@@ -55,6 +55,9 @@ void hwlmGenerateDumpFiles(const HWLM *h, const string &base) {
     case HWLM_ENGINE_NOOD:
         noodPrintStats((const noodTable *)HWLM_C_DATA(h), f);
         break;
+    case HWLM_ENGINE_NOOD_MULTI:
+        noodMultiPrintStats((const noodMultiTable *)HWLM_C_DATA(h), f);
+        break;
     case HWLM_ENGINE_FDR:
         fdrPrintStats((const FDR *)HWLM_C_DATA(h), f);
         break;
@@ -43,10 +43,13 @@
 /** \brief Underlying engine is Noodle. */
 #define HWLM_ENGINE_NOOD    16
 
+/** \brief Underlying engine is Noodle over a handful of literals. */
+#define HWLM_ENGINE_NOOD_MULTI 17
+
 /** \brief Main Hamster Wheel Literal Matcher header. Followed by
  * engine-specific structure. */
 struct HWLM {
-    u8 type; /**< HWLM_ENGINE_NOOD or HWLM_ENGINE_FDR */
+    u8 type; /**< one of the HWLM_ENGINE_* values above */
     hwlm_group_t accel1_groups; /**< accelerable groups. */
     union AccelAux accel1; /**< used if group mask is subset of accel1_groups */
     union AccelAux accel0; /**< fallback accel scheme */
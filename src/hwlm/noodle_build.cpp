@@ -85,7 +85,8 @@ size_t findNoodFragOffset(const hwlmLiteral &lit) {
     return offset;
 }
 
-bytecode_ptr<noodTable> noodBuildTable(const hwlmLiteral &lit) {
+static
+void fillNoodTable(const hwlmLiteral &lit, size_t key_offset, noodTable *n) {
     const auto &s = lit.s;
 
     size_t mask_len = std::max(s.length(), lit.msk.size());
@@ -114,12 +115,6 @@ bytecode_ptr<noodTable> noodBuildTable(const hwlmLiteral &lit) {
                      ourisprint(c) ? (char)c : '.');
     }
 
-    auto n = make_zeroed_bytecode_ptr<noodTable>(sizeof(noodTable));
-    assert(n);
-    DEBUG_PRINTF("size of nood %zu\n", sizeof(noodTable));
-
-    size_t key_offset = findNoodFragOffset(lit);
-
     n->id = lit.id;
     n->single = s.length() == 1 ? 1 : 0;
     n->key_offset = verify_u8(s.length() - key_offset);
@@ -133,14 +128,51 @@ bytecode_ptr<noodTable> noodBuildTable(const hwlmLiteral &lit) {
     n->msk = make_u64a_mask(n_msk);
     n->cmp = make_u64a_mask(n_cmp);
     n->msk_len = mask_len;
+}
+
+bytecode_ptr<noodTable> noodBuildTable(const hwlmLiteral &lit) {
+    auto n = make_zeroed_bytecode_ptr<noodTable>(sizeof(noodTable));
+    assert(n);
+    DEBUG_PRINTF("size of nood %zu\n", sizeof(noodTable));
 
+    fillNoodTable(lit, findNoodFragOffset(lit), n.get());
     return n;
 }
 
+bytecode_ptr<noodMultiTable>
+noodBuildMultiTable(const vector<hwlmLiteral> &lits) {
+    assert(lits.size() > 1 && lits.size() <= NOOD_MULTI_MAX);
+
+    auto nm = make_zeroed_bytecode_ptr<noodMultiTable>(sizeof(noodMultiTable));
+    assert(nm);
+    DEBUG_PRINTF("size of multi nood %zu\n", sizeof(noodMultiTable));
+
+    nm->count = verify_u32(lits.size());
+    nm->min_len = 0xff;
+    for (u32 i = 0; i < nm->count; i++) {
+        const hwlmLiteral &lit = lits[i];
+        noodTable *n = &nm->lits[i];
+
+        // Key on the last two characters, so that every literal's candidates
+        // are at its end offset.
+        size_t len = lit.s.length();
+        fillNoodTable(lit, len > 1 ? len - 2 : 0, n);
+        nm->groups[i] = lit.groups;
+        nm->min_len = std::min(nm->min_len, n->msk_len);
+        nm->max_len = std::max(nm->max_len, n->msk_len);
+    }
+
+    return nm;
+}
+
 size_t noodSize(const noodTable *) {
     return sizeof(noodTable);
 }
 
+size_t noodMultiSize(const noodMultiTable *) {
+    return sizeof(noodMultiTable);
+}
+
 } // namespace ue2
 
 #ifdef DUMP_SUPPORT
@@ -166,6 +198,15 @@ void noodPrintStats(const noodTable *n, FILE *f) {
     fprintf(f, "\n");
 }
 
+void noodMultiPrintStats(const noodMultiTable *nm, FILE *f) {
+    fprintf(f, "Multi-literal Noodle table\n");
+    fprintf(f, "Literals: %u\n", nm->count);
+    for (u32 i = 0; i < nm->count; i++) {
+        fprintf(f, "\nLiteral %u, groups %016llx\n", i, nm->groups[i]);
+        noodPrintStats(&nm->lits[i], f);
+    }
+}
+
 } // namespace ue2
 
 #endif
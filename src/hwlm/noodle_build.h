@@ -36,7 +36,10 @@
 #include "ue2common.h"
 #include "util/bytecode_ptr.h"
 
+#include <vector>
+
 struct noodTable;
+struct noodMultiTable;
 
 namespace ue2 {
 
@@ -47,6 +50,12 @@ bytecode_ptr<noodTable> noodBuildTable(const hwlmLiteral &lit);
 
 size_t noodSize(const noodTable *n);
 
+/** \brief Construct a Noodle matcher for two to NOOD_MULTI_MAX literals. */
+bytecode_ptr<noodMultiTable>
+noodBuildMultiTable(const std::vector<hwlmLiteral> &lits);
+
+size_t noodMultiSize(const noodMultiTable *nm);
+
 } // namespace ue2
 
 #ifdef DUMP_SUPPORT
@@ -56,6 +65,7 @@ size_t noodSize(const noodTable *n);
 namespace ue2 {
 
 void noodPrintStats(const noodTable *n, FILE *f);
+void noodMultiPrintStats(const noodMultiTable *nm, FILE *f);
 
 } // namespace ue2
 
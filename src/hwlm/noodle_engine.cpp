@@ -79,6 +79,7 @@ hwlm_error_t final(const struct noodTable *n, const u8 *buf, UNUSED size_t len,
         goto match;
     }
     assert(len >= n->msk_len);
+    SCAN_STAT_ADD(literal_confirms, 1);
     v = partial_load_u64a(buf + pos + n->key_offset - n->msk_len, n->msk_len);
     DEBUG_PRINTF("v %016llx msk %016llx cmp %016llx\n", v, n->msk, n->cmp);
     if ((v & n->msk) != n->cmp) {
@@ -96,6 +97,48 @@ match:
     return HWLM_SUCCESS;
 }
 
+/** \brief State for a multi-literal Noodle scan.
+ *
+ * Every literal in the table is scanned for, as the callback may switch on
+ * groups that were off when the scan started. As in FDR, a literal is only
+ * reported if one of its groups is in the group set returned by the last
+ * callback. */
+struct multi_info {
+    const struct noodTable *lits[NOOD_MULTI_MAX]; //!< literals in the table
+    hwlm_group_t lit_groups[NOOD_MULTI_MAX]; //!< groups for each literal
+    u32 count; //!< number of entries in lits
+    size_t start; //!< matches must begin at or after this offset
+    hwlm_group_t groups; //!< groups currently on
+};
+
+// Confirm a candidate for literal i ending at end. Keys are always the last
+// characters of each literal, so the candidate position is the match end.
+static really_inline
+hwlm_error_t multiFinal(u32 i, const u8 *buf, size_t end,
+                        struct multi_info *mi, const struct cb_info *cbi) {
+    const struct noodTable *n = mi->lits[i];
+    if (!(mi->lit_groups[i] & mi->groups)) {
+        return HWLM_SUCCESS;
+    }
+    if (end + 1 < mi->start + n->msk_len) {
+        /* literal would begin before the start of the scan */
+        return HWLM_SUCCESS;
+    }
+    SCAN_STAT_ADD(literal_confirms, 1);
+    u64a v = partial_load_u64a(buf + end + 1 - n->msk_len, n->msk_len);
+    DEBUG_PRINTF("v %016llx msk %016llx cmp %016llx\n", v, n->msk, n->cmp);
+    if ((v & n->msk) != n->cmp) {
+        return HWLM_SUCCESS;
+    }
+
+    DEBUG_PRINTF("match for %u @ %zu\n", n->id, end);
+    mi->groups = cbi->cb(end, n->id, cbi->scratch);
+    if (mi->groups == HWLM_TERMINATE_MATCHING) {
+        return HWLM_TERMINATED;
+    }
+    return HWLM_SUCCESS;
+}
+
 #ifdef HAVE_SVE2
 #include "noodle_engine_sve.hpp"
 #else
@@ -189,3 +232,128 @@ hwlm_error_t noodExecStreaming(const struct noodTable *n, const u8 *hbuf,
     cbi.offsetAdj = 0;
     return scan(n, buf, len, 0, n->single, n->nocase, &cbi);
 }
+
+// Returns false if no literal is in a group that is on, in which case no
+// callback can switch any on and there is nothing to scan for.
+static really_inline
+bool initMultiInfo(const struct noodMultiTable *nm, hwlm_group_t groups,
+                   size_t start, struct multi_info *mi) {
+    hwlm_group_t live = 0;
+    mi->count = nm->count;
+    mi->start = start;
+    mi->groups = groups;
+    for (u32 i = 0; i < nm->count; i++) {
+        mi->lits[i] = &nm->lits[i];
+        mi->lit_groups[i] = nm->groups[i];
+        live |= nm->groups[i];
+    }
+    return live & groups;
+}
+
+// Scan for matches ending at first_end or later.
+static really_inline
+hwlm_error_t scanMultiFrom(const u8 *buf, size_t len, size_t first_end,
+                           struct multi_info *mi, const struct cb_info *cbi) {
+    if (first_end >= len) {
+        return HWLM_SUCCESS;
+    }
+
+    // The vector scans look at the byte before each end offset, so deal with
+    // an end at offset zero (only possible for one-byte literals) here.
+    if (!first_end) {
+        for (u32 i = 0; i < mi->count; i++) {
+            hwlm_error_t rv = multiFinal(i, buf, 0, mi, cbi);
+            RETURN_IF_TERMINATED(rv);
+        }
+        first_end = 1;
+        if (first_end == len) {
+            return HWLM_SUCCESS;
+        }
+    }
+
+    return scanMulti(buf, len, first_end, mi, cbi);
+}
+
+/** \brief Block-mode scanner for a multi-literal table. */
+hwlm_error_t noodMultiExec(const struct noodMultiTable *nm, const u8 *buf,
+                           size_t len, size_t start, HWLMCallback cb,
+                           struct hs_scratch *scratch, hwlm_group_t groups) {
+    assert(nm && buf);
+
+    struct multi_info mi;
+    if (!initMultiInfo(nm, groups, start, &mi)) {
+        DEBUG_PRINTF("no live literals\n");
+        return HWLM_SUCCESS;
+    }
+
+    struct cb_info cbi = {cb, 0, scratch, 0};
+    DEBUG_PRINTF("multi nood scan of %zu bytes for %u lits\n", len, mi.count);
+
+    return scanMultiFrom(buf, len, start + nm->min_len - 1, &mi, &cbi);
+}
+
+/** \brief Streaming-mode scanner for a multi-literal table. */
+hwlm_error_t noodMultiExecStreaming(const struct noodMultiTable *nm,
+                                    const u8 *hbuf, size_t hlen, const u8 *buf,
+                                    size_t len, HWLMCallback cb,
+                                    struct hs_scratch *scratch,
+                                    hwlm_group_t groups) {
+    assert(nm);
+
+    struct multi_info mi;
+    if (!initMultiInfo(nm, groups, 0, &mi)) {
+        DEBUG_PRINTF("no live literals\n");
+        return HWLM_SUCCESS;
+    }
+
+    struct cb_info cbi = {cb, 0, scratch, 0};
+    DEBUG_PRINTF("multi nood scan of %zu bytes (%zu hlen) for %u lits\n", len,
+                 hlen, mi.count);
+
+    size_t first_end = nm->min_len - 1;
+    if (hlen && nm->max_len > 1) {
+        /*
+         * As in noodExecStreaming, check the ends that need history against a
+         * short buffer stitched together from both. All literals are checked
+         * at each end here so that matches stay in order.
+         */
+        assert(hbuf);
+        u8 ALIGN_DIRECTIVE temp_buf[HWLM_LITERAL_MAX_LEN * 2];
+        memset(temp_buf, 0, sizeof(temp_buf));
+
+        size_t tl1 = MIN((size_t)nm->max_len - 1, hlen);
+        size_t tl2 = MIN((size_t)nm->max_len - 1, len);
+
+        assert(tl1 + tl2 <= sizeof(temp_buf));
+        assert(tl1 <= sizeof(u64a));
+        assert(tl2 <= sizeof(u64a));
+        DEBUG_PRINTF("using %zu bytes of hist and %zu bytes of buf\n", tl1, tl2);
+
+        unaligned_store_u64a(temp_buf,
+                             partial_load_u64a(hbuf + hlen - tl1, tl1));
+        unaligned_store_u64a(temp_buf + tl1, partial_load_u64a(buf, tl2));
+
+        for (size_t end = 0; end < tl2; end++) {
+            for (u32 i = 0; i < mi.count; i++) {
+                const struct noodTable *n = mi.lits[i];
+                if (!(mi.lit_groups[i] & mi.groups) ||
+                    tl1 + end + 1 < n->msk_len) {
+                    continue;
+                }
+                const u8 *lit_start = temp_buf + tl1 + end + 1 - n->msk_len;
+                u64a v = partial_load_u64a(lit_start, n->msk_len);
+                if ((v & n->msk) == n->cmp) {
+                    DEBUG_PRINTF("match for %u @ %zu\n", n->id, end);
+                    mi.groups = cb(end, n->id, scratch);
+                    if (mi.groups == HWLM_TERMINATE_MATCHING) {
+                        return HWLM_TERMINATED;
+                    }
+                }
+            }
+        }
+        first_end = tl2;
+    }
+
+    assert(buf);
+    return scanMultiFrom(buf, len, first_end, &mi, &cbi);
+}
@@ -41,6 +41,7 @@ extern "C"
 #endif
 
 struct noodTable;
+struct noodMultiTable;
 struct hs_scratch;
 
 /** \brief Block-mode scanner. */
@@ -53,6 +54,18 @@ hwlm_error_t noodExecStreaming(const struct noodTable *n, const u8 *hbuf,
                                size_t hlen, const u8 *buf, size_t len,
                                HWLMCallback cb, struct hs_scratch *scratch);
 
+/** \brief Block-mode scanner for a multi-literal table. */
+hwlm_error_t noodMultiExec(const struct noodMultiTable *nm, const u8 *buf,
+                           size_t len, size_t start, HWLMCallback cb,
+                           struct hs_scratch *scratch, hwlm_group_t groups);
+
+/** \brief Streaming-mode scanner for a multi-literal table. */
+hwlm_error_t noodMultiExecStreaming(const struct noodMultiTable *nm,
+                                    const u8 *hbuf, size_t hlen, const u8 *buf,
+                                    size_t len, HWLMCallback cb,
+                                    struct hs_scratch *scratch,
+                                    hwlm_group_t groups);
+
 #ifdef __cplusplus
 }       /* extern "C" */
 #endif
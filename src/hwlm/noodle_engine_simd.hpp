@@ -308,3 +308,119 @@ hwlm_error_t scanDouble(const struct noodTable *n, const u8 *buf, size_t len,
 
     return scanDoubleMain(n, buf, len, start, caseMask, mask1, mask2, cbi);
 }
+
+// Multi-literal scan: every literal is keyed on its last one or two
+// characters, so a candidate for any literal is at its end offset. The
+// number of literals is a template parameter so that the per-literal
+// compare chains are unrolled, and the chains are combined before taking a
+// single compare mask for the block.
+template <uint16_t S>
+struct MultiKeys {
+    SuperVector<S> key0[NOOD_MULTI_MAX]; //!< second last char, if any
+    SuperVector<S> key1[NOOD_MULTI_MAX]; //!< last char
+    SuperVector<S> caseMask[NOOD_MULTI_MAX]; //!< applied to the data
+    SuperVector<S> single[NOOD_MULTI_MAX]; //!< all ones for one-char literals
+};
+
+template <uint16_t S, u32 N>
+static really_inline
+hwlm_error_t scanMultiBlock(const u8 *buf, size_t base, SuperVector<S> prev,
+                            SuperVector<S> cur, Z_TYPE valid,
+                            const MultiKeys<S> &keys, struct multi_info *mi,
+                            const struct cb_info *cbi) {
+    SuperVector<S> zv[N];
+    SuperVector<S> anyv = SuperVector<S>::Zeroes();
+    for (u32 i = 0; i < N; i++) {
+        SuperVector<S> z1 = (cur & keys.caseMask[i]).eq(keys.key1[i]);
+        SuperVector<S> z0 = (prev & keys.caseMask[i]).eq(keys.key0[i]);
+        zv[i] = z1 & (z0 | keys.single[i]);
+        anyv = anyv | zv[i];
+    }
+
+    Z_TYPE any = anyv.comparemask() & valid;
+    if (likely(!any)) {
+        return HWLM_SUCCESS;
+    }
+
+    Z_TYPE zs[N];
+    for (u32 i = 0; i < N; i++) {
+        zs[i] = zv[i].comparemask();
+    }
+    any = SuperVector<S>::iteration_mask(any);
+
+    while (any) {
+        u32 bit = JOIN(findAndClearLSB_, Z_BITS)(&any);
+        size_t end = base + (bit >> Z_POSSHIFT);
+        DEBUG_PRINTF("candidate end %zu\n", end);
+        for (u32 i = 0; i < N; i++) {
+            if ((zs[i] >> bit) & 1) {
+                hwlm_error_t rv = multiFinal(i, buf, end, mi, cbi);
+                RETURN_IF_TERMINATED(rv);
+            }
+        }
+    }
+    return HWLM_SUCCESS;
+}
+
+template <uint16_t S, u32 N>
+static really_inline
+hwlm_error_t scanMultiMain(const u8 *buf, size_t len, size_t first_end,
+                           const MultiKeys<S> &keys, struct multi_info *mi,
+                           const struct cb_info *cbi) {
+    assert(first_end && first_end < len);
+    assert(mi->count == N);
+    size_t d = first_end;
+
+    for (; d + S <= len; d += S) {
+        __builtin_prefetch(buf + d + 256);
+        SuperVector<S> prev = SuperVector<S>::loadu(buf + d - 1);
+        SuperVector<S> cur = SuperVector<S>::loadu(buf + d);
+        hwlm_error_t rv = scanMultiBlock<S, N>(buf, d, prev, cur, ~(Z_TYPE)0,
+                                               keys, mi, cbi);
+        RETURN_IF_TERMINATED(rv);
+    }
+
+    // finish off tail
+    if (d == len) {
+        return HWLM_SUCCESS;
+    }
+    const size_t l = len - d;
+    SuperVector<S> prev = SuperVector<S>::Zeroes();
+    SuperVector<S> cur = SuperVector<S>::Zeroes();
+    memcpy(&prev.u, buf + d - 1, l);
+    memcpy(&cur.u, buf + d, l);
+    Z_TYPE valid = SINGLE_LOAD_MASK(l * SuperVector<S>::mask_width());
+    return scanMultiBlock<S, N>(buf, d, prev, cur, valid, keys, mi, cbi);
+}
+
+static really_inline
+hwlm_error_t scanMulti(const u8 *buf, size_t len, size_t first_end,
+                       struct multi_info *mi, const struct cb_info *cbi) {
+    MultiKeys<VECTORSIZE> keys;
+    for (u32 i = 0; i < mi->count; i++) {
+        const struct noodTable *n = mi->lits[i];
+        keys.caseMask[i] = n->nocase ? getCaseMask<VECTORSIZE>()
+                                     : SuperVector<VECTORSIZE>::Ones();
+        if (n->single) {
+            keys.key0[i] = SuperVector<VECTORSIZE>::Zeroes();
+            keys.key1[i] = getMask<VECTORSIZE>(n->key0, n->nocase);
+            keys.single[i] = SuperVector<VECTORSIZE>::Ones();
+        } else {
+            keys.key0[i] = getMask<VECTORSIZE>(n->key0, n->nocase);
+            keys.key1[i] = getMask<VECTORSIZE>(n->key1, n->nocase);
+            keys.single[i] = SuperVector<VECTORSIZE>::Zeroes();
+        }
+    }
+
+    switch (mi->count) {
+    case 1:
+        return scanMultiMain<VECTORSIZE, 1>(buf, len, first_end, keys, mi, cbi);
+    case 2:
+        return scanMultiMain<VECTORSIZE, 2>(buf, len, first_end, keys, mi, cbi);
+    case 3:
+        return scanMultiMain<VECTORSIZE, 3>(buf, len, first_end, keys, mi, cbi);
+    default:
+        assert(mi->count == 4);
+        return scanMultiMain<VECTORSIZE, 4>(buf, len, first_end, keys, mi, cbi);
+    }
+}
@@ -235,3 +235,69 @@ hwlm_error_t scanDouble(const struct noodTable *n, const u8 *buf, size_t len,
     }
     return scanDoubleLoop(n, buf, len, cbi, chars, d1, e);
 }
+
+// Multi-literal scan: every literal is keyed on its last one or two
+// characters, so a candidate for any literal is at its end offset. SVE
+// predicates can't be kept in arrays, so candidates are confirmed against
+// every literal.
+static really_inline
+svbool_t multiMatched(const struct noodTable *n, svuint8_t prev,
+                      svuint8_t cur, svbool_t pg) {
+    if (n->single) {
+        return svmatch(pg, cur, getCharMaskSingle(n->key0, n->nocase));
+    }
+    svbool_t m1 = svmatch(pg, cur, getCharMaskSingle(n->key1, n->nocase));
+    svbool_t m0 = svmatch(pg, prev, getCharMaskSingle(n->key0, n->nocase));
+    return svand_z(pg, m0, m1);
+}
+
+static really_inline
+hwlm_error_t scanMultiOnce(const u8 *buf, const u8 *d, svbool_t pg,
+                           struct multi_info *mi, const struct cb_info *cbi) {
+    // d - 1 won't underflow as an end at offset zero has been dealt with
+    assert(d > buf);
+    svuint8_t prev = svld1_u8(pg, d - 1);
+    svuint8_t cur = svld1_u8(pg, d);
+
+    svbool_t any = svpfalse();
+    for (u32 i = 0; i < mi->count; i++) {
+        any = svorr_z(svptrue_b8(), any,
+                      multiMatched(mi->lits[i], prev, cur, pg));
+    }
+    if (likely(!svptest_any(svptrue_b8(), any))) {
+        return HWLM_SUCCESS;
+    }
+
+    size_t basePos = d - buf;
+    svbool_t next_match = svpnext_b8(any, svpfalse());
+    do {
+        svbool_t brk = svbrkb_z(svptrue_b8(), next_match);
+        size_t end = basePos + svcntp_b8(svptrue_b8(), brk);
+        DEBUG_PRINTF("candidate end %zu\n", end);
+        for (u32 i = 0; i < mi->count; i++) {
+            hwlm_error_t rv = multiFinal(i, buf, end, mi, cbi);
+            RETURN_IF_TERMINATED(rv);
+        }
+        next_match = svpnext_b8(any, next_match);
+    } while (unlikely(svptest_any(svptrue_b8(), next_match)));
+    return HWLM_SUCCESS;
+}
+
+static really_inline
+hwlm_error_t scanMulti(const u8 *buf, size_t len, size_t first_end,
+                       struct multi_info *mi, const struct cb_info *cbi) {
+    assert(first_end && first_end < len);
+    const u8 *d = buf + first_end;
+    const u8 *e = buf + len;
+
+    size_t loops = (e - d) / svcntb();
+    DEBUG_PRINTF("loops %zu \n", loops);
+    for (size_t i = 0; i < loops; i++, d += svcntb()) {
+        hwlm_error_t rv = scanMultiOnce(buf, d, svptrue_b8(), mi, cbi);
+        RETURN_IF_TERMINATED(rv);
+    }
+
+    DEBUG_PRINTF("d %p e %p \n", d, e);
+    return d == e ? HWLM_SUCCESS
+                  : scanMultiOnce(buf, d, svwhilelt_b8_s64(0, e - d), mi, cbi);
+}
@@ -47,5 +47,22 @@ struct noodTable {
     u8 key1;
 };
 
+/** \brief Maximum number of literals in a multi-literal Noodle table. */
+#define NOOD_MULTI_MAX 4
+
+/** \brief Noodle table for a handful of literals.
+ *
+ * Each literal gets its own noodTable, with the key taken from its last one or
+ * two characters so that candidates from every literal line up on their end
+ * offsets and can be reported in order from a single pass. */
+struct noodMultiTable {
+    u32 count; //!< number of literals, at most NOOD_MULTI_MAX
+    u8 min_len; //!< shortest msk_len over all literals
+    u8 max_len; //!< longest msk_len over all literals
+    u8 pad[2];
+    u64a groups[NOOD_MULTI_MAX]; //!< groups for each literal
+    struct noodTable lits[NOOD_MULTI_MAX];
+};
+
 #endif /* NOODLE_INTERNAL_H */
 
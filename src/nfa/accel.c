@@ -28,6 +28,7 @@
  */
 
 #include "accel.h"
+#include "scan_stats.h"
 #include "shufti.h"
 #include "truffle.h"
 #include "vermicelli.hpp"
@@ -158,6 +159,22 @@ const u8 *run_accel(const union AccelAux *accel, const u8 *c, const u8 *c_end) {
                               accel->dshufti.hi2, c, c_end - 1);
         break;
 
+    case ACCEL_TSHUFTI: {
+        DEBUG_PRINTF("accel tshufti %p %p\n", c, c_end);
+        if (c + 15 + 2 >= c_end) {
+            return c;
+        }
+
+        const struct AccelTShuftiMasks *t = (const void *)
+            ((const char *)accel + accel->tshufti.masks);
+        assert(ISALIGNED_16(t));
+
+        /* need to stop two early to get an accurate end state */
+        rv = shuftiTripleExec(t->lo1, t->hi1, t->lo2, t->hi2, t->lo3, t->hi3,
+                              c, c_end - 2);
+        break;
+    }
+
     case ACCEL_RED_TAPE:
         DEBUG_PRINTF("accel red tape %p %p\n", c, c_end);
         rv = c_end;
@@ -175,6 +192,7 @@ const u8 *run_accel(const union AccelAux *accel, const u8 *c, const u8 *c_end) {
     rv -= accel->generic.offset;
 
     DEBUG_PRINTF("advanced %zd\n", rv - c);
+    SCAN_STAT_ADD(engine_accel_skipped, rv - c);
 
     return rv;
 }
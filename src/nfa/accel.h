@@ -66,6 +66,21 @@ enum AccelType {
     ACCEL_VERM16,
     ACCEL_DVERM16,
     ACCEL_DVERM16_MASKED,
+    ACCEL_TSHUFTI,
+};
+
+/**
+ * \brief Masks for the triple shufti scheme. These are stored out of line,
+ * referenced from the AccelAux, so that this one scheme doesn't grow the
+ * AccelAux union used by every engine.
+ */
+struct AccelTShuftiMasks {
+    m128 lo1;
+    m128 hi1;
+    m128 lo2;
+    m128 hi2;
+    m128 lo3;
+    m128 hi3;
 };
 
 /** \brief Structure for accel framework. */
@@ -133,6 +148,11 @@ union AccelAux {
         m128 lo2;
         m128 hi2;
     } dshufti;
+    struct {
+        u8 accel_type;
+        u8 offset;
+        u32 masks; //!< offset of AccelTShuftiMasks from this AccelAux
+    } tshufti;
     struct {
         u8 accel_type;
         u8 offset;
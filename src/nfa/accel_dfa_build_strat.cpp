@@ -205,7 +205,7 @@ bool better(const AccelScheme &a, const AccelScheme &b) {
         return true;
     }
 
-    if (!b.double_byte.empty()) {
+    if (!b.double_byte.empty() || !b.triple.empty()) {
         return false;
     }
 
@@ -419,6 +419,37 @@ accel_dfa_build_strat::find_escape_strings(dstate_id_t this_idx) const {
         }
     }
 
+    /* the floating start state may still be escaped only by a sufficiently
+     * rare sequence of classes. As with offset accel, this is only safe for
+     * the floating start: the scan may stop partway along a path that has
+     * left this state, and resuming there in this state is only correct if
+     * it is the floating start. */
+    if (!double_byte_ok(rv) && !is_triggered(rdfa.kind) &&
+        this_idx == rdfa.start_floating && this_idx != DEAD_STATE &&
+        rv.cr.count() >= TRIPLE_SHUFTI_MIN_STOPS) {
+        DEBUG_PRINTF("looking for triple accel at %u\n", this_idx);
+        auto paths = generate_paths(rdfa, this_idx,
+                                    max_allowed_offset_accel() + 1);
+        findTripleAccelScheme(paths, CharReach(), &rv);
+    }
+
+    return rv;
+}
+
+size_t
+accel_dfa_build_strat::stateAccelSize(const AccelScheme &info) const {
+    if (info.triple.empty()) {
+        return accelSize();
+    }
+    return accelSize() + sizeof(AccelTShuftiMasks);
+}
+
+size_t accel_dfa_build_strat::totalAccelSize(
+    const std::map<dstate_id_t, AccelScheme> &accel_info) const {
+    size_t rv = 0;
+    for (const auto &m : accel_info) {
+        rv += stateAccelSize(m.second);
+    }
     return rv;
 }
 
@@ -513,6 +544,21 @@ accel_dfa_build_strat::buildAccel(UNUSED dstate_id_t this_idx,
 #endif // HAVE_SVE2
     }
 
+    /* triple shufti masks live directly after the AccelAux, in the space
+     * reserved by stateAccelSize() */
+    AccelTShuftiMasks *masks = (AccelTShuftiMasks *)(accel + 1);
+    if (!info.triple.empty() &&
+        shuftiBuildTripleMasks(info.triple, (u8 *)&masks->lo1,
+                               (u8 *)&masks->hi1, (u8 *)&masks->lo2,
+                               (u8 *)&masks->hi2, (u8 *)&masks->lo3,
+                               (u8 *)&masks->hi3)) {
+        accel->accel_type = ACCEL_TSHUFTI;
+        accel->tshufti.offset = verify_u8(info.triple_offset);
+        accel->tshufti.masks = sizeof(AccelAux);
+        DEBUG_PRINTF("state %hu is triple shufti\n", this_idx);
+        return;
+    }
+
     if (double_byte_ok(info) &&
         shuftiBuildDoubleMasks(
             info.double_cr, info.double_byte, (u8 *)&accel->dshufti.lo1,
@@ -604,7 +650,7 @@ accel_dfa_build_strat::getAccelInfo(const Grey &grey) {
         DEBUG_PRINTF("inspecting %zu/%hu: %zu\n", i, sds_proxy, single_limit);
 
         AccelScheme ei = find_escape_strings(i);
-        if (ei.cr.count() > single_limit) {
+        if (ei.cr.count() > single_limit && ei.triple.empty()) {
             DEBUG_PRINTF("state %zu is not accelerable has %zu\n", i,
                          ei.cr.count());
             return;
@@ -629,10 +675,12 @@ accel_dfa_build_strat::getAccelInfo(const Grey &grey) {
     }
 
     /* provide acceleration states to states in the region of sds */
-    if (contains(rv, sds_proxy)) {
+    if (contains(rv, sds_proxy) &&
+        rv[sds_proxy].cr.count() <= max_floating_stop_char()) {
         AccelScheme sds_ei = rv[sds_proxy];
         sds_ei.double_byte.clear(); /* region based on single byte scheme
                                      * may differ from double byte */
+        sds_ei.triple.clear();
         DEBUG_PRINTF("looking to expand offset accel to nearby states, %zu\n",
                      sds_ei.cr.count());
         auto sds_region = find_region(rdfa, sds_proxy, sds_ei);
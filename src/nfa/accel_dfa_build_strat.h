@@ -52,6 +52,13 @@ public:
         : dfa_build_strat(rm_in), only_accel_init(only_accel_init_in) {}
     virtual AccelScheme find_escape_strings(dstate_id_t this_idx) const;
     virtual size_t accelSize(void) const = 0;
+    /** \brief Bytes to reserve for the accel structure of a state with the
+     * given scheme, including any triple shufti masks stored after it. */
+    size_t stateAccelSize(const AccelScheme &info) const;
+    /** \brief Total bytes to reserve for the accel structures of all the
+     * given states. */
+    size_t totalAccelSize(
+        const std::map<dstate_id_t, AccelScheme> &accel_info) const;
     virtual u32 max_allowed_offset_accel() const = 0;
     virtual u32 max_stop_char() const = 0;
     virtual u32 max_floating_stop_char() const = 0;
@@ -91,6 +91,8 @@ const char *accelName(u8 accel_type) {
         return "shufti";
     case ACCEL_DSHUFTI:
         return "double-shufti";
+    case ACCEL_TSHUFTI:
+        return "triple-shufti";
     case ACCEL_TRUFFLE:
         return "truffle";
     case ACCEL_RED_TAPE:
@@ -165,6 +167,30 @@ void dumpDShuftiCharReach(FILE *f, const u8 *lo1, const u8 *hi1,
     fprintf(f, "}\n");
 }
 
+static
+void dumpTShuftiCharReach(FILE *f, const u8 *lo1, const u8 *hi1,
+                          const u8 *lo2, const u8 *hi2,
+                          const u8 *lo3, const u8 *hi3) {
+    vector<CharReach> cr1 = dshufti2cr_array(lo1, hi1);
+    vector<CharReach> cr2 = dshufti2cr_array(lo2, hi2);
+    vector<CharReach> cr3 = dshufti2cr_array(lo3, hi3);
+    assert(cr1.size() == 8 && cr2.size() == 8 && cr3.size() == 8);
+    fprintf(f, "escapes: {");
+    bool first = true;
+    for (u32 i = 0; i < 8; i++) {
+        if (!cr1[i].any()) {
+            continue;
+        }
+        if (!first) {
+            fprintf(f, ", ");
+        }
+        first = false;
+        fprintf(f, "%s%s%s", describeClass(cr1[i]).c_str(),
+                describeClass(cr2[i]).c_str(), describeClass(cr3[i]).c_str());
+    }
+    fprintf(f, "}\n");
+}
+
 static
 void dumpShuftiMasks(FILE *f, const u8 *lo, const u8 *hi) {
     fprintf(f, "lo %s\n", dumpMask(lo, 128).c_str());
@@ -229,6 +255,21 @@ void dumpAccelInfo(FILE *f, const AccelAux &accel) {
                              (const u8 *)&accel.dshufti.lo2,
                              (const u8 *)&accel.dshufti.hi2);
         break;
+    case ACCEL_TSHUFTI: {
+        const auto *t = (const AccelTShuftiMasks *)
+            ((const char *)&accel + accel.tshufti.masks);
+        fprintf(f, "\n");
+        fprintf(f, "mask 1\n");
+        dumpShuftiMasks(f, (const u8 *)&t->lo1, (const u8 *)&t->hi1);
+        fprintf(f, "mask 2\n");
+        dumpShuftiMasks(f, (const u8 *)&t->lo2, (const u8 *)&t->hi2);
+        fprintf(f, "mask 3\n");
+        dumpShuftiMasks(f, (const u8 *)&t->lo3, (const u8 *)&t->hi3);
+        dumpTShuftiCharReach(f, (const u8 *)&t->lo1, (const u8 *)&t->hi1,
+                             (const u8 *)&t->lo2, (const u8 *)&t->hi2,
+                             (const u8 *)&t->lo3, (const u8 *)&t->hi3);
+        break;
+    }
     case ACCEL_TRUFFLE: {
         fprintf(f, "\n");
         dumpTruffleMasks(f, (const u8 *)&accel.truffle.mask1,
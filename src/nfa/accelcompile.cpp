@@ -266,13 +266,41 @@ void buildAccelDouble(const AccelInfo &info, AccelAux *aux) {
     aux->accel_type = ACCEL_NONE;
 }
 
-bool buildAccelAux(const AccelInfo &info, AccelAux *aux) {
+static
+void buildAccelTriple(const AccelInfo &info, AccelAux *aux,
+                      AccelTShuftiMasks *masks) {
+    assert(aux->accel_type == ACCEL_NONE);
+    assert(masks);
+
+    if (info.triple_stops.empty()) {
+        return;
+    }
+
+    DEBUG_PRINTF("building triple-shufti for %zu class triples\n",
+                 info.triple_stops.size());
+    if (shuftiBuildTripleMasks(info.triple_stops, (u8 *)&masks->lo1,
+                               (u8 *)&masks->hi1, (u8 *)&masks->lo2,
+                               (u8 *)&masks->hi2, (u8 *)&masks->lo3,
+                               (u8 *)&masks->hi3)) {
+        aux->accel_type = ACCEL_TSHUFTI;
+        aux->tshufti.offset = verify_u8(info.triple_offset);
+        return;
+    }
+
+    DEBUG_PRINTF("triple-shufti build failed, falling through\n");
+}
+
+bool buildAccelAux(const AccelInfo &info, AccelAux *aux,
+                   AccelTShuftiMasks *tshufti_masks) {
     assert(aux->accel_type == ACCEL_NONE);
     if (info.single_stops.none()) {
         DEBUG_PRINTF("picked red tape\n");
         aux->accel_type = ACCEL_RED_TAPE;
         aux->generic.offset = info.single_offset;
     }
+    if (aux->accel_type == ACCEL_NONE) {
+        buildAccelTriple(info, aux, tshufti_masks);
+    }
     if (aux->accel_type == ACCEL_NONE) {
         buildAccelDouble(info, aux);
     }
@@ -282,7 +310,8 @@ bool buildAccelAux(const AccelInfo &info, AccelAux *aux) {
 
     assert(aux->accel_type == ACCEL_NONE
            || aux->generic.offset == info.single_offset
-           || aux->generic.offset == info.double_offset);
+           || aux->generic.offset == info.double_offset
+           || aux->generic.offset == info.triple_offset);
     return aux->accel_type != ACCEL_NONE;
 }
 
@@ -33,23 +33,38 @@
 #include "util/charreach.h"
 #include "util/flat_containers.h"
 
+#include <array>
+#include <vector>
+
 union AccelAux;
+struct AccelTShuftiMasks;
 
 namespace ue2 {
 
 struct AccelInfo {
-    AccelInfo() : single_offset(0U), double_offset(0U),
+    AccelInfo() : single_offset(0U), double_offset(0U), triple_offset(0U),
                   single_stops(CharReach::dot()) {}
     u32 single_offset; /**< offset correction to apply to single schemes */
     u32 double_offset; /**< offset correction to apply to double schemes */
+    u32 triple_offset; /**< offset correction to apply to triple schemes */
     CharReach double_stop1;  /**<  single-byte accel stop literals for double
                             * schemes */
     flat_set<std::pair<u8, u8>> double_stop2; /**< double-byte accel stop
                                                * literals */
     CharReach single_stops; /**< escapes for single byte acceleration */
+    std::vector<std::array<CharReach, 3>> triple_stops; /**< class triples
+                                                          * for triple shufti */
 };
 
-bool buildAccelAux(const AccelInfo &info, AccelAux *aux);
+/**
+ * \brief Builds the accel scheme for \a info into \a aux.
+ *
+ * Triple shufti keeps its masks out of line: if that scheme is picked, they
+ * are written to \a tshufti_masks and the caller must store them in the
+ * bytecode and point aux->tshufti.masks at them.
+ */
+bool buildAccelAux(const AccelInfo &info, AccelAux *aux,
+                   AccelTShuftiMasks *tshufti_masks);
 
 /* returns true is the escape set can be handled with a masked double_verm */
 bool buildDvermMask(const flat_set<std::pair<u8, u8>> &escape_set,
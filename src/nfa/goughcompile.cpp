@@ -1165,6 +1165,7 @@ AccelScheme gough_build_strat::find_escape_strings(dstate_id_t this_idx) const {
     }
 
     rv = mcclellan_build_strat::find_escape_strings(this_idx);
+    rv.triple.clear(); /* margins only account for one and two byte schemes */
 
     assert(!rv.offset || rv.cr.all()); /* should have been limited by strat */
     if (rv.offset) {
@@ -1184,6 +1185,7 @@ AccelScheme gough_build_strat::find_escape_strings(dstate_id_t this_idx) const {
 void gough_build_strat::buildAccel(dstate_id_t this_idx, const AccelScheme &info,
                                    void *accel_out) {
     assert(mcclellan_build_strat::accelSize() == sizeof(AccelAux));
+    assert(info.triple.empty()); /* no room for out of line masks */
     gough_accel *accel = (gough_accel *)accel_out;
     /* build a plain accelaux so we can work out where we can get to */
     mcclellan_build_strat::buildAccel(this_idx, info, &accel->accel);
@@ -80,6 +80,8 @@ GENERATE_NFA_DECL(nfaExecLimEx128)
 GENERATE_NFA_DECL(nfaExecLimEx256)
 GENERATE_NFA_DECL(nfaExecLimEx384)
 GENERATE_NFA_DECL(nfaExecLimEx512)
+GENERATE_NFA_DECL(nfaExecLimEx768)
+GENERATE_NFA_DECL(nfaExecLimEx1024)
 
 #undef GENERATE_NFA_DECL
 #undef GENERATE_NFA_DUMP_DECL
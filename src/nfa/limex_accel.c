@@ -108,6 +108,41 @@ size_t doAccel128(const m128 *state, const struct LimExNFA128 *limex,
     return accelScanWrapper(accelTable, aux, input, idx, i, end);
 }
 
+// Extract the accel table index from a 256-bit state using the PSHUFB
+// permute and compare masks.
+static really_inline
+u32 accelIndex256(m256 s, m256 accelPerm, m256 accelComp) {
+#if !defined(HAVE_AVX2)
+    u32 idx1 = packedExtract128(s.lo, accelPerm.lo, accelComp.lo);
+    u32 idx2 = packedExtract128(s.hi, accelPerm.hi, accelComp.hi);
+    assert((idx1 & idx2) == 0); // should be no shared bits
+    return idx1 | idx2;
+#else
+    return packedExtract256(s, accelPerm, accelComp);
+#endif
+}
+
+// Extract the accel table index from a 512-bit state using the PSHUFB
+// permute and compare masks.
+static really_inline
+u32 accelIndex512(m512 s, m512 accelPerm, m512 accelComp) {
+#if defined(HAVE_AVX512)
+    return packedExtract512(s, accelPerm, accelComp);
+#elif defined(HAVE_AVX2)
+    u32 idx1 = packedExtract256(s.lo, accelPerm.lo, accelComp.lo);
+    u32 idx2 = packedExtract256(s.hi, accelPerm.hi, accelComp.hi);
+    assert((idx1 & idx2) == 0); // should be no shared bits
+    return idx1 | idx2;
+#else
+    u32 idx1 = packedExtract128(s.lo.lo, accelPerm.lo.lo, accelComp.lo.lo);
+    u32 idx2 = packedExtract128(s.lo.hi, accelPerm.lo.hi, accelComp.lo.hi);
+    u32 idx3 = packedExtract128(s.hi.lo, accelPerm.hi.lo, accelComp.hi.lo);
+    u32 idx4 = packedExtract128(s.hi.hi, accelPerm.hi.hi, accelComp.hi.hi);
+    assert((idx1 & idx2 & idx3 & idx4) == 0); // should be no shared bits
+    return idx1 | idx2 | idx3 | idx4;
+#endif
+}
+
 size_t doAccel256(const m256 *state, const struct LimExNFA256 *limex,
                   const u8 *accelTable, const union AccelAux *aux,
                   const u8 *input, size_t i, size_t end) {
@@ -116,14 +151,7 @@ size_t doAccel256(const m256 *state, const struct LimExNFA256 *limex,
     DEBUG_PRINTF("using PSHUFB for 256-bit shuffle\n");
     m256 accelPerm = limex->accelPermute;
     m256 accelComp = limex->accelCompare;
-#if !defined(HAVE_AVX2)
-    u32 idx1 = packedExtract128(s.lo, accelPerm.lo, accelComp.lo);
-    u32 idx2 = packedExtract128(s.hi, accelPerm.hi, accelComp.hi);
-    assert((idx1 & idx2) == 0); // should be no shared bits
-    idx = idx1 | idx2;
-#else
-    idx = packedExtract256(s, accelPerm, accelComp);
-#endif
+    idx = accelIndex256(s, accelPerm, accelComp);
     return accelScanWrapper(accelTable, aux, input, idx, i, end);
 }
 
@@ -151,20 +179,37 @@ size_t doAccel512(const m512 *state, const struct LimExNFA512 *limex,
     DEBUG_PRINTF("using PSHUFB for 512-bit shuffle\n");
     m512 accelPerm = limex->accelPermute;
     m512 accelComp = limex->accelCompare;
-#if defined(HAVE_AVX512)
-    idx = packedExtract512(s, accelPerm, accelComp);
-#elif defined(HAVE_AVX2)
-    u32 idx1 = packedExtract256(s.lo, accelPerm.lo, accelComp.lo);
-    u32 idx2 = packedExtract256(s.hi, accelPerm.hi, accelComp.hi);
+    idx = accelIndex512(s, accelPerm, accelComp);
+    return accelScanWrapper(accelTable, aux, input, idx, i, end);
+}
+
+size_t doAccel768(const m768 *state, const struct LimExNFA768 *limex,
+                  const u8 *accelTable, const union AccelAux *aux,
+                  const u8 *input, size_t i, size_t end) {
+    u32 idx;
+    m768 s = *state;
+    DEBUG_PRINTF("using PSHUFB for 768-bit shuffle\n");
+    m768 accelPerm = limex->accelPermute;
+    m768 accelComp = limex->accelCompare;
+    u32 idx1 = accelIndex256(s.lo, accelPerm.lo, accelComp.lo);
+    u32 idx2 = accelIndex256(s.mid, accelPerm.mid, accelComp.mid);
+    u32 idx3 = accelIndex256(s.hi, accelPerm.hi, accelComp.hi);
+    assert((idx1 & idx2 & idx3) == 0); // should be no shared bits
+    idx = idx1 | idx2 | idx3;
+    return accelScanWrapper(accelTable, aux, input, idx, i, end);
+}
+
+size_t doAccel1024(const m1024 *state, const struct LimExNFA1024 *limex,
+                   const u8 *accelTable, const union AccelAux *aux,
+                   const u8 *input, size_t i, size_t end) {
+    u32 idx;
+    m1024 s = *state;
+    DEBUG_PRINTF("using PSHUFB for 1024-bit shuffle\n");
+    m1024 accelPerm = limex->accelPermute;
+    m1024 accelComp = limex->accelCompare;
+    u32 idx1 = accelIndex512(s.lo, accelPerm.lo, accelComp.lo);
+    u32 idx2 = accelIndex512(s.hi, accelPerm.hi, accelComp.hi);
     assert((idx1 & idx2) == 0); // should be no shared bits
     idx = idx1 | idx2;
-#else
-    u32 idx1 = packedExtract128(s.lo.lo, accelPerm.lo.lo, accelComp.lo.lo);
-    u32 idx2 = packedExtract128(s.lo.hi, accelPerm.lo.hi, accelComp.lo.hi);
-    u32 idx3 = packedExtract128(s.hi.lo, accelPerm.hi.lo, accelComp.hi.lo);
-    u32 idx4 = packedExtract128(s.hi.hi, accelPerm.hi.hi, accelComp.hi.hi);
-    assert((idx1 & idx2 & idx3 & idx4) == 0); // should be no shared bits
-    idx = idx1 | idx2 | idx3 | idx4;
-#endif
     return accelScanWrapper(accelTable, aux, input, idx, i, end);
 }
@@ -45,6 +45,8 @@ struct LimExNFA128;
 struct LimExNFA256;
 struct LimExNFA384;
 struct LimExNFA512;
+struct LimExNFA768;
+struct LimExNFA1024;
 
 size_t doAccel32(u32 s, u32 accel, const u8 *accelTable,
                  const union AccelAux *aux, const u8 *input, size_t i,
@@ -76,4 +78,12 @@ size_t doAccel512(const m512 *s, const struct LimExNFA512 *limex,
                   const u8 *accelTable, const union AccelAux *aux,
                   const u8 *input, size_t i, size_t end);
 
+size_t doAccel768(const m768 *s, const struct LimExNFA768 *limex,
+                  const u8 *accelTable, const union AccelAux *aux,
+                  const u8 *input, size_t i, size_t end);
+
+size_t doAccel1024(const m1024 *s, const struct LimExNFA1024 *limex,
+                   const u8 *accelTable, const union AccelAux *aux,
+                   const u8 *input, size_t i, size_t end);
+
 #endif
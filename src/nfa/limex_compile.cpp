@@ -62,6 +62,7 @@
 #include "util/verify_types.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
@@ -100,13 +101,16 @@ static constexpr u8 MIN_REPEAT_TRIGGER_DISTANCE = 6;
 namespace {
 
 struct precalcAccel {
-    precalcAccel() : single_offset(0), double_offset(0) {}
+    precalcAccel() : single_offset(0), double_offset(0), triple_offset(0) {}
     CharReach single_cr;
     u32 single_offset;
 
     CharReach double_cr;
     flat_set<pair<u8, u8>> double_lits; /* double-byte accel stop literals */
     u32 double_offset;
+
+    vector<array<CharReach, 3>> triple; /* triple shufti class triples */
+    u32 triple_offset;
 };
 
 struct limex_accel_info {
@@ -196,7 +200,7 @@ struct build_info {
     limex_accel_info accel;
 };
 
-#define LAST_LIMEX_NFA LIMEX_NFA_512
+#define LAST_LIMEX_NFA LIMEX_NFA_1024
 
 // Constants for scoring mechanism
 const int SHIFT_COST = 10; // limex: cost per shift mask
@@ -234,11 +238,14 @@ struct DISPATCH_BY_LIMEX_TYPE_INT<sfunc, rv_t, arg_t,
 
 // Given a number of states, find the size of the smallest container NFA it
 // will fit in. We support NFAs of the following sizes: 32, 64, 128, 256, 384,
-// 512.
+// 512, 768, 1024.
 size_t findContainerSize(size_t states) {
     if (states > 256 && states <= 384) {
         return 384;
     }
+    if (states > 512 && states <= 768) {
+        return 768;
+    }
     return 1ULL << (lg2(states - 1) + 1);
 }
 
@@ -598,7 +605,7 @@ bool containsBadSubset(const limex_accel_info &accel,
 
 static
 bool is_too_wide(const AccelScheme &as) {
-    return as.cr.count() > MAX_MERGED_ACCEL_STOPS;
+    return as.cr.count() > MAX_MERGED_ACCEL_STOPS && as.triple.empty();
 }
 
 static
@@ -677,6 +684,11 @@ void fillAccelInfo(build_info &bi) {
             pa.double_cr = as.double_cr;
         }
 
+        if (!as.triple.empty()) {
+            pa.triple_offset = as.triple_offset;
+            pa.triple = as.triple;
+        }
+
         useful |= state_set;
     }
 
@@ -703,6 +715,9 @@ void fillAccelInfo(build_info &bi) {
  * compilers do odd things unless we specify a custom allocator. */
 typedef vector<AccelAux, AlignedAllocator<AccelAux, alignof(AccelAux)>>
     AccelAuxVector;
+typedef vector<AccelTShuftiMasks,
+               AlignedAllocator<AccelTShuftiMasks, alignof(AccelTShuftiMasks)>>
+    TShuftiMasksVector;
 
 #define IMPOSSIBLE_ACCEL_MASK (~0U)
 
@@ -855,7 +870,7 @@ u32 getEffectiveAccelStates(const build_info &args,
 static
 void buildAccel(const build_info &args, NFAStateSet &accelMask,
                 NFAStateSet &accelFriendsMask, AccelAuxVector &auxvec,
-                vector<u8> &accelTable) {
+                TShuftiMasksVector &tshuftivec, vector<u8> &accelTable) {
     const limex_accel_info &accel = args.accel;
 
     // Init, all zeroes.
@@ -918,6 +933,7 @@ void buildAccel(const build_info &args, NFAStateSet &accelMask,
     auxvec[0].accel_type = ACCEL_NONE; // no states on.
 
     AccelAux aux;
+    AccelTShuftiMasks tshufti_masks;
     for (u32 i = 1; i < accelCount; i++) {
         memset(&aux, 0, sizeof(aux));
 
@@ -939,10 +955,27 @@ void buildAccel(const build_info &args, NFAStateSet &accelMask,
                 const auto &precalc = accel.precalc.at(effective_states);
                 ainfo.single_offset = precalc.single_offset;
                 ainfo.single_stops = precalc.single_cr;
+                ainfo.triple_offset = precalc.triple_offset;
+                ainfo.triple_stops = precalc.triple;
             }
         }
 
-        buildAccelAux(ainfo, &aux);
+        buildAccelAux(ainfo, &aux, &tshufti_masks);
+
+        // Triple shufti masks are deduped into their own table. Until
+        // writeAccel lays that table out, the scheme's masks field holds the
+        // index of its masks in tshuftivec.
+        if (aux.accel_type == ACCEL_TSHUFTI) {
+            auto mit = find_if(tshuftivec.begin(), tshuftivec.end(),
+                               [&](const AccelTShuftiMasks &m) {
+                                   return !memcmp(&m, &tshufti_masks,
+                                                  sizeof(m));
+                               });
+            aux.tshufti.masks = verify_u32(mit - tshuftivec.begin());
+            if (mit == tshuftivec.end()) {
+                tshuftivec.emplace_back(tshufti_masks);
+            }
+        }
 
         // FIXME: We may want a faster way to find AccelAux structures that
         // we've already built before.
@@ -1976,7 +2009,10 @@ struct Factory {
         limex->exceptionOffset = exceptionsOffset;
         limex->exceptionCount = ecount;
 
-        if (args.num_states > 64 && args.cc.target_info.has_avx512vbmi()) {
+        // The runtime VBMI exception extraction gathers bytes from a single
+        // 512-bit register, so it is not available for larger models.
+        if (args.num_states > 64 && args.num_states <= 512 &&
+            args.cc.target_info.has_avx512vbmi()) {
             const u8 *exceptionMask = (const u8 *)(&limex->exceptionMask);
             u8 *shufMask = (u8 *)&limex->exceptionShufMask;
             u8 *bitMask = (u8 *)&limex->exceptionBitMask;
@@ -2089,8 +2125,10 @@ struct Factory {
     void writeAccel(const NFAStateSet &accelMask,
                     const NFAStateSet &accelFriendsMask,
                     const AccelAuxVector &accelAux,
+                    const TShuftiMasksVector &tshuftiMasks,
                     const vector<u8> &accelTable, implNFA_t *limex,
-                    const u32 accelTableOffset, const u32 accelAuxOffset) {
+                    const u32 accelTableOffset, const u32 accelAuxOffset,
+                    const u32 tshuftiMasksOffset) {
         DEBUG_PRINTF("accelTableOffset=%u, accelAuxOffset=%u\n",
                       accelTableOffset, accelAuxOffset);
 
@@ -2105,6 +2143,22 @@ struct Factory {
         assert(ISALIGNED(auxTable));
         copy(accelAux.begin(), accelAux.end(), auxTable);
 
+        // Write triple shufti masks, and replace each triple shufti scheme's
+        // index into them with the offset of its masks from the scheme.
+        AccelTShuftiMasks *maskTable =
+            (AccelTShuftiMasks *)((char *)limex + tshuftiMasksOffset);
+        assert(ISALIGNED(maskTable));
+        copy(tshuftiMasks.begin(), tshuftiMasks.end(), maskTable);
+        for (u32 i = 0; i < accelAux.size(); i++) {
+            AccelAux *aux = &auxTable[i];
+            if (aux->accel_type != ACCEL_TSHUFTI) {
+                continue;
+            }
+            assert(aux->tshufti.masks < tshuftiMasks.size());
+            const char *m = (const char *)&maskTable[aux->tshufti.masks];
+            aux->tshufti.masks = verify_u32(m - (const char *)aux);
+        }
+
         // Write LimEx structure members.
         limex->accelCount = verify_u32(accelTable.size());
         // FIXME: accelAuxCount is unused?
@@ -2268,8 +2322,10 @@ struct Factory {
         // Build all our accel info.
         NFAStateSet accelMask, accelFriendsMask;
         AccelAuxVector accelAux;
+        TShuftiMasksVector tshuftiMasks;
         vector<u8> accelTable;
-        buildAccel(args, accelMask, accelFriendsMask, accelAux, accelTable);
+        buildAccel(args, accelMask, accelFriendsMask, accelAux, tshuftiMasks,
+                   accelTable);
 
         // Compute the offsets in the bytecode for this LimEx NFA for all of
         // our structures. First, the NFA and LimEx structures. All other
@@ -2290,6 +2346,10 @@ struct Factory {
         const u32 accelAuxOffset = offset;
         offset += sizeof(AccelAux) * accelAux.size();
 
+        offset = ROUNDUP_N(offset, alignof(AccelTShuftiMasks));
+        const u32 tshuftiMasksOffset = offset;
+        offset += sizeof(AccelTShuftiMasks) * tshuftiMasks.size();
+
         offset = ROUNDUP_N(offset, alignof(NFAAccept));
         const u32 acceptsOffset = offset;
         offset += sizeof(NFAAccept) * accepts.size();
@@ -2328,8 +2388,9 @@ struct Factory {
 
         writeTopMasks(tops, limex, topsOffset);
 
-        writeAccel(accelMask, accelFriendsMask, accelAux, accelTable,
-                   limex, accelTableOffset, accelAuxOffset);
+        writeAccel(accelMask, accelFriendsMask, accelAux, tshuftiMasks,
+                   accelTable, limex, accelTableOffset, accelAuxOffset,
+                   tshuftiMasksOffset);
 
         writeAccepts(acceptMask, acceptEodMask, accepts, acceptsEod, squash,
                      limex, acceptsOffset, acceptsEodOffset, squashOffset,
@@ -2375,7 +2436,7 @@ struct Factory {
     }
 
     static int score(const build_info &args) {
-        // LimEx NFAs are available in sizes from 32 to 512-bit.
+        // LimEx NFAs are available in sizes from 32 to 1024-bit.
         size_t num_states = args.num_states;
 
         size_t sz = findContainerSize(num_states);
@@ -2432,6 +2493,8 @@ MAKE_LIMEX_TRAITS(128)
 MAKE_LIMEX_TRAITS(256)
 MAKE_LIMEX_TRAITS(384)
 MAKE_LIMEX_TRAITS(512)
+MAKE_LIMEX_TRAITS(768)
+MAKE_LIMEX_TRAITS(1024)
 
 } // namespace
 
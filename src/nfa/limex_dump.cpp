@@ -55,6 +55,14 @@ using namespace std;
 namespace ue2 {
 
 template<typename T> struct limex_traits {};
+template<> struct limex_traits<LimExNFA1024> {
+    static const u32 size = 1024;
+    typedef NFAException1024 exception_type;
+};
+template<> struct limex_traits<LimExNFA768> {
+    static const u32 size = 768;
+    typedef NFAException768 exception_type;
+};
 template<> struct limex_traits<LimExNFA512> {
     static const u32 size = 512;
     typedef NFAException512 exception_type;
@@ -513,5 +521,7 @@ LIMEX_DUMP_FN(128)
 LIMEX_DUMP_FN(256)
 LIMEX_DUMP_FN(384)
 LIMEX_DUMP_FN(512)
+LIMEX_DUMP_FN(768)
+LIMEX_DUMP_FN(1024)
 
 } // namespace ue2
@@ -238,7 +238,9 @@ int PE_FN(STATE_ARG, ESTATE_ARG, UNUSED u32 diffmask, STATE_T *succ,
     struct proto_cache new_cache = {0, NULL};
     enum CacheResult cacheable = CACHE_RESULT;
 
-#if defined(HAVE_AVX512VBMI) && SIZE > 64
+// The VBMI byte shuffle can only gather from a single 512-bit register, so
+// larger models always use the chunked path below.
+#if defined(HAVE_AVX512VBMI) && SIZE > 64 && SIZE <= 512
     if (likely(limex->flags & LIMEX_FLAG_EXTRACT_EXP)) {
         m512 emask = EXPAND_STATE(*STATE_ARG_P);
         emask = SHUFFLE_BYTE_STATE(load_m512(&limex->exceptionShufMask), emask);
@@ -984,6 +984,358 @@ char nfaExecMcClellan16_B(const struct NFA *n, u64a offset, const u8 *buffer,
     }
 }
 
+/** \brief Per block state for nfaExecMcClellanMulti_B(). */
+struct mcclellan_lane {
+    const struct mcclellan *m;
+    const u8 *buf;
+    size_t len;
+    u64a offset;
+    NfaCallback cb;
+    void *ctxt;
+    u32 s;
+    u32 cached_accept_state;
+    u32 cached_accept_id;
+    char single;
+    char done;
+};
+
+static really_inline
+void mcclellanLaneInit(struct mcclellan_lane *l,
+                       const struct mcclellan_multi_block *b) {
+    l->m = getImplNfa(b->nfa);
+    l->buf = b->buffer;
+    l->len = b->length;
+    l->offset = b->offset;
+    l->cb = b->cb;
+    l->ctxt = b->context;
+    l->s = l->m->start_anchored & STATE_MASK;
+    l->cached_accept_state = 0;
+    l->cached_accept_id = 0;
+    l->single = l->m->flags & MCCLELLAN_FLAG_SINGLE;
+    l->done = 0;
+}
+
+/** \brief Report the (unflagged) accept state s for a lane which has consumed
+ * i bytes. Returns zero if the callback halted matching. */
+static really_inline
+char mcclellanLaneReport(struct mcclellan_lane *l, u32 s, size_t i) {
+    u64a loc = l->offset + i;
+    if (l->single) {
+        DEBUG_PRINTF("reporting %u\n", l->m->arb_report);
+        return l->cb(0, loc, l->m->arb_report, l->ctxt) != MO_HALT_MATCHING;
+    }
+    return doComplexReport(l->cb, l->ctxt, l->m, s, loc, 0,
+                           &l->cached_accept_state, &l->cached_accept_id)
+           != MO_HALT_MATCHING;
+}
+
+/** \brief Finish a lane which has consumed i bytes: run the rest of its
+ * buffer through the single block scan, then raise any EOD reports. */
+static really_inline
+void mcclellanLaneFinish(struct mcclellan_lane *l, size_t i, char is16) {
+    const struct mcclellan *m = l->m;
+    u32 s = l->s;
+    l->done = 1;
+
+    if (!s) {
+        return;
+    }
+
+    char rv = is16 ? mcclellanExec16_i_cb(m, &s, NULL, l->buf + i, l->len - i,
+                                          l->offset + i, l->cb, l->ctxt,
+                                          l->single, NULL)
+                   : mcclellanExec8_i_cb(m, &s, l->buf + i, l->len - i,
+                                         l->offset + i, l->cb, l->ctxt,
+                                         l->single, NULL);
+    if (rv == MO_DEAD || !s) {
+        return;
+    }
+
+    if (get_aux(m, s)->accept_eod) {
+        doComplexReport(l->cb, l->ctxt, m, s, l->offset + l->len, 1, NULL,
+                        NULL);
+    }
+}
+
+/** \brief Handle a lane whose state left the plain transition table range
+ * after i bytes. Returns zero if the lane has dropped out of the lockstep. */
+static really_inline
+char mcclellanLaneEvent8(struct mcclellan_lane *l, size_t i) {
+    const struct mcclellan *m = l->m;
+    u32 s = l->s;
+
+    if (!s) {
+        l->done = 1;
+        return 0;
+    }
+
+    if (s >= m->accept_limit_8 && !mcclellanLaneReport(l, s, i)) {
+        l->done = 1;
+        return 0;
+    }
+
+    if (m->has_accel && s >= m->accel_limit_8 && get_aux(m, s)->accel_offset) {
+        /* acceleration may skip far ahead; continue on our own */
+        mcclellanLaneFinish(l, i, 0);
+        return 0;
+    }
+
+    return 1;
+}
+
+static really_inline
+char mcclellanLaneEvent16(struct mcclellan_lane *l, size_t i) {
+    const struct mcclellan *m = l->m;
+    u32 s = l->s;
+
+    if (!s) {
+        l->done = 1;
+        return 0;
+    }
+
+    if ((s & ACCEPT_FLAG) && !mcclellanLaneReport(l, s & STATE_MASK, i)) {
+        l->done = 1;
+        return 0;
+    }
+
+    l->s = s & STATE_MASK;
+
+    if ((s & ACCEL_FLAG) || l->s >= m->sherman_limit) {
+        /* acceleration and sherman states need the single block scan */
+        mcclellanLaneFinish(l, i, 1);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Advance n lanes in lockstep from byte i. Each step does one dependent
+ * table load per lane, so the loads of different lanes overlap. Any state
+ * which is dead, accepting, accelerable or (for 16-bit) a sherman state
+ * compares at or above the lane's limit after subtracting one, and is handled
+ * out of line.
+ *
+ * If same is set, all lanes run the same DFA and share its table pointer,
+ * alphabet shift and limit, which leaves enough registers free for eight
+ * lanes.
+ *
+ * Returns the number of bytes consumed by all lanes: either the shortest
+ * buffer has been exhausted or at least one lane has dropped out.
+ */
+static really_inline
+size_t mcclellanMulti_i(struct mcclellan_lane *lanes, const u32 n, size_t i,
+                        const char is16, const char same) {
+    u32 s[MCCLELLAN_MULTI_MAX];
+    const struct mcclellan *m[MCCLELLAN_MULTI_MAX];
+    const u8 *buf[MCCLELLAN_MULTI_MAX];
+    u32 as[MCCLELLAN_MULTI_MAX];
+    u32 limit[MCCLELLAN_MULTI_MAX];
+    size_t end = lanes[0].len;
+
+    for (u32 j = 0; j < n; j++) {
+        m[j] = lanes[j].m;
+        s[j] = lanes[j].s;
+        buf[j] = lanes[j].buf;
+        as[j] = m[j]->alphaShift;
+        if (is16) {
+            limit[j] = m[j]->sherman_limit - 1;
+        } else if (m[j]->has_accel) {
+            limit[j] = MIN(m[j]->accel_limit_8, m[j]->accept_limit_8) - 1;
+        } else {
+            limit[j] = m[j]->accept_limit_8 - 1;
+        }
+        end = MIN(end, lanes[j].len);
+    }
+
+    while (i < end) {
+        char ev = 0;
+        do {
+            for (u32 j = 0; j < n; j++) {
+                const u32 k = same ? 0 : j;
+                /* the successor table directly follows the header */
+                const void *succ = m[k] + 1;
+                size_t idx = ((size_t)s[j] << as[k]) + m[k]->remap[buf[j][i]];
+                s[j] = is16 ? ((const u16 *)succ)[idx]
+                            : ((const u8 *)succ)[idx];
+                ev |= s[j] - 1 >= limit[k];
+            }
+            i++;
+        } while (!ev && i < end);
+
+        if (!ev) {
+            break;
+        }
+
+        char dropped = 0;
+        for (u32 j = 0; j < n; j++) {
+            if (s[j] - 1 < limit[j]) {
+                continue;
+            }
+            lanes[j].s = s[j];
+            if (is16 ? !mcclellanLaneEvent16(&lanes[j], i)
+                     : !mcclellanLaneEvent8(&lanes[j], i)) {
+                dropped = 1;
+            }
+            s[j] = lanes[j].s;
+        }
+
+        if (dropped) {
+            break;
+        }
+    }
+
+    for (u32 j = 0; j < n; j++) {
+        if (!lanes[j].done) {
+            lanes[j].s = s[j];
+        }
+    }
+
+    return i;
+}
+
+/* Lanes running different DFAs each need a table pointer, shift and limit in
+ * registers as well as a state and buffer; beyond four of them the step is
+ * throughput bound on spills rather than latency bound on the loads. */
+#define MCCLELLAN_MULTI_MIXED_MAX 4
+
+#define DEFINE_MULTI_WIDTH(bits, is16, n, same, name)                          \
+    static never_inline                                                        \
+    size_t mcclellanMulti##bits##_##name##n(struct mcclellan_lane *lanes,      \
+                                            size_t i) {                        \
+        return mcclellanMulti_i(lanes, n, i, is16, same);                      \
+    }
+
+#define DEFINE_MULTI(bits, is16)                                               \
+    DEFINE_MULTI_WIDTH(bits, is16, 2, 0, mixed)                                \
+    DEFINE_MULTI_WIDTH(bits, is16, 3, 0, mixed)                                \
+    DEFINE_MULTI_WIDTH(bits, is16, 4, 0, mixed)                                \
+    DEFINE_MULTI_WIDTH(bits, is16, 2, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 3, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 4, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 5, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 6, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 7, 1, same)                                 \
+    DEFINE_MULTI_WIDTH(bits, is16, 8, 1, same)                                 \
+                                                                               \
+    static really_inline                                                       \
+    size_t mcclellanMulti##bits(struct mcclellan_lane *lanes, u32 n,           \
+                                char same, size_t i) {                         \
+        if (!same) {                                                           \
+            assert(n <= MCCLELLAN_MULTI_MIXED_MAX);                            \
+            switch (n) {                                                       \
+            case 2: return mcclellanMulti##bits##_mixed2(lanes, i);            \
+            case 3: return mcclellanMulti##bits##_mixed3(lanes, i);            \
+            default: return mcclellanMulti##bits##_mixed4(lanes, i);           \
+            }                                                                  \
+        }                                                                      \
+        switch (n) {                                                           \
+        case 2: return mcclellanMulti##bits##_same2(lanes, i);                 \
+        case 3: return mcclellanMulti##bits##_same3(lanes, i);                 \
+        case 4: return mcclellanMulti##bits##_same4(lanes, i);                 \
+        case 5: return mcclellanMulti##bits##_same5(lanes, i);                 \
+        case 6: return mcclellanMulti##bits##_same6(lanes, i);                 \
+        case 7: return mcclellanMulti##bits##_same7(lanes, i);                 \
+        default: return mcclellanMulti##bits##_same8(lanes, i);                \
+        }                                                                      \
+    }
+
+DEFINE_MULTI(8, 0)
+DEFINE_MULTI(16, 1)
+
+#undef DEFINE_MULTI
+#undef DEFINE_MULTI_WIDTH
+
+static really_inline
+char mcclellanLanesSame(const struct mcclellan_lane *lanes, u32 n) {
+    for (u32 j = 1; j < n; j++) {
+        if (lanes[j].m != lanes[0].m) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/** \brief Run a group of lanes of the same width until all have finished. */
+static never_inline
+void mcclellanMultiGroup(struct mcclellan_lane *lanes, u32 n, char is16) {
+    size_t i = 0;
+
+    for (;;) {
+        u32 live = 0;
+        for (u32 j = 0; j < n; j++) {
+            if (lanes[j].done) {
+                continue;
+            }
+            if (!lanes[j].s || lanes[j].len == i
+                || (is16 && lanes[j].s >= lanes[j].m->sherman_limit)) {
+                mcclellanLaneFinish(&lanes[j], i, is16);
+                continue;
+            }
+            lanes[live++] = lanes[j];
+        }
+        n = live;
+
+        DEBUG_PRINTF("%u lanes live at %zu\n", n, i);
+        if (n <= 1) {
+            if (n) {
+                mcclellanLaneFinish(&lanes[0], i, is16);
+            }
+            return;
+        }
+
+        char same = mcclellanLanesSame(lanes, n);
+        i = is16 ? mcclellanMulti16(lanes, n, same, i)
+                 : mcclellanMulti8(lanes, n, same, i);
+    }
+}
+
+/** \brief Add a block to a group, running the group once it is full. */
+static really_inline
+void mcclellanMultiAdd(struct mcclellan_lane *lanes, u32 *n,
+                       const struct mcclellan_multi_block *b, char is16) {
+    mcclellanLaneInit(&lanes[*n], b);
+    (*n)++;
+
+    if (*n == MCCLELLAN_MULTI_MAX
+        || (*n == MCCLELLAN_MULTI_MIXED_MAX
+            && !mcclellanLanesSame(lanes, *n))) {
+        mcclellanMultiGroup(lanes, *n, is16);
+        *n = 0;
+    }
+}
+
+void nfaExecMcClellanMulti_B(const struct mcclellan_multi_block *blocks,
+                             u32 count) {
+    struct mcclellan_lane lanes8[MCCLELLAN_MULTI_MAX];
+    struct mcclellan_lane lanes16[MCCLELLAN_MULTI_MAX];
+    u32 n8 = 0;
+    u32 n16 = 0;
+
+    for (u32 k = 0; k < count; k++) {
+        const struct mcclellan_multi_block *b = &blocks[k];
+        const struct mcclellan *m = getImplNfa(b->nfa);
+
+        if (b->nfa->type == MCCLELLAN_NFA_8) {
+            mcclellanMultiAdd(lanes8, &n8, b, 0);
+        } else if (!m->has_wide) {
+            assert(b->nfa->type == MCCLELLAN_NFA_16);
+            mcclellanMultiAdd(lanes16, &n16, b, 1);
+        } else {
+            /* wide states carry extra stream state; scan on our own */
+            nfaExecMcClellan16_B(b->nfa, b->offset, b->buffer, b->length,
+                                 b->cb, b->context);
+        }
+    }
+
+    if (n8) {
+        mcclellanMultiGroup(lanes8, n8, 0);
+    }
+    if (n16) {
+        mcclellanMultiGroup(lanes16, n16, 1);
+    }
+}
+
 char nfaExecMcClellan16_Q(const struct NFA *n, struct mq *q, s64a end) {
     u64a offset = q->offset;
     const u8 *buffer = q->buffer;
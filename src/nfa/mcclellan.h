@@ -35,6 +35,11 @@
 struct mq;
 struct NFA;
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
 // 8-bit McClellan
 
 char nfaExecMcClellan8_testEOD(const struct NFA *nfa, const char *state,
@@ -106,4 +111,41 @@ char nfaExecMcClellan8_B(const struct NFA *n, u64a offset, const u8 *buffer,
 char nfaExecMcClellan16_B(const struct NFA *n, u64a offset, const u8 *buffer,
                           size_t length, NfaCallback cb, void *context);
 
+/** \brief Maximum number of blocks advanced in lockstep by
+ * nfaExecMcClellanMulti_B(). */
+#define MCCLELLAN_MULTI_MAX 8
+
+/** \brief One independent block scan for nfaExecMcClellanMulti_B(). */
+struct mcclellan_multi_block {
+    const struct NFA *nfa; //!< MCCLELLAN_NFA_8 or MCCLELLAN_NFA_16
+    u64a offset;
+    const u8 *buffer;
+    size_t length;
+    NfaCallback cb;
+    void *context;
+};
+
+/**
+ * Multi-stream block mode call: equivalent to calling nfaExecMcClellan8_B or
+ * nfaExecMcClellan16_B on each block, but advances blocks of the same width
+ * one byte at a time in lockstep, so that their dependent transition loads
+ * overlap. Up to MCCLELLAN_MULTI_MAX blocks sharing one DFA, or four blocks
+ * of different DFAs, are interleaved at once.
+ *
+ * Matches from any one block are delivered in order; matches from different
+ * blocks may interleave. A block whose callback halts matching stops, the
+ * others carry on.
+ *
+ * Not used to scan several blocks through the Rose runtime: each block runs
+ * the full Rose program against a single scratch, which holds the match state
+ * (core_info, exhaustion, dedupe and SOM) of only one block at a time, so
+ * their engines cannot be advanced together.
+ */
+void nfaExecMcClellanMulti_B(const struct mcclellan_multi_block *blocks,
+                             u32 count);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -641,7 +641,7 @@ bytecode_ptr<NFA> mcclellanCompile16(dfa_info &info, const CompileContext &cc,
     size_t aux_size = sizeof(mstate_aux) * wide_limit;
 
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcclellan) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                     + ri->getReportListSize(), 32);
     size_t sherman_offset = ROUNDUP_16(accel_offset + accel_size);
@@ -706,7 +706,7 @@ bytecode_ptr<NFA> mcclellanCompile16(dfa_info &info, const CompileContext &cc,
 
         if (contains(accel_escape_info, i)) {
             this_aux->accel_offset = accel_offset;
-            accel_offset += info.strat.accelSize();
+            accel_offset += info.strat.stateAccelSize(accel_escape_info.at(i));
             assert(accel_offset + sizeof(NFA) <= sherman_offset);
             assert(ISALIGNED_N(accel_offset, alignof(union AccelAux)));
             info.strat.buildAccel(i, accel_escape_info.at(i),
@@ -736,7 +736,7 @@ bytecode_ptr<NFA> mcclellanCompile16(dfa_info &info, const CompileContext &cc,
 
         if (contains(accel_escape_info, i)) {
             this_aux->accel_offset = accel_offset;
-            accel_offset += info.strat.accelSize();
+            accel_offset += info.strat.stateAccelSize(accel_escape_info.at(i));
             assert(accel_offset + sizeof(NFA) <= sherman_offset);
             assert(ISALIGNED_N(accel_offset, alignof(union AccelAux)));
             info.strat.buildAccel(i, accel_escape_info.at(i),
@@ -937,7 +937,7 @@ bytecode_ptr<NFA> mcclellanCompile8(dfa_info &info, const CompileContext &cc,
     size_t tran_size = sizeof(u8) * (1 << info.getAlphaShift()) * info.size();
     size_t aux_size = sizeof(mstate_aux) * info.size();
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcclellan) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                      + ri->getReportListSize(), 32);
     size_t total_size = accel_offset + accel_size;
@@ -975,7 +975,7 @@ bytecode_ptr<NFA> mcclellanCompile8(dfa_info &info, const CompileContext &cc,
             u32 j = info.implId(i);
 
             aux[j].accel_offset = accel_offset;
-            accel_offset += info.strat.accelSize();
+            accel_offset += info.strat.stateAccelSize(accel_escape_info.at(i));
 
             info.strat.buildAccel(i, accel_escape_info.at(i),
                                   (void *)((char *)m + aux[j].accel_offset));
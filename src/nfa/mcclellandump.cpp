@@ -178,6 +178,9 @@ void dumpAccelText(FILE *f, const union AccelAux *accel) {
     case ACCEL_DSHUFTI:
         fprintf(f, ":SS");
         break;
+    case ACCEL_TSHUFTI:
+        fprintf(f, ":SSS");
+        break;
     case ACCEL_TRUFFLE:
         fprintf(f, ":M");
         break;
@@ -199,6 +202,7 @@ void dumpAccelDot(FILE *f, u16 i, const union AccelAux *accel) {
         break;
     case ACCEL_SHUFTI:
     case ACCEL_DSHUFTI:
+    case ACCEL_TSHUFTI:
     case ACCEL_TRUFFLE:
         fprintf(f, "%u [ color = darkgreen style=diagonals ];\n", i);
         break;
@@ -1418,7 +1418,7 @@ char nfaExecMcSheng16_expandState(UNUSED const struct NFA *nfa, void *dest,
     return 0;
 }
 
-#if defined(HAVE_AVX512VBMI)
+#if defined(HAVE_SHENG_WIDE)
 static really_inline
 const struct mstate_aux *get_aux64(const struct mcsheng64 *m, u32 s) {
     const char *nfa = (const char *)m - sizeof(struct NFA);
@@ -1492,7 +1492,7 @@ u32 doSheng64(const struct mcsheng64 *m, const u8 **c_inout, const u8 *soft_c_en
     assert(s_in); /* should not already be dead */
     assert(soft_c_end <= hard_c_end);
     DEBUG_PRINTF("s_in = %u (adjusted %u)\n", s_in, s_in - 1);
-    m512 s = set1_64x8(s_in - 1);
+    sheng_wide_t s = shengWideSet(s_in - 1);
     const u8 *c = *c_inout;
     const u8 *c_end = hard_c_end - SHENG_CHUNK + 1;
     if (!do_accel) {
@@ -1509,7 +1509,7 @@ u32 doSheng64(const struct mcsheng64 *m, const u8 **c_inout, const u8 *soft_c_en
      * extract a single copy of the state from the u32 for checking. */
     u32 sheng_stop_limit_x4 = sheng_stop_limit * 0x01010101;
 
-#if defined(HAVE_BMI2) && defined(ARCH_64_BIT)
+#if defined(HAVE_AVX512VBMI) && defined(HAVE_BMI2) && defined(ARCH_64_BIT)
     u32 sheng_limit_x4 = sheng_limit * 0x01010101;
     m512 simd_stop_limit = set1_16x32(sheng_stop_limit_x4);
     m512 accel_delta = set1_64x8(sheng_limit - sheng_stop_limit);
@@ -1518,9 +1518,8 @@ u32 doSheng64(const struct mcsheng64 *m, const u8 **c_inout, const u8 *soft_c_en
 #endif
 
 #define SHENG64_SINGLE_ITER do {                                             \
-        m512 succ_mask = masks[*(c++)];                                      \
-        s = vpermb512(s, succ_mask);                                         \
-        u32 s_gpr_x4 = movd512(s); /* convert to u8 */                       \
+        s = shengWideStep64(s, &masks[*(c++)]);                              \
+        u32 s_gpr_x4 = shengWideMovd(s); /* convert to u8 */                 \
         DEBUG_PRINTF("c %hhu (%c) --> s %u\n", c[-1], c[-1], s_gpr_x4);      \
         if (s_gpr_x4 >= sheng_stop_limit_x4) {                               \
             s_gpr = s_gpr_x4;                                                \
@@ -1530,7 +1529,7 @@ u32 doSheng64(const struct mcsheng64 *m, const u8 **c_inout, const u8 *soft_c_en
 
     u8 s_gpr;
     while (c < c_end) {
-#if defined(HAVE_BMI2) && defined(ARCH_64_BIT)
+#if defined(HAVE_AVX512VBMI) && defined(HAVE_BMI2) && defined(ARCH_64_BIT)
         /* This version uses pext for efficiently bitbashing out scaled
          * versions of the bytes to process from a u64a */
 
@@ -1645,7 +1644,7 @@ u32 doSheng64(const struct mcsheng64 *m, const u8 **c_inout, const u8 *soft_c_en
 
     assert(c >= soft_c_end);
 
-    s_gpr = movq512(s);
+    s_gpr = shengWideMovd(s);
 exit:
     assert(c <= hard_c_end);
     DEBUG_PRINTF("%zu from end; s %hhu\n", c_end - c, s_gpr);
@@ -2745,4 +2744,4 @@ char nfaExecMcSheng64_16_expandState(UNUSED const struct NFA *nfa, void *dest,
     *(u16 *)dest = unaligned_load_u16(src);
     return 0;
 }
-#endif
+#endif // end of HAVE_SHENG_WIDE
@@ -30,6 +30,7 @@
 #define MCSHENG_H
 
 #include "callback.h"
+#include "sheng_wide.h"
 #include "ue2common.h"
 
 struct mq;
@@ -80,7 +81,7 @@ char nfaExecMcSheng16_expandState(const struct NFA *nfa, void *dest,
 
 #define nfaExecMcSheng16_B_Reverse NFA_API_NO_IMPL
 #define nfaExecMcSheng16_zombie_status NFA_API_ZOMBIE_NO_IMPL
-#if defined(HAVE_AVX512VBMI)
+#if defined(HAVE_SHENG_WIDE)
 /* 64-8 bit Sheng-McClellan hybrid  */
 char nfaExecMcSheng64_8_testEOD(const struct NFA *nfa, const char *state,
                                 const char *streamState, u64a offset,
@@ -123,7 +124,7 @@ char nfaExecMcSheng64_16_expandState(const struct NFA *nfa, void *dest,
                                      const void *src, u64a offset, u8 key);
 #define nfaExecMcSheng64_16_B_Reverse NFA_API_NO_IMPL
 #define nfaExecMcSheng64_16_zombie_status NFA_API_ZOMBIE_NO_IMPL
-#else // !HAVE_AVX512VBMI
+#else // !HAVE_SHENG_WIDE
 #define nfaExecMcSheng64_8_B_Reverse NFA_API_NO_IMPL
 #define nfaExecMcSheng64_8_zombie_status NFA_API_ZOMBIE_NO_IMPL
 #define nfaExecMcSheng64_8_Q NFA_API_NO_IMPL
@@ -152,6 +153,6 @@ char nfaExecMcSheng64_16_expandState(const struct NFA *nfa, void *dest,
 #define nfaExecMcSheng64_16_testEOD NFA_API_NO_IMPL
 #define nfaExecMcSheng64_16_reportCurrent NFA_API_NO_IMPL
 
-#endif //end of HAVE_AVX512VBMI
+#endif //end of HAVE_SHENG_WIDE
 
 #endif
@@ -663,7 +663,7 @@ void fill_in_aux_info(NFA *nfa, const dfa_info &info,
         fillInAux(this_aux, i, info, reports, reports_eod, reportOffsets);
         if (contains(accel_escape_info, i)) {
             this_aux->accel_offset = accel_offset;
-            accel_offset += info.strat.accelSize();
+            accel_offset += info.strat.stateAccelSize(accel_escape_info.at(i));
             assert(accel_offset <= accel_end_offset);
             assert(ISALIGNED_N(accel_offset, alignof(union AccelAux)));
             info.strat.buildAccel(i, accel_escape_info.at(i),
@@ -737,7 +737,7 @@ void fill_in_aux_info64(NFA *nfa, const dfa_info &info,
         fillInAux(this_aux, i, info, reports, reports_eod, reportOffsets);
         if (contains(accel_escape_info, i)) {
             this_aux->accel_offset = accel_offset;
-            accel_offset += info.strat.accelSize();
+            accel_offset += info.strat.stateAccelSize(accel_escape_info.at(i));
             assert(accel_offset <= accel_end_offset);
             assert(ISALIGNED_N(accel_offset, alignof(union AccelAux)));
             info.strat.buildAccel(i, accel_escape_info.at(i),
@@ -1047,7 +1047,7 @@ bytecode_ptr<NFA> mcshengCompile16(dfa_info &info, dstate_id_t sheng_end,
     size_t aux_size = sizeof(mstate_aux) * info.size();
 
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcsheng) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                     + ri->getReportListSize(), 32);
     size_t sherman_offset = ROUNDUP_16(accel_offset + accel_size);
@@ -1201,7 +1201,7 @@ bytecode_ptr<NFA> mcsheng64Compile16(dfa_info&info, dstate_id_t sheng_end,
     size_t aux_size = sizeof(mstate_aux) * info.size();
 
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcsheng64) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                     + ri->getReportListSize(), 32);
     size_t sherman_offset = ROUNDUP_16(accel_offset + accel_size);
@@ -1323,7 +1323,7 @@ bytecode_ptr<NFA> mcshengCompile8(dfa_info &info, dstate_id_t sheng_end,
     size_t tran_size = sizeof(u8) * (1 << info.getAlphaShift()) * normal_count;
     size_t aux_size = sizeof(mstate_aux) * info.size();
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcsheng) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                      + ri->getReportListSize(), 32);
     size_t total_size = accel_offset + accel_size;
@@ -1376,7 +1376,7 @@ bytecode_ptr<NFA> mcsheng64Compile8(dfa_info &info, dstate_id_t sheng_end,
     size_t tran_size = sizeof(u8) * (1 << info.getAlphaShift()) * normal_count;
     size_t aux_size = sizeof(mstate_aux) * info.size();
     size_t aux_offset = ROUNDUP_16(sizeof(NFA) + sizeof(mcsheng64) + tran_size);
-    size_t accel_size = info.strat.accelSize() * accel_escape_info.size();
+    size_t accel_size = info.strat.totalAccelSize(accel_escape_info);
     size_t accel_offset = ROUNDUP_N(aux_offset + aux_size
                                     + ri->getReportListSize(), 32);
     size_t total_size = accel_offset + accel_size;
@@ -1465,8 +1465,8 @@ bytecode_ptr<NFA> mcshengCompile64(raw_dfa &raw, const CompileContext &cc,
         return nullptr;
     }
 
-    if (!cc.target_info.has_avx512vbmi()) {
-        DEBUG_PRINTF("McSheng64 failed, no HS_CPU_FEATURES_AVX512VBMI!\n");
+    if (!cc.target_info.has_wide_sheng()) {
+        DEBUG_PRINTF("McSheng64 failed, not supported on this target!\n");
         return nullptr;
     }
 
@@ -305,6 +305,7 @@ void dumpAccelDot(FILE *f, u16 i, const union AccelAux *accel) {
         break;
     case ACCEL_SHUFTI:
     case ACCEL_DSHUFTI:
+    case ACCEL_TSHUFTI:
     case ACCEL_TRUFFLE:
         fprintf(f, "%u [ color = darkgreen style=diagonals ];\n", i);
         break;
@@ -34,6 +34,7 @@
 
 #include "nfa_api_queue.h"
 #include "nfa_internal.h"
+#include "scratch.h"
 #include "ue2common.h"
 
 // Engine implementations.
@@ -70,6 +71,8 @@
         DISPATCH_CASE(LIMEX_NFA_256, LimEx256, dbnt_func);                     \
         DISPATCH_CASE(LIMEX_NFA_384, LimEx384, dbnt_func);                     \
         DISPATCH_CASE(LIMEX_NFA_512, LimEx512, dbnt_func);                     \
+        DISPATCH_CASE(LIMEX_NFA_768, LimEx768, dbnt_func);                     \
+        DISPATCH_CASE(LIMEX_NFA_1024, LimEx1024, dbnt_func);                   \
         DISPATCH_CASE(MCCLELLAN_NFA_8, McClellan8, dbnt_func);                 \
         DISPATCH_CASE(MCCLELLAN_NFA_16, McClellan16, dbnt_func);               \
         DISPATCH_CASE(GOUGH_NFA_8, Gough8, dbnt_func);                         \
@@ -114,6 +117,27 @@ char nfaQueueInitState(const struct NFA *nfa, struct mq *q) {
     return 0;
 }
 
+#ifdef SCAN_PROFILE
+/** \brief Index of the given queue in scratch, or ~0U if it is not one of
+ * the scratch queues (such as a Tamarama subengine's queue). */
+static really_inline
+u32 profileQueueIndex(const struct mq *q) {
+    const struct hs_scratch *scratch = q->scratch;
+    uintptr_t base = (uintptr_t)scratch->queues;
+    uintptr_t qp = (uintptr_t)q;
+    if (qp < base || qp >= base + scratch->queueCount * sizeof(struct mq)) {
+        return ~0U;
+    }
+    return (u32)((qp - base) / sizeof(struct mq));
+}
+
+#define PROFILE_QUEUE_BEGIN(q)                                                 \
+    SCAN_PROFILE_QUEUE_BEGIN((q)->scratch->core_info.rose,                     \
+                             profileQueueIndex(q))
+#else
+#define PROFILE_QUEUE_BEGIN(q)
+#endif
+
 static really_inline
 char nfaQueueExec_i(const struct NFA *nfa, struct mq *q, s64a end) {
     DISPATCH_BY_NFA_TYPE(_Q(nfa, q, end));
@@ -127,11 +151,17 @@ char nfaQueueExec2_i(const struct NFA *nfa, struct mq *q, s64a end) {
 }
 
 char nfaQueueExec_raw(const struct NFA *nfa, struct mq *q, s64a end) {
-    return nfaQueueExec_i(nfa, q, end);
+    PROFILE_QUEUE_BEGIN(q);
+    char rv = nfaQueueExec_i(nfa, q, end);
+    SCAN_PROFILE_END();
+    return rv;
 }
 
 char nfaQueueExec2_raw(const struct NFA *nfa, struct mq *q, s64a end) {
-    return nfaQueueExec2_i(nfa, q, end);
+    PROFILE_QUEUE_BEGIN(q);
+    char rv = nfaQueueExec2_i(nfa, q, end);
+    SCAN_PROFILE_END();
+    return rv;
 }
 
 static really_inline
@@ -238,7 +268,9 @@ char nfaQueueExec(const struct NFA *nfa, struct mq *q, s64a end) {
         return 0;
     }
 
+    PROFILE_QUEUE_BEGIN(q);
     char rv = nfaQueueExec_i(nfa, q, end);
+    SCAN_PROFILE_END();
 
 #ifdef DEBUG
     debugQueue(q);
@@ -287,7 +319,9 @@ char nfaQueueExecToMatch(const struct NFA *nfa, struct mq *q, s64a end) {
         return 0;
     }
 
+    PROFILE_QUEUE_BEGIN(q);
     char rv = nfaQueueExec2_i(nfa, q, end);
+    SCAN_PROFILE_END();
     assert(!q->report_current);
     DEBUG_PRINTF("returned rv=%d, q_trimmed=%d\n", rv, q_trimmed);
     if (rv == MO_MATCHES_PENDING) {
@@ -330,7 +364,10 @@ char nfaQueueExecRose(const struct NFA *nfa, struct mq *q, ReportID r) {
     assert(ISALIGNED_CL(nfa) && ISALIGNED_CL(getImplNfa(nfa)));
     assert(!q->report_current);
 
-    return nfaQueueExecRose_i(nfa, q, r);
+    PROFILE_QUEUE_BEGIN(q);
+    char rv = nfaQueueExecRose_i(nfa, q, r);
+    SCAN_PROFILE_END();
+    return rv;
 }
 
 char nfaBlockExecReverse(const struct NFA *nfa, u64a offset, const u8 *buf,
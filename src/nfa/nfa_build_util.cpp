@@ -205,6 +205,8 @@ MAKE_LIMEX_TRAITS(128, alignof(m128))
 MAKE_LIMEX_TRAITS(256, alignof(m256))
 MAKE_LIMEX_TRAITS(384, alignof(m384))
 MAKE_LIMEX_TRAITS(512, alignof(m512))
+MAKE_LIMEX_TRAITS(768, alignof(m768))
+MAKE_LIMEX_TRAITS(1024, alignof(m1024))
 
 template<> struct NFATraits<MCCLELLAN_NFA_8> {
     UNUSED static const char *name;
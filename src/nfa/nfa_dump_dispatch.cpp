@@ -66,6 +66,8 @@ namespace ue2 {
         DISPATCH_CASE(LIMEX_NFA_256, LimEx256, dbnt_func);                     \
         DISPATCH_CASE(LIMEX_NFA_384, LimEx384, dbnt_func);                     \
         DISPATCH_CASE(LIMEX_NFA_512, LimEx512, dbnt_func);                     \
+        DISPATCH_CASE(LIMEX_NFA_768, LimEx768, dbnt_func);                     \
+        DISPATCH_CASE(LIMEX_NFA_1024, LimEx1024, dbnt_func);                   \
         DISPATCH_CASE(MCCLELLAN_NFA_8, McClellan8, dbnt_func);                 \
         DISPATCH_CASE(MCCLELLAN_NFA_16, McClellan16, dbnt_func);               \
         DISPATCH_CASE(GOUGH_NFA_8, Gough8, dbnt_func);                         \
@@ -58,6 +58,8 @@ enum NFAEngineType {
     LIMEX_NFA_256,
     LIMEX_NFA_384,
     LIMEX_NFA_512,
+    LIMEX_NFA_768,
+    LIMEX_NFA_1024,
     MCCLELLAN_NFA_8,    /**< magic pseudo nfa */
     MCCLELLAN_NFA_16,   /**< magic pseudo nfa */
     GOUGH_NFA_8,        /**< magic pseudo nfa */
@@ -212,6 +214,8 @@ static really_inline int isNfaType(u8 t) {
     case LIMEX_NFA_256:
     case LIMEX_NFA_384:
     case LIMEX_NFA_512:
+    case LIMEX_NFA_768:
+    case LIMEX_NFA_1024:
         return 1;
     default:
         break;
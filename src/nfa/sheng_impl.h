@@ -96,7 +96,7 @@ char SHENG_IMPL(u8 *state, NfaCallback cb, void *ctxt, const struct sheng *s,
     return MO_CONTINUE_MATCHING;
 }
 
-#if defined(HAVE_AVX512VBMI)
+#if defined(HAVE_SHENG_WIDE)
 static really_inline
 char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
                   const struct sheng32 *s,
@@ -114,14 +114,13 @@ char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
     }
     DEBUG_PRINTF("Scanning %lli bytes\n", (s64a)(end - start));
 
-    m512 cur_state = set1_64x8(*state);
+    sheng_wide_t cur_state = shengWideSet(*state);
     const m512 *masks = s->succ_masks;
 
     while (likely(cur_buf != end)) {
         const u8 c = *cur_buf;
-        const m512 succ_mask = masks[c];
-        cur_state = vpermb512(cur_state, succ_mask);
-        const u8 tmp = movd512(cur_state);
+        cur_state = shengWideStep32(cur_state, &masks[c]);
+        const u8 tmp = shengWideMovd(cur_state);
 
         DEBUG_PRINTF("c: %02hhx '%c'\n", c, ourisprint(c) ? c : '?');
         DEBUG_PRINTF("s: %u (flag: %u)\n", tmp & SHENG32_STATE_MASK,
@@ -153,7 +152,7 @@ char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         }
         cur_buf++;
     }
-    *state = movd512(cur_state);
+    *state = shengWideMovd(cur_state);
     *scan_end = cur_buf;
     return MO_CONTINUE_MATCHING;
 }
@@ -175,14 +174,13 @@ char SHENG64_IMPL(u8 *state, NfaCallback cb, void *ctxt,
     }
     DEBUG_PRINTF("Scanning %lli bytes\n", (s64a)(end - start));
 
-    m512 cur_state = set1_64x8(*state);
+    sheng_wide_t cur_state = shengWideSet(*state);
     const m512 *masks = s->succ_masks;
 
     while (likely(cur_buf != end)) {
         const u8 c = *cur_buf;
-        const m512 succ_mask = masks[c];
-        cur_state = vpermb512(cur_state, succ_mask);
-        const u8 tmp = movd512(cur_state);
+        cur_state = shengWideStep64(cur_state, &masks[c]);
+        const u8 tmp = shengWideMovd(cur_state);
 
         DEBUG_PRINTF("c: %02hhx '%c'\n", c, ourisprint(c) ? c : '?');
         DEBUG_PRINTF("s: %u (flag: %u)\n", tmp & SHENG64_STATE_MASK,
@@ -214,7 +212,7 @@ char SHENG64_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         }
         cur_buf++;
     }
-    *state = movd512(cur_state);
+    *state = shengWideMovd(cur_state);
     *scan_end = cur_buf;
     return MO_CONTINUE_MATCHING;
 }
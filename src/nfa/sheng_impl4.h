@@ -283,7 +283,7 @@ char SHENG_IMPL(u8 *state, NfaCallback cb, void *ctxt, const struct sheng *s,
     return MO_CONTINUE_MATCHING;
 }
 
-#if defined(HAVE_AVX512VBMI)
+#if defined(HAVE_SHENG_WIDE)
 static really_inline
 char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
                   const struct sheng32 *s,
@@ -320,7 +320,7 @@ char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         return MO_CONTINUE_MATCHING;
     }
 
-    m512 cur_state = set1_64x8(*state);
+    sheng_wide_t cur_state = shengWideSet(*state);
     const m512 *masks = s->succ_masks;
 
     while (likely(end - cur_buf >= 4)) {
@@ -333,21 +333,17 @@ char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         const u8 c3 = *b3;
         const u8 c4 = *b4;
 
-        const m512 succ_mask1 = masks[c1];
-        cur_state = vpermb512(cur_state, succ_mask1);
-        const u8 a1 = movd512(cur_state);
+        cur_state = shengWideStep32(cur_state, &masks[c1]);
+        const u8 a1 = shengWideMovd(cur_state);
 
-        const m512 succ_mask2 = masks[c2];
-        cur_state = vpermb512(cur_state, succ_mask2);
-        const u8 a2 = movd512(cur_state);
+        cur_state = shengWideStep32(cur_state, &masks[c2]);
+        const u8 a2 = shengWideMovd(cur_state);
 
-        const m512 succ_mask3 = masks[c3];
-        cur_state = vpermb512(cur_state, succ_mask3);
-        const u8 a3 = movd512(cur_state);
+        cur_state = shengWideStep32(cur_state, &masks[c3]);
+        const u8 a3 = shengWideMovd(cur_state);
 
-        const m512 succ_mask4 = masks[c4];
-        cur_state = vpermb512(cur_state, succ_mask4);
-        const u8 a4 = movd512(cur_state);
+        cur_state = shengWideStep32(cur_state, &masks[c4]);
+        const u8 a4 = shengWideMovd(cur_state);
 
         DEBUG_PRINTF("c: %02hhx '%c'\n", c1, ourisprint(c1) ? c1 : '?');
         DEBUG_PRINTF("s: %u (flag: %u)\n", a1 & SHENG32_STATE_MASK,
@@ -517,7 +513,7 @@ char SHENG32_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         };
         cur_buf += 4;
     }
-    *state = movd512(cur_state);
+    *state = shengWideMovd(cur_state);
     *scan_end = cur_buf;
     return MO_CONTINUE_MATCHING;
 }
@@ -542,7 +538,7 @@ char SHENG64_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         return MO_CONTINUE_MATCHING;
     }
 
-    m512 cur_state = set1_64x8(*state);
+    sheng_wide_t cur_state = shengWideSet(*state);
     const m512 *masks = s->succ_masks;
 
     while (likely(end - cur_buf >= 4)) {
@@ -555,21 +551,17 @@ char SHENG64_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         const u8 c3 = *b3;
         const u8 c4 = *b4;
 
-        const m512 succ_mask1 = masks[c1];
-        cur_state = vpermb512(cur_state, succ_mask1);
-        const u8 a1 = movd512(cur_state);
+        cur_state = shengWideStep64(cur_state, &masks[c1]);
+        const u8 a1 = shengWideMovd(cur_state);
 
-        const m512 succ_mask2 = masks[c2];
-        cur_state = vpermb512(cur_state, succ_mask2);
-        const u8 a2 = movd512(cur_state);
+        cur_state = shengWideStep64(cur_state, &masks[c2]);
+        const u8 a2 = shengWideMovd(cur_state);
 
-        const m512 succ_mask3 = masks[c3];
-        cur_state = vpermb512(cur_state, succ_mask3);
-        const u8 a3 = movd512(cur_state);
+        cur_state = shengWideStep64(cur_state, &masks[c3]);
+        const u8 a3 = shengWideMovd(cur_state);
 
-        const m512 succ_mask4 = masks[c4];
-        cur_state = vpermb512(cur_state, succ_mask4);
-        const u8 a4 = movd512(cur_state);
+        cur_state = shengWideStep64(cur_state, &masks[c4]);
+        const u8 a4 = shengWideMovd(cur_state);
 
         DEBUG_PRINTF("c: %02hhx '%c'\n", c1, ourisprint(c1) ? c1 : '?');
         DEBUG_PRINTF("s: %u (flag: %u)\n", a1 & SHENG64_STATE_MASK,
@@ -703,7 +695,7 @@ char SHENG64_IMPL(u8 *state, NfaCallback cb, void *ctxt,
         }
         cur_buf += 4;
     }
-    *state = movd512(cur_state);
+    *state = shengWideMovd(cur_state);
     *scan_end = cur_buf;
     return MO_CONTINUE_MATCHING;
 }
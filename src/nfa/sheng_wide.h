@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Successor lookup for the 32 and 64 state Sheng engines (Sheng32,
+ * Sheng64 and the sheng region of McSheng64).
+ *
+ * Each input character has a 64 byte successor mask, indexed by the low six
+ * bits of the current state. The state is carried in whatever register makes
+ * that lookup cheapest:
+ *
+ *  - AVX512VBMI: broadcast in a m512, stepped with one vpermb.
+ *  - AVX2: in a general purpose register, stepped with a byte load from the
+ *    mask. Emulating the 64 byte permute with in-lane shuffles, blends and a
+ *    lane swap has a longer dependency chain than the load.
+ *
+ * shengWideMovd() returns the state replicated into four bytes, as movd does
+ * on the broadcast register, so that callers can compare against x4 limits.
+ */
+
+#ifndef SHENG_WIDE_H_
+#define SHENG_WIDE_H_
+
+#include "ue2common.h"
+#include "util/arch.h"
+
+#if defined(HAVE_AVX512VBMI) || defined(HAVE_AVX2)
+#define HAVE_SHENG_WIDE
+#endif
+
+#if defined(HAVE_SHENG_WIDE)
+
+#include "util/simd_utils.h"
+
+#if defined(HAVE_AVX512VBMI)
+
+typedef m512 sheng_wide_t;
+
+static really_inline
+sheng_wide_t shengWideSet(u8 s) {
+    return set1_64x8(s);
+}
+
+static really_inline
+sheng_wide_t shengWideStep32(sheng_wide_t s, const m512 *succ) {
+    return vpermb512(s, *succ);
+}
+
+static really_inline
+sheng_wide_t shengWideStep64(sheng_wide_t s, const m512 *succ) {
+    return vpermb512(s, *succ);
+}
+
+static really_inline
+u32 shengWideMovd(sheng_wide_t s) {
+    return movd512(s);
+}
+
+#else
+
+typedef u8 sheng_wide_t;
+
+static really_inline
+sheng_wide_t shengWideSet(u8 s) {
+    return s;
+}
+
+static really_inline
+sheng_wide_t shengWideStep32(sheng_wide_t s, const m512 *succ) {
+    return ((const u8 *)succ)[s & 0x1f];
+}
+
+static really_inline
+sheng_wide_t shengWideStep64(sheng_wide_t s, const m512 *succ) {
+    return ((const u8 *)succ)[s & 0x3f];
+}
+
+static really_inline
+u32 shengWideMovd(sheng_wide_t s) {
+    return s * 0x01010101U;
+}
+
+#endif
+
+#endif // HAVE_SHENG_WIDE
+
+#endif // SHENG_WIDE_H_
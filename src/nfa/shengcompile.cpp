@@ -402,7 +402,8 @@ void fillAccelAux(struct NFA *n, dfa_info &info,
                 (sstate_aux *)((char *)n + s->aux_offset) + state_id;
             saux->accel = offset;
             DEBUG_PRINTF("Accel offset: %u\n", offset);
-            offset += ROUNDUP_N(sizeof(AccelAux), alignof(AccelAux));
+            offset += ROUNDUP_N(info.strat.stateAccelSize(accelInfo[state_id]),
+                                alignof(AccelAux));
         }
     }
 }
@@ -653,7 +654,7 @@ bytecode_ptr<NFA> shengCompile_int(raw_dfa &raw, const CompileContext &cc,
         strat.gatherReports(reports, eod_reports, &isSingle, &single_report);
 
     u32 total_aux = sizeof(sstate_aux) * info.size();
-    u32 total_accel = strat.accelSize() * accelInfo.size();
+    u32 total_accel = verify_u32(strat.totalAccelSize(accelInfo));
     u32 total_reports = ri->getReportListSize();
 
     u32 reports_offset = nfa_size + total_aux;
@@ -730,8 +731,8 @@ bytecode_ptr<NFA> sheng32Compile(raw_dfa &raw, const CompileContext &cc,
         return nullptr;
     }
 
-    if (!cc.target_info.has_avx512vbmi()) {
-        DEBUG_PRINTF("Sheng32 failed, no HS_CPU_FEATURES_AVX512VBMI!\n");
+    if (!cc.target_info.has_wide_sheng()) {
+        DEBUG_PRINTF("Sheng32 failed, not supported on this target!\n");
         return nullptr;
     }
 
@@ -762,8 +763,8 @@ bytecode_ptr<NFA> sheng64Compile(raw_dfa &raw, const CompileContext &cc,
         return nullptr;
     }
 
-    if (!cc.target_info.has_avx512vbmi()) {
-        DEBUG_PRINTF("Sheng64 failed, no HS_CPU_FEATURES_AVX512VBMI!\n");
+    if (!cc.target_info.has_wide_sheng()) {
+        DEBUG_PRINTF("Sheng64 failed, not supported on this target!\n");
         return nullptr;
     }
 
@@ -66,6 +66,24 @@ const u8 *shuftiRevSlow(const u8 *lo, const u8 *hi, const u8 *buf,
     return buf_end;
 }
 
+/** \brief Naive byte-by-byte implementation of the triple-byte variant. */
+static really_inline
+const u8 *shuftiTripleFwdSlow(const u8 *lo1, const u8 *hi1, const u8 *lo2,
+                              const u8 *hi2, const u8 *lo3, const u8 *hi3,
+                              const u8 *buf, const u8 *buf_end) {
+    for (; buf < buf_end; ++buf) {
+        u8 c1 = buf[0];
+        u8 c2 = buf[1];
+        u8 c3 = buf[2];
+        u8 t = lo1[c1 & 0xf] | hi1[c1 >> 4] | lo2[c2 & 0xf] | hi2[c2 >> 4] |
+               lo3[c3 & 0xf] | hi3[c3 >> 4];
+        if (t != 0xff) {
+            break;
+        }
+    }
+    return buf;
+}
+
 #ifdef HAVE_SVE
 #include "shufti_sve.hpp"
 #else
@@ -54,6 +54,19 @@ const u8 *shuftiDoubleExec(m128 mask1_lo, m128 mask1_hi,
                            m128 mask2_lo, m128 mask2_hi,
                            const u8 *buf, const u8 *buf_end);
 
+/**
+ * \brief Triple-byte variant: returns the first position in [buf, buf_end) at
+ * which a byte triple matching one of the mask buckets starts, or buf_end if
+ * there is none.
+ *
+ * Note: the second and third bytes of a triple starting just before buf_end
+ * lie beyond it, so the two bytes following buf_end must be readable.
+ */
+const u8 *shuftiTripleExec(m128 mask1_lo, m128 mask1_hi,
+                           m128 mask2_lo, m128 mask2_hi,
+                           m128 mask3_lo, m128 mask3_hi,
+                           const u8 *buf, const u8 *buf_end);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,11 @@ const SuperVector<S> blockSingleMask(SuperVector<S> mask_lo, SuperVector<S> mask
 template <uint16_t S>
 static really_inline
 SuperVector<S> blockDoubleMask(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi, SuperVector<S> mask2_lo, SuperVector<S> mask2_hi, SuperVector<S> chars);
+template <uint16_t S>
+static really_inline
+SuperVector<S> blockTripleMask(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi, SuperVector<S> mask2_lo, SuperVector<S> mask2_hi,
+                               SuperVector<S> mask3_lo, SuperVector<S> mask3_hi, SuperVector<S> chars1, SuperVector<S> chars2,
+                               SuperVector<S> chars3);
 
 #if defined(ARCH_IA32) || defined(ARCH_X86_64)
 #include "x86/shufti.hpp"
@@ -85,6 +90,20 @@ const u8 *fwdBlockDouble(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi, Super
     return first_zero_match_inverted<S>(buf, mask);
 }
 
+template <uint16_t S>
+static really_inline
+const u8 *fwdBlockTriple(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi, SuperVector<S> mask2_lo, SuperVector<S> mask2_hi,
+                         SuperVector<S> mask3_lo, SuperVector<S> mask3_hi, const u8 *d) {
+    // each lane looks at the triple starting at its own position, so the
+    // second and third bytes come from loads offset by one and two
+    SuperVector<S> chars1 = SuperVector<S>::loadu(d);
+    SuperVector<S> chars2 = SuperVector<S>::loadu(d + 1);
+    SuperVector<S> chars3 = SuperVector<S>::loadu(d + 2);
+    SuperVector<S> mask = blockTripleMask(mask1_lo, mask1_hi, mask2_lo, mask2_hi, mask3_lo, mask3_hi, chars1, chars2, chars3);
+
+    return first_zero_match_inverted<S>(d, mask);
+}
+
 template <uint16_t S>
 const u8 *shuftiExecReal(m128 mask_lo, m128 mask_hi, const u8 *buf, const u8 *buf_end) {
     assert(buf && buf_end);
@@ -257,6 +276,53 @@ const u8 *shuftiDoubleExecReal(m128 mask1_lo, m128 mask1_hi, m128 mask2_lo, m128
     return buf_end;
 }
 
+template <uint16_t S>
+const u8 *shuftiTripleExecReal(m128 mask1_lo, m128 mask1_hi, m128 mask2_lo, m128 mask2_hi,
+                               m128 mask3_lo, m128 mask3_hi, const u8 *buf, const u8 *buf_end) {
+    assert(buf && buf_end);
+    assert(buf + S <= buf_end);
+    DEBUG_PRINTF("tshufti %p len %zu\n", buf, buf_end - buf);
+
+    const SuperVector<S> wide_mask1_lo(mask1_lo);
+    const SuperVector<S> wide_mask1_hi(mask1_hi);
+    const SuperVector<S> wide_mask2_lo(mask2_lo);
+    const SuperVector<S> wide_mask2_hi(mask2_hi);
+    const SuperVector<S> wide_mask3_lo(mask3_lo);
+    const SuperVector<S> wide_mask3_hi(mask3_hi);
+
+    const u8 *d = buf;
+    const u8 *rv;
+
+    __builtin_prefetch(d +   64);
+    __builtin_prefetch(d + 2*64);
+    __builtin_prefetch(d + 3*64);
+    __builtin_prefetch(d + 4*64);
+
+    // no aligned peel here: two of the three loads are unaligned whatever
+    // we do, so just walk the buffer in vector-sized steps
+    while (d + S <= buf_end) {
+        __builtin_prefetch(d + 64);
+        DEBUG_PRINTF("d %p \n", d);
+        rv = fwdBlockTriple(wide_mask1_lo, wide_mask1_hi, wide_mask2_lo, wide_mask2_hi,
+                            wide_mask3_lo, wide_mask3_hi, d);
+        if (rv) return rv;
+        d += S;
+    }
+
+    DEBUG_PRINTF("tail d %p e %p \n", d, buf_end);
+    // finish off tail with an overlapping block, everything before d is
+    // already known not to match
+
+    if (d != buf_end) {
+        rv = fwdBlockTriple(wide_mask1_lo, wide_mask1_hi, wide_mask2_lo, wide_mask2_hi,
+                            wide_mask3_lo, wide_mask3_hi, buf_end - S);
+        DEBUG_PRINTF("rv %p \n", rv);
+        if (rv && rv < buf_end) return rv;
+    }
+
+    return buf_end;
+}
+
 const u8 *shuftiExec(m128 mask_lo, m128 mask_hi, const u8 *buf,
                       const u8 *buf_end) {
   if (buf_end - buf < VECTORSIZE) {
@@ -278,3 +344,17 @@ const u8 *shuftiDoubleExec(m128 mask1_lo, m128 mask1_hi,
                             const u8 *buf, const u8 *buf_end) {
     return shuftiDoubleExecReal<VECTORSIZE>(mask1_lo, mask1_hi, mask2_lo, mask2_hi, buf, buf_end);
 }
+
+const u8 *shuftiTripleExec(m128 mask1_lo, m128 mask1_hi,
+                           m128 mask2_lo, m128 mask2_hi,
+                           m128 mask3_lo, m128 mask3_hi,
+                           const u8 *buf, const u8 *buf_end) {
+    if (buf_end - buf < VECTORSIZE) {
+        return shuftiTripleFwdSlow((const u8 *)&mask1_lo, (const u8 *)&mask1_hi,
+                                   (const u8 *)&mask2_lo, (const u8 *)&mask2_hi,
+                                   (const u8 *)&mask3_lo, (const u8 *)&mask3_hi,
+                                   buf, buf_end);
+    }
+    return shuftiTripleExecReal<VECTORSIZE>(mask1_lo, mask1_hi, mask2_lo, mask2_hi,
+                                            mask3_lo, mask3_hi, buf, buf_end);
+}
@@ -239,4 +239,54 @@ const u8 *shuftiDoubleExec(m128 mask1_lo, m128 mask1_hi,
     const u8 *ptr = dshuftiSearch(sve_mask1_lo, sve_mask1_hi,
                                   sve_mask2_lo, sve_mask2_hi, buf, buf_end);
     return ptr ? ptr : buf_end;
-}
\ No newline at end of file
+}
+
+static really_inline
+svuint8_t tripleLookup(svuint8_t mask_lo, svuint8_t mask_hi, const u8 *buf,
+                       const svbool_t pg) {
+    svuint8_t vec = svld1_u8(pg, buf);
+    svuint8_t c_lo = svtbl(mask_lo, svand_x(svptrue_b8(), vec, (uint8_t)0xf));
+    svuint8_t c_hi = svtbl(mask_hi, svlsr_x(svptrue_b8(), vec, 4));
+    return svorr_x(svptrue_b8(), c_lo, c_hi);
+}
+
+static really_inline
+svbool_t tripleMatched(svuint8_t mask1_lo, svuint8_t mask1_hi,
+                       svuint8_t mask2_lo, svuint8_t mask2_hi,
+                       svuint8_t mask3_lo, svuint8_t mask3_hi,
+                       const u8 *buf, const svbool_t pg) {
+    // lane i checks the triple starting at buf + i, so the second and third
+    // bytes come from loads offset by one and two rather than from svext,
+    // which would lose the lanes at the end of the vector
+    svuint8_t t1 = tripleLookup(mask1_lo, mask1_hi, buf, pg);
+    svuint8_t t2 = tripleLookup(mask2_lo, mask2_hi, buf + 1, pg);
+    svuint8_t t3 = tripleLookup(mask3_lo, mask3_hi, buf + 2, pg);
+    svuint8_t t = svorr_x(svptrue_b8(), svorr_x(svptrue_b8(), t1, t2), t3);
+
+    return svcmpne(pg, t, (uint8_t)0xff);
+}
+
+const u8 *shuftiTripleExec(m128 mask1_lo, m128 mask1_hi,
+                           m128 mask2_lo, m128 mask2_hi,
+                           m128 mask3_lo, m128 mask3_hi,
+                           const u8 *buf, const u8 *buf_end) {
+    DEBUG_PRINTF("triple shufti scan %td bytes\n", buf_end - buf);
+    DEBUG_PRINTF("buf %p buf_end %p \n", buf, buf_end);
+    svuint8_t sve_mask1_lo = getSVEMaskFrom128(mask1_lo);
+    svuint8_t sve_mask1_hi = getSVEMaskFrom128(mask1_hi);
+    svuint8_t sve_mask2_lo = getSVEMaskFrom128(mask2_lo);
+    svuint8_t sve_mask2_hi = getSVEMaskFrom128(mask2_hi);
+    svuint8_t sve_mask3_lo = getSVEMaskFrom128(mask3_lo);
+    svuint8_t sve_mask3_hi = getSVEMaskFrom128(mask3_hi);
+    for (; buf < buf_end; buf += svcntb()) {
+        svbool_t pg = svwhilelt_b8_s64(0, buf_end - buf);
+        svbool_t matched = tripleMatched(sve_mask1_lo, sve_mask1_hi,
+                                         sve_mask2_lo, sve_mask2_hi,
+                                         sve_mask3_lo, sve_mask3_hi, buf, pg);
+        const u8 *ptr = accelSearchCheckMatched(buf, matched);
+        if (ptr) {
+            return ptr;
+        }
+    }
+    return buf_end;
+}
@@ -208,6 +208,90 @@ bool shuftiBuildDoubleMasks(const CharReach &onechar,
     return true;
 }
 
+static
+u16 lo_nibbles(const CharReach &cr) {
+    u16 rv = 0;
+    for (size_t i = cr.find_first(); i != CharReach::npos;
+         i = cr.find_next(i)) {
+        rv |= 1U << (i & 0xf);
+    }
+    return rv;
+}
+
+static
+u16 hi_nibbles(const CharReach &cr) {
+    u16 rv = 0;
+    for (size_t i = cr.find_first(); i != CharReach::npos;
+         i = cr.find_next(i)) {
+        rv |= 1U << (i >> 4);
+    }
+    return rv;
+}
+
+bool shuftiBuildTripleMasks(const vector<array<CharReach, 3>> &triples,
+                            u8 *lo1, u8 *hi1, u8 *lo2, u8 *hi2, u8 *lo3,
+                            u8 *hi3) {
+    DEBUG_PRINTF("%zu triples\n", triples.size());
+    array<array<u8, 16>, 6> masks;
+    for (auto &m : masks) {
+        m.fill(0xff);
+    }
+
+    vector<array<u16, 6>> nibble_masks;
+    for (const auto &t : triples) {
+        array<u16, 6> a;
+        for (u32 i = 0; i < 3; i++) {
+            a[2 * i] = lo_nibbles(t[i]);
+            a[2 * i + 1] = hi_nibbles(t[i]);
+        }
+        if (!a[0] || !a[2] || !a[4]) {
+            DEBUG_PRINTF("triple can never match\n");
+            continue;
+        }
+        nibble_masks.emplace_back(a);
+    }
+
+    // merge entries which only differ in one nibble set, which is exact
+    for (u32 i = 0; i < 6; i++) {
+        map<array<u16, 6>, array<u16, 6>> new_masks;
+        for (const auto &a : nibble_masks) {
+            auto key = a;
+            key[i] = 0;
+            if (!contains(new_masks, key)) {
+                new_masks[key] = a;
+            } else {
+                new_masks[key][i] |= a[i];
+            }
+        }
+        nibble_masks.clear();
+        for (const auto &e : new_masks) {
+            nibble_masks.emplace_back(e.second);
+        }
+    }
+
+    if (nibble_masks.empty() || nibble_masks.size() > MAX_BUCKETS) {
+        DEBUG_PRINTF("unable to use %zu buckets\n", nibble_masks.size());
+        return false;
+    }
+
+    u32 bucket = 0;
+    for (const auto &a : nibble_masks) {
+        for (u32 i = 0; i < 6; i++) {
+            set_buckets_from_mask(a[i], bucket, masks[i]);
+        }
+        bucket++;
+    }
+
+    memcpy(lo1, masks[0].data(), sizeof(m128));
+    memcpy(hi1, masks[1].data(), sizeof(m128));
+    memcpy(lo2, masks[2].data(), sizeof(m128));
+    memcpy(hi2, masks[3].data(), sizeof(m128));
+    memcpy(lo3, masks[4].data(), sizeof(m128));
+    memcpy(hi3, masks[5].data(), sizeof(m128));
+
+    return true;
+}
+
 #ifdef DUMP_SUPPORT
 
 CharReach shufti2cr(const u8 *lo, const u8 *hi) {
@@ -37,7 +37,9 @@
 #include "util/charreach.h"
 #include "util/flat_containers.h"
 
+#include <array>
 #include <utility>
+#include <vector>
 
 namespace ue2 {
 
@@ -58,6 +60,18 @@ bool shuftiBuildDoubleMasks(const CharReach &onechar,
                             const flat_set<std::pair<u8, u8>> &twochar,
                             u8 *lo1, u8 *hi1, u8 *lo2, u8 *hi2);
 
+/** \brief Triple-byte variant
+ *
+ * Each entry of \a triples is a sequence of three character classes which
+ * must be matched by consecutive bytes. Classes are widened to the product of
+ * their low and high nibble sets, which is what a shufti bucket can express.
+ *
+ * Returns false if we are unable to build the masks (too many buckets required)
+ */
+bool shuftiBuildTripleMasks(const std::vector<std::array<CharReach, 3>> &triples,
+                            u8 *lo1, u8 *hi1, u8 *lo2, u8 *hi2, u8 *lo3,
+                            u8 *hi3);
+
 #ifdef DUMP_SUPPORT
 
 /**
@@ -72,3 +72,23 @@ SuperVector<S> blockDoubleMask(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi,
 
     return c.eq(SuperVector<S>::Ones());
 }
+
+template <uint16_t S>
+static really_inline
+SuperVector<S> blockTripleMask(SuperVector<S> mask1_lo, SuperVector<S> mask1_hi, SuperVector<S> mask2_lo, SuperVector<S> mask2_hi,
+                               SuperVector<S> mask3_lo, SuperVector<S> mask3_hi, SuperVector<S> chars1, SuperVector<S> chars2,
+                               SuperVector<S> chars3) {
+
+    const SuperVector<S> low4bits = SuperVector<S>::dup_u8(0xf);
+    SuperVector<S> c1_lo = mask1_lo.pshufb(chars1 & low4bits);
+    SuperVector<S> c1_hi = mask1_hi.pshufb(low4bits.opandnot(chars1).template vshr_64_imm<4>());
+    SuperVector<S> c2_lo = mask2_lo.pshufb(chars2 & low4bits);
+    SuperVector<S> c2_hi = mask2_hi.pshufb(low4bits.opandnot(chars2).template vshr_64_imm<4>());
+    SuperVector<S> c3_lo = mask3_lo.pshufb(chars3 & low4bits);
+    SuperVector<S> c3_hi = mask3_hi.pshufb(low4bits.opandnot(chars3).template vshr_64_imm<4>());
+
+    SuperVector<S> t = c1_lo | c1_hi | c2_lo | c2_hi | c3_lo | c3_hi;
+    t.print8("t");
+
+    return t.eq(SuperVector<S>::Ones());
+}
@@ -81,6 +81,7 @@ NG::NG(const CompileContext &in_cc, size_t num_patterns,
        unsigned in_somPrecision)
     : maxSomRevHistoryAvailable(in_cc.grey.somMaxRevNfaLength),
       minWidth(depth::infinity()),
+      maxWidth(0),
       rm(in_cc.grey),
       ssm(in_somPrecision),
       cc(in_cc),
@@ -370,6 +371,10 @@ bool NG::addGraph(ExpressionInfo &expr, unique_ptr<NGHolder> g_ptr) {
 
     optimiseVirtualStarts(g); /* good for som */
 
+    // Record the max width of the whole pattern now that asserts and fuzzing
+    // have been resolved, before it is split into pieces.
+    maxWidth = max(maxWidth, findMaxWidth(g));
+
     propagateExtendedParams(g, expr, rm);
     reduceExtendedParams(g, rm, som);
 
@@ -615,6 +620,7 @@ bool NG::addLiteral(const ue2_literal &literal, u32 expr_index,
     rose->add(false, false, literal, {id});
 
     minWidth = min(minWidth, depth(literal.length()));
+    maxWidth = max(maxWidth, depth(literal.length()));
 
     /* inform small write handler about this literal */
     smwr->add(literal, id);
@@ -89,6 +89,10 @@ public:
      * patterns, which give an effective minWidth of zero). */
     depth minWidth;
 
+    /** \brief The length of the longest match of any pattern contained in the
+     * NG, which is infinite if any pattern's matches are unbounded. */
+    depth maxWidth;
+
     ReportManager rm;
     SomSlotManager ssm;
     BoundaryReports boundary;
@@ -48,6 +48,8 @@
 #include "util/target_info.h"
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <map>
 
 #include <boost/range/adaptor/map.hpp>
@@ -559,13 +561,217 @@ DAccelScheme findBestDoubleAccelScheme(vector<vector<CharReach> > paths,
     return best;
 }
 
+namespace {
+/** \brief Classes which must be matched by three consecutive bytes. */
+using ClassTriple = array<CharReach, 3>;
+}
+
+/** \brief Widen a class to what a single shufti bucket can express: the
+ * product of its low and high nibble sets. */
+static
+CharReach nibbleHull(const CharReach &cr) {
+    u32 lo = 0;
+    u32 hi = 0;
+    for (size_t i = cr.find_first(); i != CharReach::npos;
+         i = cr.find_next(i)) {
+        lo |= 1U << (i & 0xf);
+        hi |= 1U << (i >> 4);
+    }
+
+    CharReach rv;
+    for (u32 h = 0; h < 16; h++) {
+        if (!(hi & (1U << h))) {
+            continue;
+        }
+        for (u32 l = 0; l < 16; l++) {
+            if (lo & (1U << l)) {
+                rv.set(h << 4 | l);
+            }
+        }
+    }
+    return rv;
+}
+
+/** \brief Fraction of positions in uniformly random input at which a scheme
+ * would stop. Only used to compare schemes against each other. */
+static
+double stopRate(const ClassTriple &t) {
+    double rate = 1.0;
+    for (const auto &cr : t) {
+        rate *= (double)cr.count() / N_CHARS;
+    }
+    return rate;
+}
+
+static
+double stopRate(const AccelScheme &as) {
+    double rate = (double)as.cr.count() / N_CHARS;
+    if (!as.double_byte.empty()) {
+        double double_rate = (double)as.double_cr.count() / N_CHARS
+                  + (double)as.double_byte.size() / (N_CHARS * N_CHARS);
+        rate = min(rate, double_rate);
+    }
+    return rate;
+}
+
+static
+ClassTriple mergeTriples(const ClassTriple &a, const ClassTriple &b) {
+    ClassTriple rv;
+    for (u32 i = 0; i < rv.size(); i++) {
+        rv[i] = nibbleHull(a[i] | b[i]);
+    }
+    return rv;
+}
+
+static
+bool isSubsetOf(const ClassTriple &a, const ClassTriple &b) {
+    for (u32 i = 0; i < a.size(); i++) {
+        if (!a[i].isSubsetOf(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** \brief Window of three classes starting at \a i; positions beyond the end
+ * of the path may be anything. */
+static
+ClassTriple pathWindow(const vector<CharReach> &path, u32 i) {
+    ClassTriple rv;
+    for (u32 j = 0; j < rv.size(); j++) {
+        rv[j] = i + j < path.size() ? nibbleHull(path[i + j])
+                                    : CharReach::dot();
+    }
+    return rv;
+}
+
+#define MAX_TRIPLE_ACCEL_PATHS 40
+#define TRIPLE_SHUFTI_BUCKETS 8
+
+bool findTripleAccelScheme(const vector<vector<CharReach>> &paths,
+                           const CharReach &terminating, AccelScheme *as) {
+    const double base_rate = stopRate(*as);
+    if (base_rate * N_CHARS < TRIPLE_SHUFTI_MIN_STOPS) {
+        DEBUG_PRINTF("existing scheme is good enough\n");
+        return false;
+    }
+
+    if (paths.empty() || paths.size() > MAX_TRIPLE_ACCEL_PATHS) {
+        DEBUG_PRINTF("unsuitable number of paths %zu\n", paths.size());
+        return false;
+    }
+
+    vector<ClassTriple> triples;
+    u32 offset = 0;
+
+    /* terminating characters stop us wherever they appear */
+    if (terminating.any()) {
+        triples.push_back({{nibbleHull(terminating), CharReach::dot(),
+                            CharReach::dot()}});
+    }
+
+    /* for each path pick the most selective window: a window containing an
+     * empty class can only be completed at the end of the buffer, which the
+     * offset back-off already covers. Windows may not start on a wide class,
+     * as an accel friend may have entered the path before the scan starts. */
+    for (const auto &path : paths) {
+        u32 best_i = 0;
+        ClassTriple best;
+        double best_rate = numeric_limits<double>::max();
+        for (u32 i = 0; i < path.size(); i++) {
+            if (path[i].count() >= WIDE_FRIEND_MIN) {
+                continue;
+            }
+            ClassTriple t = pathWindow(path, i);
+            if (stopRate(t) < best_rate) {
+                best = t;
+                best_rate = stopRate(t);
+                best_i = i;
+            }
+        }
+
+        if (best_rate > 1.0) {
+            DEBUG_PRINTF("no usable window\n");
+            return false;
+        }
+
+        offset = max(offset, best_i);
+        if (best[0].any() && best[1].any() && best[2].any()) {
+            triples.emplace_back(std::move(best));
+        }
+    }
+
+    sort(triples.begin(), triples.end());
+    triples.erase(unique(triples.begin(), triples.end()), triples.end());
+
+    /* drop triples which are covered by another */
+    vector<ClassTriple> covering;
+    for (const auto &a : triples) {
+        bool covered = false;
+        for (const auto &b : triples) {
+            if (a != b && isSubsetOf(a, b)) {
+                covered = true;
+                break;
+            }
+        }
+        if (!covered) {
+            covering.emplace_back(a);
+        }
+    }
+    triples.swap(covering);
+
+    if (triples.empty()) {
+        return false;
+    }
+
+    /* we only have eight buckets: merge the pairs which cost the least
+     * selectivity until we fit */
+    while (triples.size() > TRIPLE_SHUFTI_BUCKETS) {
+        size_t best_a = 0;
+        size_t best_b = 1;
+        double best_cost = numeric_limits<double>::max();
+        for (size_t a = 0; a < triples.size(); a++) {
+            for (size_t b = a + 1; b < triples.size(); b++) {
+                double cost = stopRate(mergeTriples(triples[a], triples[b]))
+                              - stopRate(triples[a]) - stopRate(triples[b]);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        triples[best_a] = mergeTriples(triples[best_a], triples[best_b]);
+        triples.erase(triples.begin() + best_b);
+    }
+
+    double rate = 0;
+    for (const auto &t : triples) {
+        rate += stopRate(t);
+    }
+
+    DEBUG_PRINTF("triple shufti: %zu buckets, offset %u, rate %f vs %f\n",
+                 triples.size(), offset, rate, base_rate);
+    if (rate * TRIPLE_SHUFTI_GAIN > base_rate) {
+        return false;
+    }
+
+    as->triple = std::move(triples);
+    as->triple_offset = offset;
+    return true;
+}
+
 #define MAX_EXPLORE_PATHS 40
 
 AccelScheme findBestAccelScheme(vector<vector<CharReach>> paths,
                                 const CharReach &terminating,
                                 bool look_for_double_byte) {
     AccelScheme rv;
+    vector<vector<CharReach>> triple_paths;
     if (look_for_double_byte) {
+        /* improvePaths() weakens segments in ways which only make sense for
+         * single byte schemes */
+        triple_paths = paths;
         DAccelScheme da = findBestDoubleAccelScheme(paths, terminating);
         if (da.double_byte.size() <= DOUBLE_SHUFTI_LIMIT) {
             rv.double_byte = std::move(da.double_byte);
@@ -608,6 +814,10 @@ AccelScheme findBestAccelScheme(vector<vector<CharReach>> paths,
         rv.double_byte.clear();
     }
 
+    if (look_for_double_byte) {
+        findTripleAccelScheme(triple_paths, terminating, &rv);
+    }
+
     return rv;
 }
 
@@ -831,7 +1041,8 @@ depth_done:
     vector<NFAVertex> verts(1, v);
     *as = nfaFindAccel(g, verts, refined_cr, br_cyclic, allow_wide, true);
     DEBUG_PRINTF("as width %zu\n", as->cr.count());
-    return as->cr.count() <= ACCEL_MAX_STOP_CHAR || allow_wide;
+    return as->cr.count() <= ACCEL_MAX_STOP_CHAR || allow_wide ||
+           !as->triple.empty();
 }
 
 } // namespace ue2
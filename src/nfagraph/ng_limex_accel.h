@@ -61,6 +61,14 @@ void findAccelFriends(const NGHolder &g, NFAVertex v,
 
 #define DOUBLE_SHUFTI_LIMIT 20
 
+/** \brief Only look for a triple shufti scheme if the best single/double
+ * scheme stops at least as often as a class of this many characters. */
+#define TRIPLE_SHUFTI_MIN_STOPS 8
+
+/** \brief A triple shufti scheme must be expected to stop this many times
+ * less often than the scheme it replaces. */
+#define TRIPLE_SHUFTI_GAIN 4
+
 NFAVertex get_sds_or_proxy(const NGHolder &g);
 
 AccelScheme nfaFindAccel(const NGHolder &g, const std::vector<NFAVertex> &verts,
@@ -72,6 +80,13 @@ AccelScheme findBestAccelScheme(std::vector<std::vector<CharReach> > paths,
                                 const CharReach &terminating,
                                 bool look_for_double_byte = false);
 
+/** \brief Look for a triple shufti scheme over the escape \a paths which is a
+ * clear improvement on the single/double byte scheme already in \a as. If one
+ * is found, it is placed into as->triple and true is returned.
+ */
+bool findTripleAccelScheme(const std::vector<std::vector<CharReach>> &paths,
+                           const CharReach &terminating, AccelScheme *as);
+
 /** \brief Check if vertex \a v is an accelerable state (for a limex NFA). If a
  *  single byte accel scheme is found it is placed into *as
  */
@@ -323,8 +323,7 @@ int roseDeliverReport(u64a offset, ReportID onmatch, s32 offset_adjust,
     DEBUG_PRINTF(">> reporting match @[%llu,%llu] for sig %u ctxt %p <<\n",
                  from_offset, to_offset, onmatch, ci->userContext);
 
-    int halt = ci->userCallback(onmatch, from_offset, to_offset, flags,
-                                ci->userContext);
+    int halt = deliverUserMatch(ci, onmatch, from_offset, to_offset, flags);
     if (halt) {
         DEBUG_PRINTF("callback requested to terminate matches\n");
         ci->status |= STATUS_TERMINATED;
@@ -372,8 +371,7 @@ int roseDeliverSomReport(u64a from_offset, u64a to_offset, ReportID onmatch,
     DEBUG_PRINTF(">> reporting match @[%llu,%llu] for sig %u ctxt %p <<\n",
                  from_offset, to_offset, onmatch, ci->userContext);
 
-    int halt = ci->userCallback(onmatch, from_offset, to_offset, flags,
-                                ci->userContext);
+    int halt = deliverUserMatch(ci, onmatch, from_offset, to_offset, flags);
 
     if (halt) {
         DEBUG_PRINTF("callback requested to terminate matches\n");
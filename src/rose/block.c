@@ -45,9 +45,14 @@ void runAnchoredTableBlock(const struct RoseEngine *t, const void *atable,
     size_t length = scratch->core_info.len;
     size_t alen = MIN(length, t->anchoredDistance);
     const struct anchored_matcher_info *curr = atable;
+    struct mcclellan_multi_block blocks[MCCLELLAN_MULTI_MAX];
+    u32 count = 0;
 
     DEBUG_PRINTF("BEGIN ANCHORED (over %zu/%zu)\n", alen, length);
 
+    /* The anchored DFAs all scan the start of the same buffer, so they are
+     * run in lockstep to overlap their transition loads. Matches from
+     * different DFAs may interleave, as they would from a single merged DFA. */
     do {
         const struct NFA *nfa
             = (const struct NFA *)((const char *)curr + sizeof(*curr));
@@ -59,14 +64,17 @@ void runAnchoredTableBlock(const struct RoseEngine *t, const void *atable,
 
             DEBUG_PRINTF("--anchored nfa (+%u)\n", curr->anchoredMinDistance);
             assert(isMcClellanType(nfa->type));
-            if (nfa->type == MCCLELLAN_NFA_8) {
-                nfaExecMcClellan8_B(nfa, curr->anchoredMinDistance,
-                                    local_buffer, local_alen,
-                                    roseAnchoredCallback, scratch);
-            } else {
-                nfaExecMcClellan16_B(nfa, curr->anchoredMinDistance,
-                                     local_buffer, local_alen,
-                                     roseAnchoredCallback, scratch);
+            struct mcclellan_multi_block *b = &blocks[count++];
+            b->nfa = nfa;
+            b->offset = curr->anchoredMinDistance;
+            b->buffer = local_buffer;
+            b->length = local_alen;
+            b->cb = roseAnchoredCallback;
+            b->context = scratch;
+
+            if (count == MCCLELLAN_MULTI_MAX) {
+                nfaExecMcClellanMulti_B(blocks, count);
+                count = 0;
             }
         }
 
@@ -76,6 +84,10 @@ void runAnchoredTableBlock(const struct RoseEngine *t, const void *atable,
 
         curr = (const void *)((const char *)curr + curr->next_offset);
     } while (1);
+
+    if (count) {
+        nfaExecMcClellanMulti_B(blocks, count);
+    }
 }
 
 static really_inline
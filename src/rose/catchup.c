@@ -810,6 +810,7 @@ hwlmcb_rv_t roseCatchUpNfas(const struct RoseEngine *t, s64a loc,
          * to ensure that the anchored matches remain in sync though */
         s64a second_place_loc = findSecondPlace(&scratch->catchup_pq, loc);
         DEBUG_PRINTF("second place %lld loc %lld\n", second_place_loc, loc);
+        SCAN_STAT_ADD(catchup_engine_runs, 1);
 
         if (second_place_loc == q_cur_loc(q)) {
             if (runExistingNfaToNextMatch(t, qi, q, q_final_loc, scratch, aa, 1)
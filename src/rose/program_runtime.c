@@ -68,6 +68,8 @@ void rosePushDelayedMatch(const struct RoseEngine *t,
         return;
     }
 
+    SCAN_STAT_ADD(delayed_literals, 1);
+
     const u32 delay_count = t->delay_count;
     struct fatbit **delaySlots = getDelaySlots(scratch);
     struct fatbit *slot = delaySlots[slot_index];
@@ -572,6 +574,27 @@ hwlmcb_rv_t roseSetExhaust(const struct RoseEngine *t,
     return roseHaltIfExhausted(t, scratch);
 }
 
+static rose_inline
+hwlmcb_rv_t roseReportHalt(struct hs_scratch *scratch, u64a end) {
+    DEBUG_PRINTF("match at end=%llu, halting (existence mode)\n", end);
+    updateLastMatchOffset(&scratch->tctxt, end);
+
+    scratch->core_info.status |= STATUS_TERMINATED;
+    return HWLM_TERMINATE_MATCHING;
+}
+
+static rose_inline
+void roseReportCount(struct hs_scratch *scratch, u64a end, u32 index) {
+    DEBUG_PRINTF("counting index=%u, end=%llu\n", index, end);
+    updateLastMatchOffset(&scratch->tctxt, end);
+
+    struct core_info *ci = &scratch->core_info;
+    assert(ci->matchCounts);
+    assert(index < ci->rose->matchCountSlots);
+    ci->matchCounts[index]++;
+    SCAN_STAT_ADD(reports, 1);
+}
+
 static really_inline
 int reachHasBit(const u8 *reach, u8 c) {
     return !!(reach[c / 8U] & (u8)1U << (c % 8U));
@@ -2121,6 +2144,7 @@ hwlmcb_rv_t checkPurelyNegatives(const struct RoseEngine *t,
     LABEL_ROSE_INSTR_##name:                                                   \
         DEBUG_PRINTF("instruction: " #name " (pc=%u)\n",                       \
                      programOffset + (u32)(pc - pc_base));                     \
+        SCAN_STAT_ADD(program_instructions, 1);                                \
         const struct ROSE_STRUCT_##name *ri =                                  \
             (const struct ROSE_STRUCT_##name *)pc;
 
@@ -2132,6 +2156,12 @@ hwlmcb_rv_t checkPurelyNegatives(const struct RoseEngine *t,
 #define PROGRAM_NEXT_INSTRUCTION_JUMP                                          \
     goto *(next_instr[*(const u8 *)pc]);
 
+#ifdef SCAN_PROFILE
+/* The interpreter proper: the wrapper below charges its time to the program
+ * being run. */
+#define roseRunProgram roseRunProgram_i
+static
+#endif
 hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
                            struct hs_scratch *scratch, u32 programOffset,
                            u64a som, u64a end, u8 prog_flags) {
@@ -2229,7 +2259,9 @@ hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
         &&LABEL_ROSE_INSTR_SET_COMBINATION,
         &&LABEL_ROSE_INSTR_FLUSH_COMBINATION,
         &&LABEL_ROSE_INSTR_SET_EXHAUST,
-        &&LABEL_ROSE_INSTR_LAST_FLUSH_COMBINATION
+        &&LABEL_ROSE_INSTR_LAST_FLUSH_COMBINATION,
+        &&LABEL_ROSE_INSTR_REPORT_HALT,
+        &&LABEL_ROSE_INSTR_REPORT_COUNT
 #ifdef HAVE_AVX512
         ,
         &&LABEL_ROSE_INSTR_CHECK_SHUFTI_64x8, //!< Check 64-byte data by 8-bucket shufti.
@@ -3054,6 +3086,19 @@ hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
             }
             PROGRAM_NEXT_INSTRUCTION
 
+            PROGRAM_CASE(REPORT_HALT) {
+                updateSeqPoint(tctxt, end, from_mpv);
+                return roseReportHalt(scratch, end);
+            }
+            PROGRAM_NEXT_INSTRUCTION
+
+            PROGRAM_CASE(REPORT_COUNT) {
+                updateSeqPoint(tctxt, end, from_mpv);
+                roseReportCount(scratch, end, ri->index);
+                work_done = 1;
+            }
+            PROGRAM_NEXT_INSTRUCTION
+
             default: {
                 assert(0); // unreachable
                 scratch->core_info.status |= STATUS_ERROR;
@@ -3066,10 +3111,24 @@ hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
     return HWLM_CONTINUE_MATCHING;
 }
 
+#ifdef SCAN_PROFILE
+#undef roseRunProgram
+hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
+                           struct hs_scratch *scratch, u32 programOffset,
+                           u64a som, u64a end, u8 prog_flags) {
+    SCAN_PROFILE_PROGRAM_BEGIN(t, programOffset);
+    hwlmcb_rv_t rv = roseRunProgram_i(t, scratch, programOffset, som, end,
+                                      prog_flags);
+    SCAN_PROFILE_END();
+    return rv;
+}
+#endif
+
 #define L_PROGRAM_CASE(name)                                                   \
     case ROSE_INSTR_##name: {                                                  \
         DEBUG_PRINTF("l_instruction: " #name " (pc=%u)\n",                     \
                      programOffset + (u32)(pc - pc_base));                     \
+        SCAN_STAT_ADD(program_instructions, 1);                                \
         const struct ROSE_STRUCT_##name *ri =                                  \
             (const struct ROSE_STRUCT_##name *)pc;
 
@@ -3080,6 +3139,12 @@ hwlmcb_rv_t roseRunProgram(const struct RoseEngine *t,
 
 #define L_PROGRAM_NEXT_INSTRUCTION_JUMP continue;
 
+#ifdef SCAN_PROFILE
+/* The interpreter proper: the wrapper below charges its time to the program
+ * being run. */
+#define roseRunProgram_l roseRunProgram_l_i
+static
+#endif
 hwlmcb_rv_t roseRunProgram_l(const struct RoseEngine *t,
                              struct hs_scratch *scratch, u32 programOffset,
                              u64a som, u64a end, u8 prog_flags) {
@@ -3491,6 +3556,19 @@ hwlmcb_rv_t roseRunProgram_l(const struct RoseEngine *t,
             }
             L_PROGRAM_NEXT_INSTRUCTION
 
+            L_PROGRAM_CASE(REPORT_HALT) {
+                updateSeqPoint(tctxt, end, from_mpv);
+                return roseReportHalt(scratch, end);
+            }
+            L_PROGRAM_NEXT_INSTRUCTION
+
+            L_PROGRAM_CASE(REPORT_COUNT) {
+                updateSeqPoint(tctxt, end, from_mpv);
+                roseReportCount(scratch, end, ri->index);
+                work_done = 1;
+            }
+            L_PROGRAM_NEXT_INSTRUCTION
+
             default: {
                 assert(0); // unreachable
                 scratch->core_info.status |= STATUS_ERROR;
@@ -3503,6 +3581,19 @@ hwlmcb_rv_t roseRunProgram_l(const struct RoseEngine *t,
     return HWLM_CONTINUE_MATCHING;
 }
 
+#ifdef SCAN_PROFILE
+#undef roseRunProgram_l
+hwlmcb_rv_t roseRunProgram_l(const struct RoseEngine *t,
+                             struct hs_scratch *scratch, u32 programOffset,
+                             u64a som, u64a end, u8 prog_flags) {
+    SCAN_PROFILE_PROGRAM_BEGIN(t, programOffset);
+    hwlmcb_rv_t rv = roseRunProgram_l_i(t, scratch, programOffset, som, end,
+                                        prog_flags);
+    SCAN_PROFILE_END();
+    return rv;
+}
+#endif
+
 #undef L_PROGRAM_CASE
 #undef L_PROGRAM_NEXT_INSTRUCTION
 #undef L_PROGRAM_NEXT_INSTRUCTION_JUMP
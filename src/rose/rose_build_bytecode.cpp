@@ -90,6 +90,7 @@
 #include "util/multibit_build.h"
 #include "util/noncopyable.h"
 #include "util/order_check.h"
+#include "util/parallel.h"
 #include "util/popcount.h"
 #include "util/queue_index_factory.h"
 #include "util/report_manager.h"
@@ -171,6 +172,14 @@ struct build_context : noncopyable {
 
     /** \brief Resources in use (tracked as programs are added). */
     RoseResources resources;
+
+    /** \brief Literal ids whose matches run each program, by program offset;
+     * only recorded in SCAN_PROFILE builds. */
+    map<u32, flat_set<u32>> program_literals;
+
+    /** \brief Reports raised by each report program, by program offset;
+     * only recorded in SCAN_PROFILE builds. */
+    map<u32, flat_set<ReportID>> program_reports;
 };
 
 /** \brief subengine info including built engine and
@@ -1762,12 +1771,24 @@ bool prepOutfixes(RoseBuildImpl &tbi, build_context &bc,
 
     assert(tbi.qif.allocated_count() == bc.engineOffsets.size());
 
-    for (auto &out : tbi.outfixes) {
+    // Outfix engines are independent of each other, so they may be built in
+    // parallel; everything else happens in order below.
+    vector<bytecode_ptr<NFA>> built(tbi.outfixes.size());
+    parallel_for(tbi.cc.numThreads, tbi.outfixes.size(), [&](size_t i) {
+        OutfixInfo &out = tbi.outfixes[i];
+        if (out.mpv()) {
+            return; /* already done */
+        }
+        DEBUG_PRINTF("building outfix %zu\n", i);
+        built[i] = buildOutfix(tbi, out);
+    });
+
+    for (size_t i = 0; i < tbi.outfixes.size(); i++) {
+        OutfixInfo &out = tbi.outfixes[i];
         if (out.mpv()) {
             continue; /* already done */
         }
-        DEBUG_PRINTF("building outfix %zd\n", &out - &tbi.outfixes[0]);
-        auto n = buildOutfix(tbi, out);
+        auto n = std::move(built[i]);
         if (!n) {
             assert(0);
             return false;
@@ -1952,12 +1973,14 @@ bool buildSuffixes(const RoseBuildImpl &tbi, build_context &bc,
     }
     sort(begin(ordered), end(ordered));
 
-    for (const auto &e : ordered) {
-        const u32 queue = e.first;
-        const suffix_id &s = e.second;
+    // The engines themselves are independent of each other, so they may be
+    // built in parallel; everything else happens in queue order below.
+    vector<bytecode_ptr<NFA>> built(ordered.size());
+    parallel_for(tbi.cc.numThreads, ordered.size(), [&](size_t i) {
+        const suffix_id &s = ordered[i].second;
 
         if (s.tamarama()) {
-            continue;
+            return;
         }
 
         const set<PredTopPair> &s_triggers = suffixTriggers.at(s);
@@ -1968,8 +1991,19 @@ bool buildSuffixes(const RoseBuildImpl &tbi, build_context &bc,
         map<u32, vector<vector<CharReach>>> triggers;
         findTriggerSequences(tbi, s_triggers, &triggers);
 
-        auto n = buildSuffix(tbi.rm, tbi.ssm, fixed_depth_tops, triggers,
-                             s, tbi.cc);
+        built[i] = buildSuffix(tbi.rm, tbi.ssm, fixed_depth_tops, triggers,
+                               s, tbi.cc);
+    });
+
+    for (size_t i = 0; i < ordered.size(); i++) {
+        const u32 queue = ordered[i].first;
+        const suffix_id &s = ordered[i].second;
+
+        if (s.tamarama()) {
+            continue;
+        }
+
+        auto n = std::move(built[i]);
         if (!n) {
             return false;
         }
@@ -2394,6 +2428,25 @@ void recordResources(RoseResources &resources, const RoseBuildImpl &build,
 
 }
 
+/**
+ * \brief Note the literals served by the program at the given offset, for the
+ * profiling map.
+ */
+template<typename LitIds>
+static
+void recordProgramLiterals(build_context &bc, u32 offset,
+                           const LitIds &lit_ids) {
+#ifdef SCAN_PROFILE
+    if (offset) {
+        insert(&bc.program_literals[offset], lit_ids);
+    }
+#else
+    (void)bc;
+    (void)offset;
+    (void)lit_ids;
+#endif
+}
+
 static
 u32 writeProgram(build_context &bc, RoseProgram &&program) {
     if (program.empty()) {
@@ -2971,6 +3024,7 @@ void buildFragmentPrograms(const RoseBuildImpl &build,
 
         auto lit_prog = makeFragmentProgram(build, bc, prog_build,
                                             pfrag.lit_ids, lit_edge_map);
+        const vector<u32> *included_lits = nullptr;
         if (pfrag.included_frag_id != INVALID_FRAG_ID &&
             !lit_prog.empty()) {
             auto &cfrag = fragments[pfrag.included_frag_id];
@@ -2980,8 +3034,15 @@ void buildFragmentPrograms(const RoseBuildImpl &build,
             DEBUG_PRINTF("child %u offset %u\n", cfrag.fragment_id,
                          child_offset);
             addIncludedJumpProgram(lit_prog, child_offset, pfrag.squash);
+            included_lits = &cfrag.lit_ids;
         }
         pfrag.lit_program_offset = writeProgram(bc, std::move(lit_prog));
+        recordProgramLiterals(bc, pfrag.lit_program_offset, pfrag.lit_ids);
+        if (included_lits) {
+            // the included fragment's program runs as part of this one
+            recordProgramLiterals(bc, pfrag.lit_program_offset,
+                                  *included_lits);
+        }
 
         // We only do delayed rebuild in streaming mode.
         if (!build.cc.streaming) {
@@ -2990,6 +3051,7 @@ void buildFragmentPrograms(const RoseBuildImpl &build,
 
         auto rebuild_prog = makeDelayRebuildProgram(build, prog_build,
                                                     pfrag.lit_ids);
+        included_lits = nullptr;
         if (pfrag.included_delay_frag_id != INVALID_FRAG_ID &&
             !rebuild_prog.empty()) {
             auto &cfrag = fragments[pfrag.included_delay_frag_id];
@@ -3000,8 +3062,15 @@ void buildFragmentPrograms(const RoseBuildImpl &build,
                          child_offset);
             addIncludedJumpProgram(rebuild_prog, child_offset,
                                    pfrag.delay_squash);
+            included_lits = &cfrag.lit_ids;
         }
         pfrag.delay_program_offset = writeProgram(bc, std::move(rebuild_prog));
+        recordProgramLiterals(bc, pfrag.delay_program_offset, pfrag.lit_ids);
+        if (included_lits) {
+            // the included fragment's program runs as part of this one
+            recordProgramLiterals(bc, pfrag.delay_program_offset,
+                                  *included_lits);
+        }
     }
 }
 
@@ -3091,6 +3160,7 @@ pair<u32, u32> writeDelayPrograms(const RoseBuildImpl &build,
                                                delayed_lit_id, lit_edge_map,
                                                false);
                 u32 offset = writeProgram(bc, std::move(prog));
+                recordProgramLiterals(bc, offset, vector<u32>{delayed_lit_id});
 
                 u32 delay_id;
                 auto it = cache.find(offset);
@@ -3152,6 +3222,7 @@ pair<u32, u32> writeAnchoredPrograms(const RoseBuildImpl &build,
                                            lit_edge_map, true);
             u32 offset = writeProgram(bc, std::move(prog));
             DEBUG_PRINTF("lit_id=%u -> anch prog at %u\n", lit_id, offset);
+            recordProgramLiterals(bc, offset, vector<u32>{lit_id});
 
             u32 anch_id;
             auto it = cache.find(offset);
@@ -3213,6 +3284,11 @@ pair<u32, u32> buildReportPrograms(const RoseBuildImpl &build,
         u32 offset = writeProgram(bc, std::move(program));
         programs.emplace_back(offset);
         build.rm.setProgramOffset(id, offset);
+#ifdef SCAN_PROFILE
+        if (offset) {
+            bc.program_reports[offset].insert(id);
+        }
+#endif
         DEBUG_PRINTF("program for report %u @ %u (%zu instructions)\n", id,
                      programs.back(), program.size());
     }
@@ -3520,6 +3596,61 @@ bytecode_ptr<RoseEngine> addSmallWriteEngine(const RoseBuildImpl &build,
     return rose2;
 }
 
+/**
+ * \brief Returns the number of match counters needed by a count-only database:
+ * one per expression, up to the last one with an external report. Matches are
+ * counted by expression index rather than by id, so this is bounded by the
+ * number of expressions.
+ *
+ * A non-zero value is what marks the bytecode as count-only at runtime, so a
+ * count-only database always has at least one counter, even if it has no
+ * external reports.
+ */
+static
+u32 calcMatchCountSlots(const RoseBuildImpl &build) {
+    if (!build.cc.countOnly) {
+        return 0;
+    }
+
+    u32 slots = 1;
+    for (const auto &report : build.rm.reports()) {
+        if (isExternalReport(report)) {
+            u32 index = build.rm.getExpressionIndex(report.onmatch);
+            slots = max(slots, index + 1);
+        }
+    }
+    return slots;
+}
+
+/**
+ * \brief Returns the maximum match width to use as the overlap when a block
+ * scan is split into chunks (see hs_scan_parallel()), or ROSE_BOUND_INF if
+ * the matches in a chunk depend on more than the bytes around them.
+ */
+static
+u32 calcMaxMatchWidth(const RoseBuildImpl &build, u32 maxWidth) {
+    if (build.cc.streaming || build.cc.existenceOnly || build.cc.countOnly) {
+        return ROSE_BOUND_INF;
+    }
+
+    // Logical combinations are evaluated over the whole block.
+    if (build.rm.numCkeys()) {
+        return ROSE_BOUND_INF;
+    }
+
+    // Exhaustible reports only fire once per block, and offset bounds are
+    // relative to the start of the block.
+    for (const auto &report : build.rm.reports()) {
+        if (report.ekey != INVALID_EKEY || report.minOffset > 0 ||
+            report.maxOffset < MAX_OFFSET) {
+            DEBUG_PRINTF("report prevents splitting\n");
+            return ROSE_BOUND_INF;
+        }
+    }
+
+    return maxWidth;
+}
+
 /**
  * \brief Returns the pair (number of literals, max length) for all real
  * literals in the floating table that are in-use.
@@ -3605,7 +3736,147 @@ map<left_id, u32> makeLeftQueueMap(const RoseGraph &g,
     return lqm;
 }
 
-bytecode_ptr<RoseEngine> RoseBuildImpl::buildFinalEngine(u32 minWidth) {
+#ifdef SCAN_PROFILE
+template<typename Reports>
+static
+void addExpressions(const ReportManager &rm, const Reports &reports,
+                    flat_set<u32> &exprs) {
+    for (ReportID id : reports) {
+        const Report &report = rm.getReport(id);
+        if (isExternalReport(report)) {
+            exprs.insert(report.onmatch);
+        }
+    }
+}
+
+/**
+ * \brief Returns the external expression ids that a role can lead to: its own
+ * reports, those of its suffix and those of every role after it.
+ */
+static
+const flat_set<u32> &
+findRoleExpressions(const RoseBuildImpl &build, RoseVertex v,
+                    unordered_map<RoseVertex, flat_set<u32>> &cache) {
+    auto it = cache.find(v);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    // Left empty while in progress, in case the graph has cycles.
+    auto &exprs = cache[v];
+
+    const RoseGraph &g = build.g;
+    flat_set<u32> found;
+    addExpressions(build.rm, g[v].reports, found);
+    if (g[v].suffix) {
+        addExpressions(build.rm, all_reports(g[v].suffix), found);
+    }
+    for (auto w : adjacent_vertices_range(v, g)) {
+        insert(&found, findRoleExpressions(build, w, cache));
+    }
+
+    exprs = std::move(found);
+    return exprs;
+}
+
+/**
+ * \brief Writes the RoseProfileMap, which ties the programs and engine queues
+ * timed by SCAN_PROFILE builds to the expressions they serve.
+ */
+static
+u32 writeProfileMap(const RoseBuildImpl &build, build_context &bc,
+                    u32 queue_count) {
+    unordered_map<RoseVertex, flat_set<u32>> role_cache;
+
+    auto lit_exprs = [&](u32 lit_id, flat_set<u32> &exprs) {
+        for (auto v : build.literal_info.at(lit_id).vertices) {
+            insert(&exprs, findRoleExpressions(build, v, role_cache));
+        }
+    };
+
+    // Program buckets, in offset order, followed by queue buckets.
+    vector<u32> programs;
+    vector<vector<u32>> buckets;
+    vector<flat_set<u32>> queue_buckets(queue_count);
+
+    set<u32> offsets;
+    insert(&offsets, bc.program_literals | map_keys);
+    insert(&offsets, bc.program_reports | map_keys);
+    for (u32 offset : offsets) {
+        flat_set<u32> exprs;
+        auto lit_it = bc.program_literals.find(offset);
+        if (lit_it != bc.program_literals.end()) {
+            for (u32 lit_id : lit_it->second) {
+                lit_exprs(lit_id, exprs);
+            }
+        }
+        auto report_it = bc.program_reports.find(offset);
+        if (report_it != bc.program_reports.end()) {
+            addExpressions(build.rm, report_it->second, exprs);
+        }
+        programs.emplace_back(offset);
+        buckets.emplace_back(exprs.begin(), exprs.end());
+    }
+
+    for (const auto &e : bc.suffixes) {
+        addExpressions(build.rm, all_reports(e.first),
+                       queue_buckets.at(e.second));
+    }
+
+    for (const auto &e : bc.leftfix_info) {
+        if (e.second.has_lookaround) {
+            continue;
+        }
+        insert(&queue_buckets.at(e.second.queue),
+               findRoleExpressions(build, e.first, role_cache));
+    }
+
+    for (const auto &outfix : build.outfixes) {
+        addExpressions(build.rm, all_reports(outfix),
+                       queue_buckets.at(outfix.get_queue()));
+    }
+
+    for (const auto &exprs : queue_buckets) {
+        buckets.emplace_back(exprs.begin(), exprs.end());
+    }
+
+    flat_set<u32> all_exprs;
+    for (const auto &exprs : buckets) {
+        insert(&all_exprs, exprs);
+    }
+    vector<u32> expr_ids(all_exprs.begin(), all_exprs.end());
+
+    vector<u32> bucket_starts;
+    vector<u32> expr_index;
+    for (const auto &exprs : buckets) {
+        bucket_starts.emplace_back(verify_u32(expr_index.size()));
+        for (u32 id : exprs) {
+            auto id_it = lower_bound(expr_ids.begin(), expr_ids.end(), id);
+            assert(id_it != expr_ids.end() && *id_it == id);
+            expr_index.emplace_back(verify_u32(id_it - expr_ids.begin()));
+        }
+    }
+    bucket_starts.emplace_back(verify_u32(expr_index.size()));
+
+    DEBUG_PRINTF("%zu program buckets, %u queue buckets, %zu expressions\n",
+                 programs.size(), queue_count, expr_ids.size());
+
+    auto &blob = bc.engine_blob;
+    RoseProfileMap pm;
+    memset(&pm, 0, sizeof(pm));
+    pm.programCount = verify_u32(programs.size());
+    pm.queueCount = queue_count;
+    pm.exprCount = verify_u32(expr_ids.size());
+    pm.programsOffset = blob.add_range(programs);
+    pm.bucketsOffset = blob.add_range(bucket_starts);
+    pm.exprIndexOffset = blob.add_range(expr_index);
+    pm.exprIdsOffset = blob.add_range(expr_ids);
+    return blob.add(pm);
+}
+#endif
+
+bytecode_ptr<RoseEngine> RoseBuildImpl::buildFinalEngine(u32 minWidth,
+                                                         u32 maxWidth) {
     // We keep all our offsets, counts etc. in a prototype RoseEngine which we
     // will copy into the real one once it is allocated: we can't do this
     // until we know how big it will be.
@@ -3740,6 +4011,10 @@ bytecode_ptr<RoseEngine> RoseBuildImpl::buildFinalEngine(u32 minWidth) {
     proto.lastFlushCombProgramOffset =
         writeProgram(bc, std::move(lastFlushComb_prog));
 
+#ifdef SCAN_PROFILE
+    proto.profileMapOffset = writeProfileMap(*this, bc, queue_count);
+#endif
+
     // Build anchored matcher.
     auto atable = buildAnchoredMatcher(*this, fragments, anchored_dfas);
     if (atable) {
@@ -3814,6 +4089,8 @@ bytecode_ptr<RoseEngine> RoseBuildImpl::buildFinalEngine(u32 minWidth) {
 
     proto.historyRequired = verify_u32(historyRequired);
     proto.ekeyCount = rm.numEkeys();
+    proto.matchCountSlots = calcMatchCountSlots(*this);
+    proto.maxMatchWidth = calcMaxMatchWidth(*this, maxWidth);
 
     proto.somHorizon = ssm.somPrecision();
     proto.somLocationCount = ssm.numSomSlots();
@@ -1679,7 +1679,8 @@ bool roleOffsetsAreValid(const RoseGraph &g) {
 }
 #endif // NDEBUG
 
-bytecode_ptr<RoseEngine> RoseBuildImpl::buildRose(u32 minWidth) {
+bytecode_ptr<RoseEngine> RoseBuildImpl::buildRose(u32 minWidth,
+                                                  u32 maxWidth) {
     dumpRoseGraph(*this, "rose_early.dot");
 
     // Early check for Rose implementability.
@@ -1793,7 +1794,7 @@ bytecode_ptr<RoseEngine> RoseBuildImpl::buildRose(u32 minWidth) {
 
     dumpRoseGraph(*this, "rose_pre_norm.dot");
 
-    return buildFinalEngine(minWidth);
+    return buildFinalEngine(minWidth, maxWidth);
 }
 
 } // namespace ue2
@@ -1555,6 +1555,14 @@ void dumpProgram(ofstream &os, const RoseEngine *t, const char *pc) {
             PROGRAM_CASE(LAST_FLUSH_COMBINATION) {}
             PROGRAM_NEXT_INSTRUCTION
 
+            PROGRAM_CASE(REPORT_HALT) {}
+            PROGRAM_NEXT_INSTRUCTION
+
+            PROGRAM_CASE(REPORT_COUNT) {
+                os << "    index " << ri->index << endl;
+            }
+            PROGRAM_NEXT_INSTRUCTION
+
         default:
             os << "  UNKNOWN (code " << int{code} << ")" << endl;
             os << "  <stopping>" << endl;
@@ -2216,6 +2224,8 @@ void roseDumpStructRaw(const RoseEngine *t, FILE *f) {
     DUMP_U8(t, hasSom);
     DUMP_U8(t, somHorizon);
     DUMP_U32(t, mode);
+    DUMP_U32(t, matchCountSlots);
+    DUMP_U32(t, maxMatchWidth);
     DUMP_U32(t, historyRequired);
     DUMP_U32(t, ekeyCount);
     DUMP_U32(t, lkeyCount);
@@ -2260,6 +2270,7 @@ void roseDumpStructRaw(const RoseEngine *t, FILE *f) {
     DUMP_U32(t, eodProgramOffset);
     DUMP_U32(t, flushCombProgramOffset);
     DUMP_U32(t, lastByteHistoryIterOffset);
+    DUMP_U32(t, profileMapOffset);
     DUMP_U32(t, minWidth);
     DUMP_U32(t, minWidthExcludingBoundaries);
     DUMP_U32(t, maxBiAnchoredWidth);
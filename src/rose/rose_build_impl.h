@@ -527,8 +527,8 @@ public:
                  bool eod) override;
 
     // Construct a runtime implementation.
-    bytecode_ptr<RoseEngine> buildRose(u32 minWidth) override;
-    bytecode_ptr<RoseEngine> buildFinalEngine(u32 minWidth);
+    bytecode_ptr<RoseEngine> buildRose(u32 minWidth, u32 maxWidth) override;
+    bytecode_ptr<RoseEngine> buildFinalEngine(u32 minWidth, u32 maxWidth);
 
     void setSom() override { hasSom = true; }
 
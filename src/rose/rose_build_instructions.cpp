@@ -49,6 +49,7 @@ RoseInstrEnd::~RoseInstrEnd() = default;
 RoseInstrClearWorkDone::~RoseInstrClearWorkDone() = default;
 RoseInstrFlushCombination::~RoseInstrFlushCombination() = default;
 RoseInstrLastFlushCombination::~RoseInstrLastFlushCombination() = default;
+RoseInstrReportHalt::~RoseInstrReportHalt() = default;
 
 using OffsetMap = RoseInstruction::OffsetMap;
 
@@ -394,6 +395,13 @@ void RoseInstrReportExhaust::write(void *dest, RoseEngineBlob &blob,
     inst->ekey = ekey;
 }
 
+void RoseInstrReportCount::write(void *dest, RoseEngineBlob &blob,
+                                 const OffsetMap &offset_map) const {
+    RoseInstrBase::write(dest, blob, offset_map);
+    auto *inst = static_cast<impl_type *>(dest);
+    inst->index = index;
+}
+
 void RoseInstrReportSom::write(void *dest, RoseEngineBlob &blob,
                                const OffsetMap &offset_map) const {
     RoseInstrBase::write(dest, blob, offset_map);
@@ -2380,6 +2380,40 @@ public:
     }
 };
 
+class RoseInstrReportHalt
+    : public RoseInstrBaseTrivial<ROSE_INSTR_REPORT_HALT,
+                                  ROSE_STRUCT_REPORT_HALT,
+                                  RoseInstrReportHalt> {
+public:
+    ~RoseInstrReportHalt() override;
+};
+
+class RoseInstrReportCount
+    : public RoseInstrBaseNoTargets<ROSE_INSTR_REPORT_COUNT,
+                                    ROSE_STRUCT_REPORT_COUNT,
+                                    RoseInstrReportCount> {
+public:
+    u32 index;
+
+    explicit RoseInstrReportCount(u32 index_in) : index(index_in) {}
+
+    bool operator==(const RoseInstrReportCount &ri) const {
+        return index == ri.index;
+    }
+
+    size_t hash() const override {
+        return hash_all(opcode, index);
+    }
+
+    void write(void *dest, RoseEngineBlob &blob,
+               const OffsetMap &offset_map) const override;
+
+    bool equiv_to(const RoseInstrReportCount &ri, const OffsetMap &,
+                  const OffsetMap &) const {
+        return index == ri.index;
+    }
+};
+
 class RoseInstrEnd
     : public RoseInstrBaseTrivial<ROSE_INSTR_END, ROSE_STRUCT_END,
                                   RoseInstrEnd> {
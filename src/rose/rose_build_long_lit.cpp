@@ -49,7 +49,8 @@ static constexpr size_t MIN_HASH_TABLE_SIZE = 128;
 /** \brief Maximum load factor (between zero and one) for a hash table. */
 static constexpr double MAX_HASH_TABLE_LOAD = 0.7;
 
-/** \brief Minimum size (in bits) for a bloom filter. Must be a power of two. */
+/** \brief Minimum size (in bits) for a bloom filter. Must be a power of two,
+ * and at least one 64-bit word. */
 static constexpr u32 MIN_BLOOM_FILTER_SIZE = 256;
 
 /** \brief Maximum load factor (between zero and one) for a bloom filter. */
@@ -93,15 +94,19 @@ LongLitInfo analyzeLongLits(const vector<ue2_case_string> &lits,
 
 static
 void addToBloomFilter(vector<u8> &bloom, const u8 *substr, bool nocase) {
-    const u32 num_keys = verify_u32(bloom.size() * 8);
-    const u32 key_mask = (1U << lg2(num_keys)) -1;
-
-    const auto hash_functions = { bloomHash_1, bloomHash_2, bloomHash_3 };
-    for (const auto &hash_func : hash_functions) {
-        u32 hash = hash_func(substr, nocase);
-        u32 key = hash & key_mask;
-        DEBUG_PRINTF("set key %u (of %zu)\n", key, bloom.size() * 8);
-        bloom[key / 8] |= 1U << (key % 8);
+    const u32 num_words = verify_u32(bloom.size() / sizeof(u64a));
+    const u32 word_mask = num_words - 1;
+
+    u32 hash1 = bloomHash_1(substr, nocase);
+    u64a bits = bloomWordBits(hash1, bloomHash_2(substr, nocase),
+                              bloomHash_3(substr, nocase));
+    u32 word = bloomWordIndex(hash1, word_mask);
+    DEBUG_PRINTF("set bits %016llx in word %u (of %u)\n", bits, word,
+                 num_words);
+
+    // The runtime reads each word with a little-endian 64-bit load.
+    for (u32 i = 0; i < sizeof(u64a); i++) {
+        bloom[word * sizeof(u64a) + i] |= (u8)(bits >> (8 * i));
     }
 }
 
@@ -185,8 +190,9 @@ static
 vector<RoseLongLitHashEntry> buildHashTable(
                size_t max_len, const vector<u32> &litToOffsetVal,
                const map<u32, LitOffsetVector> &hashToLitOffPairs,
-               size_t numEntries) {
+               size_t numEntries, vector<u8> &tags) {
     vector<RoseLongLitHashEntry> tab(numEntries, {0,0});
+    tags.assign(numEntries, 0);
 
     if (!numEntries) {
         return tab;
@@ -217,9 +223,16 @@ vector<RoseLongLitHashEntry> buildHashTable(
             entry.str_offset = verify_u32(litToOffsetVal.at(lit_id));
             assert(entry.str_offset != 0);
             entry.str_len = offset + max_len;
+            tags[bucket] = longLitHashTag(hash);
         }
     }
 
+    // Mirror the first few tags at the end, so that the runtime can load
+    // LONG_LIT_TAG_PROBE tags from any bucket without wrapping.
+    assert(numEntries >= LONG_LIT_TAG_PROBE);
+    tags.insert(tags.end(), tags.begin(),
+                tags.begin() + LONG_LIT_TAG_PROBE - 1);
+
     DEBUG_PRINTF("hash table occupancy %zu of %zu entries\n",
                  hashTableOccupancy(tab), numEntries);
 
@@ -290,7 +303,8 @@ static
 vector<RoseLongLitHashEntry> makeHashTable(const vector<ue2_case_string> &lits,
                                            size_t max_len,
                                            const vector<u32> &litToOffsetVal,
-                                           u32 numPositions, bool nocase) {
+                                           u32 numPositions, bool nocase,
+                                           vector<u8> &tags) {
     // Compute lit substring hashes.
     const auto hashToLitOffPairs = computeLitHashes(lits, max_len, nocase);
 
@@ -300,7 +314,7 @@ vector<RoseLongLitHashEntry> makeHashTable(const vector<ue2_case_string> &lits,
     num_entries = roundUpToPowerOfTwo(max(MIN_HASH_TABLE_SIZE, num_entries));
 
     auto tab = buildHashTable(max_len, litToOffsetVal, hashToLitOffPairs,
-                              num_entries);
+                              num_entries, tags);
     DEBUG_PRINTF("built %s hash table for %zu entries: load %f\n",
                  nocase ? "nocase" : "caseful", num_entries,
                  hashTableLoad(tab));
@@ -382,19 +396,23 @@ u32 buildLongLiteralTable(const RoseBuildImpl &build, RoseEngineBlob &blob,
     // Build caseful bloom filter and hash table.
     vector<u8> bloom_case;
     vector<RoseLongLitHashEntry> tab_case;
+    vector<u8> tags_case;
     if (info.caseful.num_literals) {
         bloom_case = makeBloomFilter(lits, max_len, false);
         tab_case = makeHashTable(lits, max_len, litToOffsetVal,
-                                 info.caseful.hashed_positions, false);
+                                 info.caseful.hashed_positions, false,
+                                 tags_case);
     }
 
     // Build nocase bloom filter and hash table.
     vector<u8> bloom_nocase;
     vector<RoseLongLitHashEntry> tab_nocase;
+    vector<u8> tags_nocase;
     if (info.nocase.num_literals) {
         bloom_nocase = makeBloomFilter(lits, max_len, true);
         tab_nocase = makeHashTable(lits, max_len, litToOffsetVal,
-                                   info.nocase.hashed_positions, true);
+                                   info.nocase.hashed_positions, true,
+                                   tags_nocase);
     }
 
     size_t wholeLitTabSize = ROUNDUP_16(byte_length(lit_blob));
@@ -402,8 +420,10 @@ u32 buildLongLiteralTable(const RoseBuildImpl &build, RoseEngineBlob &blob,
     size_t htOffsetNocase = htOffsetCase + byte_length(tab_case);
     size_t bloomOffsetCase = htOffsetNocase + byte_length(tab_nocase);
     size_t bloomOffsetNocase = bloomOffsetCase + byte_length(bloom_case);
+    size_t tagOffsetCase = bloomOffsetNocase + byte_length(bloom_nocase);
+    size_t tagOffsetNocase = ROUNDUP_16(tagOffsetCase + byte_length(tags_case));
 
-    size_t tabSize = ROUNDUP_16(bloomOffsetNocase + byte_length(bloom_nocase));
+    size_t tabSize = ROUNDUP_16(tagOffsetNocase + byte_length(tags_nocase));
 
     // need to add +2 to both of these to allow space for the actual largest
     // value as well as handling the fact that we add one to the space when
@@ -424,11 +444,13 @@ u32 buildLongLiteralTable(const RoseBuildImpl &build, RoseEngineBlob &blob,
     header->caseful.streamStateBits = streamBitsCase;
     header->caseful.bloomOffset = verify_u32(bloomOffsetCase);
     header->caseful.bloomBits = lg2(bloom_case.size() * 8);
+    header->caseful.tagOffset = verify_u32(tagOffsetCase);
     header->nocase.hashOffset = verify_u32(htOffsetNocase);
     header->nocase.hashBits = lg2(tab_nocase.size());
     header->nocase.streamStateBits = streamBitsNocase;
     header->nocase.bloomOffset = verify_u32(bloomOffsetNocase);
     header->nocase.bloomBits = lg2(bloom_nocase.size() * 8);
+    header->nocase.tagOffset = verify_u32(tagOffsetNocase);
     assert(tot_state_bytes < sizeof(u64a));
     header->streamStateBytes = verify_u8(tot_state_bytes); // u8
 
@@ -438,6 +460,8 @@ u32 buildLongLiteralTable(const RoseBuildImpl &build, RoseEngineBlob &blob,
     copy_bytes(table.get() + bloomOffsetCase, bloom_case);
     copy_bytes(table.get() + htOffsetNocase, tab_nocase);
     copy_bytes(table.get() + bloomOffsetNocase, bloom_nocase);
+    copy_bytes(table.get() + tagOffsetCase, tags_case);
+    copy_bytes(table.get() + tagOffsetNocase, tags_nocase);
 
     DEBUG_PRINTF("built streaming table, size=%zu\n", tabSize);
     DEBUG_PRINTF("requires %zu bytes of history\n", max_len);
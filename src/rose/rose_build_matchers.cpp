@@ -878,7 +878,7 @@ void buildAccel(const RoseBuildImpl &build,
         return;
     }
 
-    if (hwlm.type == HWLM_ENGINE_NOOD) {
+    if (hwlm.type == HWLM_ENGINE_NOOD || hwlm.type == HWLM_ENGINE_NOOD_MULTI) {
         return;
     }
 
@@ -418,17 +418,25 @@ void makeDedupeSom(const ReportManager &rm, const Report &report,
 }
 
 static
-void makeCatchup(const ReportManager &rm, bool needs_catchup,
+void makeCatchup(const RoseBuildImpl &build, bool needs_catchup,
                  const flat_set<ReportID> &reports, RoseProgram &program) {
     if (!needs_catchup) {
         return;
     }
 
+    const ReportManager &rm = build.rm;
+    const bool no_callback = build.cc.existenceOnly || build.cc.countOnly;
+
     // Everything except the INTERNAL_ROSE_CHAIN report needs catchup to run
-    // before reports are triggered.
+    // before reports are triggered. Without a callback the order of external
+    // matches can't be observed, so they only need catchup in count mode when
+    // they are deduplicated.
 
     auto report_needs_catchup = [&](const ReportID &id) {
         const Report &report = rm.getReport(id);
+        if (no_callback && isExternalReport(report)) {
+            return build.cc.countOnly && rm.getDkey(report) != ~0U;
+        }
         return report.type != INTERNAL_ROSE_CHAIN;
     };
 
@@ -530,6 +538,46 @@ void addLogicalSetRequired(const Report &report, ReportManager &rm,
     }
 }
 
+/**
+ * \brief Report instructions for an external report in an existence-only or
+ * count-only database, neither of which calls the user callback.
+ */
+static
+void makeReportNoCallback(const RoseBuildImpl &build, const Report &report,
+                          RoseProgram &program) {
+    assert(build.cc.existenceOnly || build.cc.countOnly);
+    assert(isExternalReport(report));
+
+    if (report.quiet) {
+        if (report.ekey != INVALID_EKEY) {
+            program.add_before_end(
+                std::make_unique<RoseInstrSetExhaust>(report.ekey));
+        }
+        return;
+    }
+
+    if (build.cc.existenceOnly) {
+        // The first match ends the scan, so there is nothing to dedupe.
+        program.add_before_end(std::make_unique<RoseInstrReportHalt>());
+        return;
+    }
+
+    // Counts must match the number of callbacks we would have made, so we
+    // still dedupe.
+    assert(!build.hasSom);
+    if (build.rm.getDkey(report) != ~0U) {
+        makeDedupe(build.rm, report, program);
+    }
+    // Counts are indexed by expression, so that the count array does not
+    // depend on how large or sparse the match ids are.
+    u32 index = build.rm.getExpressionIndex(report.onmatch);
+    program.add_before_end(std::make_unique<RoseInstrReportCount>(index));
+    if (report.ekey != INVALID_EKEY) {
+        program.add_before_end(
+            std::make_unique<RoseInstrSetExhaust>(report.ekey));
+    }
+}
+
 static
 void makeReport(const RoseBuildImpl &build, const ReportID id,
                 const bool has_som, RoseProgram &program) {
@@ -574,6 +622,13 @@ void makeReport(const RoseBuildImpl &build, const ReportID id,
         report_block.add_before_end(std::make_unique<RoseInstrSomZero>());
     }
 
+    if ((build.cc.existenceOnly || build.cc.countOnly) &&
+        isExternalReport(report)) {
+        makeReportNoCallback(build, report, report_block);
+        program.add_block(std::move(report_block));
+        return;
+    }
+
     switch (report.type) {
     case EXTERNAL_CALLBACK:
         if (build.rm.numCkeys()) {
@@ -739,7 +794,7 @@ void makeRoleReports(const RoseBuildImpl &build,
         report_som = true;
     }
 
-    makeCatchup(build.rm, needs_catchup, g[v].reports, program);
+    makeCatchup(build, needs_catchup, g[v].reports, program);
 
     RoseProgram report_block;
     for (ReportID id : g[v].reports) {
@@ -2354,7 +2409,7 @@ RoseProgram makeEodAnchorProgram(const RoseBuildImpl &build,
         makeRoleCheckNotHandled(prog_build, v, program);
     }
 
-    makeCatchup(build.rm, prog_build.needs_catchup, g[v].reports, program);
+    makeCatchup(build, prog_build.needs_catchup, g[v].reports, program);
 
     const bool has_som = false;
     RoseProgram report_block;
@@ -342,6 +342,12 @@ struct RoseEngine {
     u8  somHorizon; /**< width in bytes of SOM offset storage (governed by
                         SOM precision) */
     u32 mode; /**< scanning mode, one of HS_MODE_{BLOCK,STREAM,VECTORED} */
+    u32 matchCountSlots; /**< number of per-expression match counters needed by
+                          * a count-only (HS_MODE_COUNT) database (always at
+                          * least one), zero otherwise */
+    u32 maxMatchWidth; /**< maximum width of a match, used as the overlap when
+                        * a block scan is split into chunks; ROSE_BOUND_INF if
+                        * the block cannot be split */
     u32 historyRequired; /**< max amount of history required for streaming */
     u32 ekeyCount; /**< number of exhaustion keys */
     u32 lkeyCount; /**< number of logical keys */
@@ -431,6 +437,7 @@ struct RoseEngine {
                                      * otherwise 0 */
 
     u32 lastByteHistoryIterOffset; // if non-zero
+    u32 profileMapOffset; /**< offset to RoseProfileMap, otherwise 0 */
 
     /** \brief Minimum number of bytes required to match. */
     u32 minWidth;
@@ -488,6 +495,24 @@ struct ALIGN_CL_DIRECTIVE anchored_matcher_info {
     u32 anchoredMinDistance; /* start of region to run anchored table over */
 };
 
+/**
+ * \brief Map from profiling buckets to external expression ids, written by
+ * SCAN_PROFILE builds; see hs_alloc_scan_profile().
+ *
+ * There is one bucket per Rose program, followed by one per engine queue. All
+ * offsets are relative to the RoseEngine base.
+ */
+struct RoseProfileMap {
+    u32 programCount; //!< number of program buckets
+    u32 queueCount; //!< number of queue buckets
+    u32 exprCount; //!< number of distinct expression ids
+    u32 programsOffset; //!< u32[programCount]: sorted program offsets
+    u32 bucketsOffset; /**< u32[programCount + queueCount + 1]: start of each
+                        * bucket's expressions in the index array */
+    u32 exprIndexOffset; //!< u32[]: indices into the expression id array
+    u32 exprIdsOffset; //!< u32[exprCount]: sorted distinct expression ids
+};
+
 /**
  * \brief Long literal subtable for a particular mode (caseful or nocase).
  */
@@ -506,10 +531,19 @@ struct RoseLongLitSubtable {
      */
     u32 bloomOffset;
 
+    /**
+     * \brief Offset of the probe tags (relative to RoseLongLitTable base).
+     *
+     * One tag byte per hash table entry (zero for an empty entry), followed
+     * by copies of the first LONG_LIT_TAG_PROBE - 1 tags so that a probe can
+     * always load LONG_LIT_TAG_PROBE consecutive tags.
+     */
+    u32 tagOffset;
+
     /** \brief lg2 of the size of the hash table. */
     u8 hashBits;
 
-    /** \brief Size of the bloom filter in bits. */
+    /** \brief lg2 of the size of the bloom filter in bits. */
     u8 bloomBits;
 
     /** \brief Number of bits of packed stream state used.  */
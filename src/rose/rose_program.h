@@ -208,6 +208,19 @@ enum RoseInstructionCode {
      */
     ROSE_INSTR_LAST_FLUSH_COMBINATION,
 
+    /**
+     * \brief Stop scanning without calling the user callback. Replaces the
+     * report instructions in existence-only (HS_MODE_EXISTENCE) databases.
+     */
+    ROSE_INSTR_REPORT_HALT,
+
+    /**
+     * \brief Bump the match count for a report without calling the user
+     * callback. Replaces the report instructions in count-only
+     * (HS_MODE_COUNT) databases.
+     */
+    ROSE_INSTR_REPORT_COUNT,
+
     ROSE_INSTR_CHECK_SHUFTI_64x8, //!< Check 64-byte data by 8-bucket shufti.
     ROSE_INSTR_CHECK_SHUFTI_64x16, //!< Check 64-byte data by 16-bucket shufti.
     ROSE_INSTR_CHECK_MASK_64,     //!< 64-bytes and/cmp/neg mask check.
@@ -721,4 +734,13 @@ struct ROSE_STRUCT_SET_EXHAUST {
 struct ROSE_STRUCT_LAST_FLUSH_COMBINATION {
     u8 code; //!< From enum RoseInstructionCode.
 };
+
+struct ROSE_STRUCT_REPORT_HALT {
+    u8 code; //!< From enum RoseInstructionCode.
+};
+
+struct ROSE_STRUCT_REPORT_COUNT {
+    u8 code; //!< From enum RoseInstructionCode.
+    u32 index; //!< Expression index to count, indexes the count array.
+};
 #endif // ROSE_ROSE_PROGRAM_H
@@ -33,8 +33,10 @@
 #include "rose_common.h"
 #include "rose_internal.h"
 #include "stream_long_lit_hash.h"
+#include "util/bitutils.h"
 #include "util/compare.h"
 #include "util/copybytes.h"
+#include "util/simd_utils.h"
 
 static really_inline
 const struct RoseLongLitHashEntry *
@@ -265,35 +267,30 @@ void storeLongLitStreamState(const struct RoseLongLitTable *ll_table,
     partial_store_u64a(ll_state, stagingStreamState, ss_bytes);
 }
 
-static really_inline
-char has_bit(const u8 *data, u32 bit) {
-    return (data[bit / 8] >> (bit % 8)) & 1;
-}
-
-static rose_inline
-char bloomHasKey(const u8 *bloom, u32 bloom_mask, u32 hash) {
-    return has_bit(bloom, hash & bloom_mask);
-}
-
 static rose_inline
 char checkBloomFilter(const struct RoseLongLitTable *ll_table,
                       const struct RoseLongLitSubtable *ll_sub,
                       const u8 *scan_buf, char nocase) {
-    assert(ll_sub->bloomBits);
+    assert(ll_sub->bloomBits >= 6);
 
     const u8 *bloom = (const u8 *)ll_table + ll_sub->bloomOffset;
-    const u32 bloom_mask = (1U << ll_sub->bloomBits) - 1;
-
-    char v = 1;
-    v &= bloomHasKey(bloom, bloom_mask, bloomHash_1(scan_buf, nocase));
-    v &= bloomHasKey(bloom, bloom_mask, bloomHash_2(scan_buf, nocase));
-    v &= bloomHasKey(bloom, bloom_mask, bloomHash_3(scan_buf, nocase));
-    return v;
+    const u32 word_mask = (1U << (ll_sub->bloomBits - 6)) - 1;
+
+    u32 hash1 = bloomHash_1(scan_buf, nocase);
+    u64a bits = bloomWordBits(hash1, bloomHash_2(scan_buf, nocase),
+                              bloomHash_3(scan_buf, nocase));
+    u64a word = unaligned_load_u64a(bloom + sizeof(u64a) *
+                                    bloomWordIndex(hash1, word_mask));
+    return (word & bits) == bits;
 }
 
 /**
  * \brief Look for a hit in the hash table.
  *
+ * The table uses linear probing. Rather than confirming every entry on the
+ * probe sequence, we compare LONG_LIT_TAG_PROBE entry tags at a time and only
+ * confirm entries whose tag matches, up to the first empty entry.
+ *
  * Returns zero if not found, otherwise returns (bucket + 1).
  */
 static rose_inline
@@ -303,25 +300,41 @@ u32 checkHashTable(const struct RoseLongLitTable *ll_table,
     const u32 nbits = ll_sub->hashBits;
     assert(nbits && nbits < 32);
     const u32 num_entries = 1U << nbits;
+    const u32 entry_mask = num_entries - 1;
 
     const struct RoseLongLitHashEntry *tab = getHashTableBase(ll_table, ll_sub);
+    assert(ll_sub->tagOffset);
+    const u8 *tags = (const u8 *)ll_table + ll_sub->tagOffset;
 
     u32 hash = hashLongLiteral(scan_buf, LONG_LIT_HASH_LEN, nocase);
-    u32 bucket = hash & ((1U << nbits) - 1);
+    u32 bucket = hash & entry_mask;
+    const m128 tag = set1_16x8(longLitHashTag(hash));
+    const m128 empty_tag = zeroes128();
+
+    // The table is never full, so there is always an empty entry to stop at.
+    for (;;) {
+        m128 v = loadu128(tags + bucket);
+        u32 empty = movemask128(eq128(v, empty_tag));
+        u32 hits = movemask128(eq128(v, tag));
+        if (empty) {
+            hits &= (empty & -empty) - 1; // only entries before the first empty
+        }
 
-    while (tab[bucket].str_offset != 0) {
-        DEBUG_PRINTF("checking bucket %u\n", bucket);
-        if (confirmLongLiteral(ll_table, scratch, &tab[bucket], nocase)) {
-            DEBUG_PRINTF("found hit for bucket %u\n", bucket);
-            return bucket + 1;
+        while (hits) {
+            u32 b = (bucket + findAndClearLSB_32(&hits)) & entry_mask;
+            DEBUG_PRINTF("checking bucket %u\n", b);
+            assert(tab[b].str_offset != 0);
+            if (confirmLongLiteral(ll_table, scratch, &tab[b], nocase)) {
+                DEBUG_PRINTF("found hit for bucket %u\n", b);
+                return b + 1;
+            }
         }
 
-        if (++bucket == num_entries) {
-            bucket = 0;
+        if (empty) {
+            return 0;
         }
+        bucket = (bucket + LONG_LIT_TAG_PROBE) & entry_mask;
     }
-
-    return 0;
 }
 
 static rose_inline
@@ -102,4 +102,37 @@ u32 bloomHash_3(const u8 *ptr, char nocase) {
     return bloomHash_i(ptr, 8, multiplier, nocase);
 }
 
+/** \brief Number of hash table entries whose tags are checked at once. */
+#define LONG_LIT_TAG_PROBE 16
+
+/**
+ * \brief One-byte tag for a hash table entry. Never zero, as that marks an
+ * empty entry.
+ *
+ * The bucket is picked by the low hashBits bits of the hash, so the tag is
+ * taken from the top byte, which is independent of the bucket for any table
+ * of up to 2^24 entries.
+ */
+static really_inline
+u8 longLitHashTag(u32 hash) {
+    u8 tag = (u8)(hash >> 24);
+    return tag ? tag : 1;
+}
+
+/**
+ * \brief Index of the 64-bit bloom filter word for a key. All three bloom
+ * bits for a key live in the same word, so a lookup touches one cache line.
+ */
+static really_inline
+u32 bloomWordIndex(u32 hash1, u32 word_mask) {
+    return (hash1 >> 6) & word_mask;
+}
+
+/** \brief Bits to set or test in the bloom filter word for a key. */
+static really_inline
+u64a bloomWordBits(u32 hash1, u32 hash2, u32 hash3) {
+    return (1ULL << (hash1 & 63)) | (1ULL << (hash2 & 63)) |
+           (1ULL << (hash3 & 63));
+}
+
 #endif // STREAM_LONG_LIT_HASH_H
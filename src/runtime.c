@@ -147,6 +147,9 @@ void populateCoreInfo(struct hs_scratch *s, const struct RoseEngine *rose,
     s->tctxt.lastMatchOffset = 0;
     s->tctxt.minMatchOffset = offset;
     s->tctxt.minNonMpvMatchOffset = offset;
+
+    s->core_info.matchArray = NULL;
+    s->core_info.matchCounts = NULL;
 }
 
 #define STATUS_VALID_BITS                                                      \
@@ -312,40 +315,24 @@ void runSmallWriteEngine(const struct SmallWriteEngine *smwr,
     }
 }
 
-HS_PUBLIC_API
-hs_error_t HS_CDECL hs_scan(const hs_database_t *db, const char *data,
+/** \brief Block mode scan of a single buffer.
+ *
+ * The caller is responsible for validating the database and scratch, and for
+ * marking the scratch as in use. */
+static really_inline
+hs_error_t hs_scan_internal(const struct RoseEngine *rose, const char *data,
                             unsigned length, unsigned flags,
                             hs_scratch_t *scratch, match_event_handler onEvent,
-                            void *userCtx) {
-    if (unlikely(!scratch || !data)) {
-        return HS_INVALID;
-    }
-
-    hs_error_t err = validDatabase(db);
-    if (unlikely(err != HS_SUCCESS)) {
-        return err;
-    }
-
-    const struct RoseEngine *rose = hs_get_bytecode(db);
-    if (unlikely(!ISALIGNED_16(rose))) {
-        return HS_INVALID;
-    }
-
-    if (unlikely(rose->mode != HS_MODE_BLOCK)) {
-        return HS_DB_MODE_ERROR;
-    }
-
-    if (unlikely(!validScratch(rose, scratch))) {
-        return HS_INVALID;
-    }
+                            void *userCtx, struct match_array *matchArray,
+                            u64a *matchCounts) {
+    assert(rose);
+    assert(scratch);
 
-    if (unlikely(markScratchInUse(scratch))) {
-        return HS_SCRATCH_IN_USE;
-    }
+    SCAN_STAT_ADD(scans, 1);
+    SCAN_STAT_ADD(bytes_scanned, length);
 
     if (rose->minWidth > length) {
         DEBUG_PRINTF("minwidth=%u > length=%u\n", rose->minWidth, length);
-        unmarkScratchInUse(scratch);
         return HS_SUCCESS;
     }
 
@@ -354,6 +341,8 @@ hs_error_t HS_CDECL hs_scan(const hs_database_t *db, const char *data,
     /* populate core info in scratch */
     populateCoreInfo(scratch, rose, scratch->bstate, onEvent, userCtx, data,
                      length, NULL, 0, 0, 0, flags);
+    scratch->core_info.matchArray = matchArray;
+    scratch->core_info.matchCounts = matchCounts;
 
     clearEvec(rose, scratch->core_info.exhaustionVector);
     if (rose->ckeyCount) {
@@ -428,17 +417,14 @@ hs_error_t HS_CDECL hs_scan(const hs_database_t *db, const char *data,
 
 done_scan:
     if (unlikely(internal_matching_error(scratch))) {
-        unmarkScratchInUse(scratch);
         return HS_UNKNOWN_ERROR;
     } else if (told_to_stop_matching(scratch)) {
-        unmarkScratchInUse(scratch);
         return HS_SCAN_TERMINATED;
     }
 
     if (rose->hasSom) {
         int halt = flushStoredSomMatches(scratch, ~0ULL);
         if (halt) {
-            unmarkScratchInUse(scratch);
             return HS_SCAN_TERMINATED;
         }
     }
@@ -450,7 +436,6 @@ done_scan:
 
 set_retval:
     if (unlikely(internal_matching_error(scratch))) {
-        unmarkScratchInUse(scratch);
         return HS_UNKNOWN_ERROR;
     }
 
@@ -458,19 +443,426 @@ set_retval:
         if (roseRunLastFlushCombProgram(rose, scratch, length)
             == MO_HALT_MATCHING) {
             if (unlikely(internal_matching_error(scratch))) {
-                unmarkScratchInUse(scratch);
                 return HS_UNKNOWN_ERROR;
             }
-            unmarkScratchInUse(scratch);
             return HS_SCAN_TERMINATED;
         }
     }
 
     DEBUG_PRINTF("done. told_to_stop_matching=%d\n",
                  told_to_stop_matching(scratch));
-    hs_error_t rv = told_to_stop_matching(scratch) ? HS_SCAN_TERMINATED
-                                                   : HS_SUCCESS;
+    return told_to_stop_matching(scratch) ? HS_SCAN_TERMINATED : HS_SUCCESS;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan(const hs_database_t *db, const char *data,
+                            unsigned length, unsigned flags,
+                            hs_scratch_t *scratch, match_event_handler onEvent,
+                            void *userCtx) {
+    if (unlikely(!scratch || !data)) {
+        return HS_INVALID;
+    }
+
+    hs_error_t err = validDatabase(db);
+    if (unlikely(err != HS_SUCCESS)) {
+        return err;
+    }
+
+    const struct RoseEngine *rose = hs_get_bytecode(db);
+    if (unlikely(!ISALIGNED_16(rose))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(rose->mode != HS_MODE_BLOCK)) {
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(rose->matchCountSlots)) {
+        /* count-only databases must be scanned with hs_scan_count() */
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(!validScratch(rose, scratch))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(markScratchInUse(scratch))) {
+        return HS_SCRATCH_IN_USE;
+    }
+
+    hs_error_t rv = hs_scan_internal(rose, data, length, flags, scratch,
+                                     onEvent, userCtx, NULL, NULL);
+    unmarkScratchInUse(scratch);
+    return rv;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_matches(const hs_database_t *db, const char *data,
+                                    unsigned length, unsigned flags,
+                                    hs_scratch_t *scratch, hs_match_t *matches,
+                                    unsigned capacity, unsigned *count,
+                                    unsigned long long *total) {
+    if (unlikely(!scratch || !data || !count || (capacity && !matches))) {
+        return HS_INVALID;
+    }
+
+    *count = 0;
+    if (total) {
+        *total = 0;
+    }
+
+    hs_error_t err = validDatabase(db);
+    if (unlikely(err != HS_SUCCESS)) {
+        return err;
+    }
+
+    const struct RoseEngine *rose = hs_get_bytecode(db);
+    if (unlikely(!ISALIGNED_16(rose))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(rose->mode != HS_MODE_BLOCK)) {
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(rose->matchCountSlots)) {
+        /* count-only databases must be scanned with hs_scan_count() */
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(!validScratch(rose, scratch))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(markScratchInUse(scratch))) {
+        return HS_SCRATCH_IN_USE;
+    }
+
+    struct match_array ma;
+    ma.matches = matches;
+    ma.capacity = capacity;
+    ma.count = 0;
+    ma.total = 0;
+    ma.count_all = total != NULL;
+    ma.full = 0;
+
+    hs_error_t rv = hs_scan_internal(rose, data, length, flags, scratch, NULL,
+                                     NULL, &ma, NULL);
+    unmarkScratchInUse(scratch);
+
+    *count = ma.count;
+    if (total) {
+        *total = ma.total;
+    }
+
+    if (ma.full && (rv == HS_SUCCESS || rv == HS_SCAN_TERMINATED)) {
+        return HS_INSUFFICIENT_SPACE;
+    }
+
+    return rv;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_count(const hs_database_t *db, const char *data,
+                                  unsigned length, unsigned flags,
+                                  hs_scratch_t *scratch,
+                                  unsigned long long *counts,
+                                  unsigned capacity) {
+    if (unlikely(!scratch || !data || !counts)) {
+        return HS_INVALID;
+    }
+
+    hs_error_t err = validDatabase(db);
+    if (unlikely(err != HS_SUCCESS)) {
+        return err;
+    }
+
+    const struct RoseEngine *rose = hs_get_bytecode(db);
+    if (unlikely(!ISALIGNED_16(rose))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(rose->mode != HS_MODE_BLOCK || !rose->matchCountSlots)) {
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(capacity < rose->matchCountSlots)) {
+        return HS_INSUFFICIENT_SPACE;
+    }
+
+    if (unlikely(!validScratch(rose, scratch))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(markScratchInUse(scratch))) {
+        return HS_SCRATCH_IN_USE;
+    }
+
+    memset(counts, 0, sizeof(*counts) * capacity);
+
+    hs_error_t rv = hs_scan_internal(rose, data, length, flags, scratch, NULL,
+                                     NULL, NULL, (u64a *)counts);
     unmarkScratchInUse(scratch);
+
+    /* there is no callback, so nothing can ask us to terminate */
+    assert(rv != HS_SCAN_TERMINATED);
+    return rv;
+}
+
+/** \brief Smallest chunk that hs_scan_parallel() will split a block into. */
+#define PARALLEL_MIN_CHUNK_LEN 4096
+
+/** \brief Extra bytes scanned past the end of each chunk, so that end of
+ * buffer assertions (including $ before a trailing newline) are not satisfied
+ * at a chunk boundary. */
+#define PARALLEL_TAIL_LEN 2
+
+/** \brief One chunk of a block being scanned by hs_scan_parallel(). */
+struct parallel_chunk {
+    hs_scratch_t *scratch;
+    u64a start; //!< offset of the start of the scanned window
+    u32 len; //!< length of the scanned window
+    u64a min_end; //!< matches must end after this offset...
+    u64a max_end; //!< ... and at or before this offset
+    char first; //!< first chunk, also owns matches ending at min_end
+    hs_match_t *matches; //!< buffered matches, in the order raised
+    u32 count;
+    u32 capacity;
+    hs_error_t rv;
+};
+
+/** \brief Shared context for the tasks run by hs_scan_parallel(). */
+struct parallel_scan {
+    const struct RoseEngine *rose;
+    const char *data;
+    unsigned flags;
+    struct parallel_chunk *chunks;
+};
+
+static
+int HS_CDECL parallel_onEvent(unsigned id, unsigned long long from,
+                              unsigned long long to, UNUSED unsigned flags,
+                              void *ctxt) {
+    struct parallel_chunk *c = ctxt;
+    u64a end = c->start + to;
+
+    if (end <= c->min_end && !(c->first && end == c->min_end)) {
+        return 0; /* owned by the previous chunk */
+    }
+    if (end > c->max_end) {
+        /* owned by the next chunk; we can't stop here, as matches are not
+         * guaranteed to arrive in order of end offset */
+        return 0;
+    }
+
+    if (c->count == c->capacity) {
+        u32 capacity = c->capacity ? c->capacity * 2 : 256;
+        hs_match_t *matches = hs_misc_alloc(capacity * sizeof(hs_match_t));
+        if (!matches) {
+            c->rv = HS_NOMEM;
+            return 1;
+        }
+        if (c->count) {
+            memcpy(matches, c->matches, c->count * sizeof(hs_match_t));
+            hs_misc_free(c->matches);
+        }
+        c->matches = matches;
+        c->capacity = capacity;
+    }
+
+    /* A SOM match can't start at the beginning of a later chunk's window, as
+     * it would be wider than the overlap; so zero always means "no SOM". */
+    hs_match_t *m = c->matches + c->count++;
+    m->id = id;
+    m->from = from ? c->start + from : 0;
+    m->to = end;
+    return 0;
+}
+
+static
+void HS_CDECL parallel_scan_task(void *context, unsigned index) {
+    struct parallel_scan *ps = context;
+    struct parallel_chunk *c = ps->chunks + index;
+
+    DEBUG_PRINTF("chunk %u: window [%llu,%llu), ends (%llu,%llu]\n", index,
+                 c->start, c->start + c->len, c->min_end, c->max_end);
+
+#ifdef SCAN_STATS
+    /* tasks may run on threads that did not mark the scratch in use */
+    hs_scan_stats_t *saved_stats = scan_stats_current;
+    scan_stats_current = c->scratch->stats;
+#endif
+#ifdef SCAN_PROFILE
+    struct hs_scan_profile *saved_profile = scan_profile_current;
+    scan_profile_current = c->scratch->profile;
+    if (c->scratch->profile) {
+        scanProfileStart(c->scratch->profile);
+    }
+#endif
+
+    hs_error_t rv = hs_scan_internal(ps->rose, ps->data + c->start, c->len,
+                                     ps->flags, c->scratch, parallel_onEvent, c,
+                                     NULL, NULL);
+
+#ifdef SCAN_STATS
+    scan_stats_current = saved_stats;
+#endif
+#ifdef SCAN_PROFILE
+    if (c->scratch->profile) {
+        scanProfileStop(c->scratch->profile);
+    }
+    scan_profile_current = saved_profile;
+#endif
+
+    if (c->rv != HS_SUCCESS) {
+        return; /* out of memory */
+    }
+
+    /* our callback only terminates when it runs out of memory */
+    assert(rv != HS_SCAN_TERMINATED);
+    c->rv = rv;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_parallel(const hs_database_t *db, const char *data,
+                                     unsigned length, unsigned flags,
+                                     hs_scratch_t *const *scratch,
+                                     unsigned count, hs_executor_t executor,
+                                     void *executor_context,
+                                     match_event_handler onEvent,
+                                     void *context) {
+    if (unlikely(!scratch || !count || !data)) {
+        return HS_INVALID;
+    }
+
+    hs_error_t err = validDatabase(db);
+    if (unlikely(err != HS_SUCCESS)) {
+        return err;
+    }
+
+    const struct RoseEngine *rose = hs_get_bytecode(db);
+    if (unlikely(!ISALIGNED_16(rose))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(rose->mode != HS_MODE_BLOCK)) {
+        return HS_DB_MODE_ERROR;
+    }
+
+    if (unlikely(rose->matchCountSlots)) {
+        /* count-only databases must be scanned with hs_scan_count() */
+        return HS_DB_MODE_ERROR;
+    }
+
+    /* work out how many chunks are worthwhile */
+    u32 chunk_count = 1;
+    if (rose->maxMatchWidth != ROSE_BOUND_INF) {
+        u64a min_chunk_len = MAX(PARALLEL_MIN_CHUNK_LEN,
+                                 4 * ((u64a)rose->maxMatchWidth +
+                                      PARALLEL_TAIL_LEN));
+        chunk_count = MIN(count, MAX(1, length / min_chunk_len));
+    }
+
+    for (u32 i = 0; i < chunk_count; i++) {
+        if (unlikely(!validScratch(rose, scratch[i]))) {
+            return HS_INVALID;
+        }
+    }
+
+    if (chunk_count == 1) {
+        DEBUG_PRINTF("scanning len=%u on the calling thread\n", length);
+        if (unlikely(markScratchInUse(scratch[0]))) {
+            return HS_SCRATCH_IN_USE;
+        }
+        hs_error_t rv = hs_scan_internal(rose, data, length, flags,
+                                         scratch[0], onEvent, context, NULL,
+                                         NULL);
+        unmarkScratchInUse(scratch[0]);
+        return rv;
+    }
+
+    struct parallel_chunk *chunks =
+        hs_misc_alloc(chunk_count * sizeof(struct parallel_chunk));
+    if (!chunks) {
+        return HS_NOMEM;
+    }
+
+    const u64a overlap = rose->maxMatchWidth;
+    for (u32 i = 0; i < chunk_count; i++) {
+        struct parallel_chunk *c = chunks + i;
+        u64a min_end = (u64a)length * i / chunk_count;
+        u64a max_end = (u64a)length * (i + 1) / chunk_count;
+        u64a start = min_end > overlap ? min_end - overlap : 0;
+        u64a end = MIN(max_end + PARALLEL_TAIL_LEN, length);
+
+        c->scratch = scratch[i];
+        c->start = start;
+        c->len = (u32)(end - start);
+        c->min_end = min_end;
+        c->max_end = max_end;
+        c->first = i == 0;
+        c->matches = NULL;
+        c->count = 0;
+        c->capacity = 0;
+        c->rv = HS_SUCCESS;
+    }
+
+    struct parallel_scan ps;
+    ps.rose = rose;
+    ps.data = data;
+    ps.flags = flags;
+    ps.chunks = chunks;
+
+    hs_error_t rv = HS_SUCCESS;
+    u32 marked = 0;
+    for (; marked < chunk_count; marked++) {
+        if (unlikely(markScratchInUse(scratch[marked]))) {
+            rv = HS_SCRATCH_IN_USE;
+            goto done;
+        }
+    }
+
+    if (executor) {
+        executor(parallel_scan_task, &ps, chunk_count, executor_context);
+    } else {
+        for (u32 i = 0; i < chunk_count; i++) {
+            parallel_scan_task(&ps, i);
+        }
+    }
+
+    for (u32 i = 0; i < chunk_count; i++) {
+        if (chunks[i].rv != HS_SUCCESS) {
+            rv = chunks[i].rv;
+            goto done;
+        }
+    }
+
+    /* Each match is owned by the chunk its end offset falls in, so delivering
+     * the chunks in turn gives us every match exactly once. */
+    if (onEvent) {
+        for (u32 i = 0; i < chunk_count; i++) {
+            const struct parallel_chunk *c = chunks + i;
+            for (u32 j = 0; j < c->count; j++) {
+                const hs_match_t *m = c->matches + j;
+                if (onEvent(m->id, m->from, m->to, 0, context)) {
+                    rv = HS_SCAN_TERMINATED;
+                    goto done;
+                }
+            }
+        }
+    }
+
+done:
+    /* in reverse, as each unmark restores the state saved by its mark */
+    for (u32 i = marked; i > 0; i--) {
+        unmarkScratchInUse(scratch[i - 1]);
+    }
+    for (u32 i = 0; i < chunk_count; i++) {
+        if (chunks[i].matches) {
+            hs_misc_free(chunks[i].matches);
+        }
+    }
+    hs_misc_free(chunks);
     return rv;
 }
 
@@ -878,6 +1270,9 @@ hs_error_t hs_scan_stream_internal(hs_stream_t *id, const char *data,
         return HS_INVALID;
     }
 
+    SCAN_STAT_ADD(scans, 1);
+    SCAN_STAT_ADD(bytes_scanned, length);
+
     const struct RoseEngine *rose = id->rose;
     char *state = getMultiState(id);
 
@@ -995,6 +1390,105 @@ hs_error_t HS_CDECL hs_scan_stream(hs_stream_t *id, const char *data,
     return rv;
 }
 
+/** \brief Context used to route matches from a batched scan to the user's
+ * callback, tagged with the index of the batch entry that raised them. */
+struct batch_context {
+    match_batch_event_handler onEvent;
+    void *userCtx;
+    unsigned int index;
+};
+
+static
+int HS_CDECL batch_onEvent(unsigned id, unsigned long long from,
+                           unsigned long long to, unsigned flags, void *ctxt) {
+    const struct batch_context *bc = ctxt;
+    return bc->onEvent(bc->index, id, from, to, flags, bc->userCtx);
+}
+
+/** \brief Pull in the header of a stream that we are about to scan and the
+ * start of its state, which holds the status byte, so that the first lookups
+ * do not stall. The state follows the header directly, so the two often share
+ * a cache line. */
+static really_inline
+void prefetch_stream(const struct hs_stream *id, const char *data) {
+    __builtin_prefetch(id);
+    __builtin_prefetch(getMultiStateConst(id));
+    __builtin_prefetch(data);
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_stream_batch(hs_stream_t *const *ids,
+                                         const char *const *data,
+                                         const unsigned int *length,
+                                         unsigned int count, unsigned int flags,
+                                         hs_scratch_t *scratch,
+                                         match_batch_event_handler onEvent,
+                                         void *context) {
+    if (unlikely(!ids || !data || !length || !scratch)) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(!count)) {
+        return HS_SUCCESS;
+    }
+
+    if (unlikely(!ids[0] || !validScratch(ids[0]->rose, scratch))) {
+        return HS_INVALID;
+    }
+
+    if (unlikely(markScratchInUse(scratch))) {
+        return HS_SCRATCH_IN_USE;
+    }
+
+    /* scratch only needs to be rechecked when the database changes */
+    const struct RoseEngine *checked = ids[0]->rose;
+
+    struct batch_context bc;
+    bc.onEvent = onEvent;
+    bc.userCtx = context;
+    bc.index = 0;
+
+    hs_error_t rv = HS_SUCCESS;
+    for (u32 i = 0; i < count; i++) {
+        hs_stream_t *id = ids[i];
+        if (unlikely(!id)) {
+            rv = HS_INVALID;
+            break;
+        }
+
+        if (i + 1 < count && ids[i + 1]) {
+            prefetch_stream(ids[i + 1], data[i + 1]);
+        }
+
+        if (unlikely(id->rose != checked)) {
+            if (unlikely(!validScratch(id->rose, scratch))) {
+                rv = HS_INVALID;
+                break;
+            }
+            checked = id->rose;
+        }
+
+        DEBUG_PRINTF("batch entry %u/%u offset=%llu len=%u\n", i, count,
+                     id->offset, length[i]);
+
+        bc.index = i;
+        hs_error_t ret = hs_scan_stream_internal(id, data[i], length[i], flags,
+                                                 scratch,
+                                                 onEvent ? batch_onEvent : NULL,
+                                                 &bc);
+        if (ret == HS_SCAN_TERMINATED) {
+            /* only this stream is halted; carry on with the rest */
+            rv = HS_SCAN_TERMINATED;
+        } else if (unlikely(ret != HS_SUCCESS)) {
+            rv = ret;
+            break;
+        }
+    }
+
+    unmarkScratchInUse(scratch);
+    return rv;
+}
+
 HS_PUBLIC_API
 hs_error_t HS_CDECL hs_close_stream(hs_stream_t *id, hs_scratch_t *scratch,
                                     match_event_handler onEvent,
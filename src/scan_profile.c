@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Allocation and reporting of scan cost profiles, see
+ * hs_alloc_scan_profile().
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "database.h"
+#include "hs_internal.h"
+#include "hs_runtime.h"
+#include "scan_stats.h"
+#include "ue2common.h"
+#include "rose/rose_internal.h"
+
+#ifdef SCAN_PROFILE
+
+static
+u32 bucketCount(const struct RoseProfileMap *pm) {
+    return pm->programCount + pm->queueCount;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_alloc_scan_profile(const hs_database_t *db,
+                                          hs_scan_profile_t **profile) {
+    if (!profile) {
+        return HS_INVALID;
+    }
+    *profile = NULL;
+
+    hs_error_t ret = validDatabase(db);
+    if (ret != HS_SUCCESS) {
+        return ret;
+    }
+
+    const struct RoseEngine *rose = hs_get_bytecode(db);
+    if (!ISALIGNED_16(rose)) {
+        return HS_INVALID;
+    }
+
+    if (!rose->profileMapOffset) {
+        DEBUG_PRINTF("database was built without a profile map\n");
+        return HS_INVALID;
+    }
+
+    const struct RoseProfileMap *pm =
+        (const struct RoseProfileMap *)((const char *)rose +
+                                        rose->profileMapOffset);
+    const u32 buckets = bucketCount(pm);
+    const u32 indexCount = ((const u32 *)((const char *)rose +
+                                          pm->bucketsOffset))[buckets];
+
+    /* ticks come first to keep them aligned, then copies of the map arrays so
+     * that the profile outlives the database */
+    size_t ticksLen = sizeof(u64a) * (buckets + 1);
+    size_t programsLen = sizeof(u32) * pm->programCount;
+    size_t startsLen = sizeof(u32) * (buckets + 1);
+    size_t indexLen = sizeof(u32) * indexCount;
+    size_t idsLen = sizeof(u32) * pm->exprCount;
+    size_t len = sizeof(struct hs_scan_profile) + ticksLen + programsLen +
+                 startsLen + indexLen + idsLen;
+
+    char *mem = hs_misc_alloc(len);
+    ret = hs_check_alloc(mem);
+    if (ret != HS_SUCCESS) {
+        hs_misc_free(mem);
+        return ret;
+    }
+    memset(mem, 0, len);
+
+    struct hs_scan_profile *p = (struct hs_scan_profile *)mem;
+    char *curr = mem + sizeof(*p);
+    p->ticks = (u64a *)curr;
+    curr += ticksLen;
+
+    u32 *programs = (u32 *)curr;
+    if (programsLen) {
+        memcpy(programs, (const char *)rose + pm->programsOffset,
+               programsLen);
+    }
+    curr += programsLen;
+
+    u32 *starts = (u32 *)curr;
+    memcpy(starts, (const char *)rose + pm->bucketsOffset, startsLen);
+    curr += startsLen;
+
+    u32 *index = (u32 *)curr;
+    if (indexLen) {
+        memcpy(index, (const char *)rose + pm->exprIndexOffset, indexLen);
+    }
+    curr += indexLen;
+
+    u32 *ids = (u32 *)curr;
+    if (idsLen) {
+        memcpy(ids, (const char *)rose + pm->exprIdsOffset, idsLen);
+    }
+
+    p->rose = rose;
+    p->programs = programs;
+    p->programCount = pm->programCount;
+    p->queueCount = pm->queueCount;
+    p->current = buckets;
+    p->bucketStarts = starts;
+    p->exprIndex = index;
+    p->exprIds = ids;
+    p->exprCount = pm->exprCount;
+
+    DEBUG_PRINTF("profile with %u buckets over %u expressions\n", buckets,
+                 p->exprCount);
+    *profile = p;
+    return HS_SUCCESS;
+}
+
+static
+int cmpCost(const void *a, const void *b) {
+    const hs_expression_cost_t *x = a;
+    const hs_expression_cost_t *y = b;
+    if (x->ticks != y->ticks) {
+        return x->ticks > y->ticks ? -1 : 1;
+    }
+    return x->id < y->id ? -1 : x->id > y->id;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_profile_costs(const hs_scan_profile_t *profile,
+                                          hs_expression_cost_t *costs,
+                                          unsigned int capacity,
+                                          unsigned int *count,
+                                          unsigned long long *unattributed) {
+    if (!profile || (!costs && capacity)) {
+        return HS_INVALID;
+    }
+
+    const u32 buckets = scanProfileUnattributed(profile);
+    u64a lost = profile->ticks[buckets];
+
+    hs_expression_cost_t *all = NULL;
+    if (profile->exprCount) {
+        all = hs_misc_alloc(sizeof(*all) * profile->exprCount);
+        hs_error_t ret = hs_check_alloc(all);
+        if (ret != HS_SUCCESS) {
+            hs_misc_free(all);
+            return ret;
+        }
+        for (u32 i = 0; i < profile->exprCount; i++) {
+            all[i].id = profile->exprIds[i];
+            all[i].ticks = 0;
+        }
+    }
+
+    /* work shared by several expressions is split evenly between them */
+    for (u32 b = 0; b < buckets; b++) {
+        u64a ticks = profile->ticks[b];
+        u32 start = profile->bucketStarts[b];
+        u32 n = profile->bucketStarts[b + 1] - start;
+        if (!n) {
+            lost += ticks;
+            continue;
+        }
+        for (u32 i = 0; i < n; i++) {
+            all[profile->exprIndex[start + i]].ticks +=
+                ticks / n + (i < ticks % n);
+        }
+    }
+
+    u32 found = 0;
+    for (u32 i = 0; i < profile->exprCount; i++) {
+        if (all[i].ticks) {
+            all[found++] = all[i];
+        }
+    }
+
+    if (found) {
+        qsort(all, found, sizeof(*all), cmpCost);
+    }
+
+    u32 written = MIN(found, capacity);
+    if (written) {
+        memcpy(costs, all, sizeof(*all) * written);
+    }
+    if (all) {
+        hs_misc_free(all);
+    }
+
+    if (count) {
+        *count = written;
+    }
+    if (unattributed) {
+        *unattributed = lost;
+    }
+    return HS_SUCCESS;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_free_scan_profile(hs_scan_profile_t *profile) {
+    if (profile) {
+        hs_misc_free(profile);
+    }
+    return HS_SUCCESS;
+}
+
+#else
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_alloc_scan_profile(const hs_database_t *db,
+                                          hs_scan_profile_t **profile) {
+    (void)db;
+    if (profile) {
+        *profile = NULL;
+    }
+    return HS_INVALID;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_scan_profile_costs(const hs_scan_profile_t *profile,
+                                          hs_expression_cost_t *costs,
+                                          unsigned int capacity,
+                                          unsigned int *count,
+                                          unsigned long long *unattributed) {
+    (void)profile;
+    (void)costs;
+    (void)capacity;
+    (void)count;
+    (void)unattributed;
+    return HS_INVALID;
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_free_scan_profile(hs_scan_profile_t *profile) {
+    return profile ? HS_INVALID : HS_SUCCESS;
+}
+
+#endif // SCAN_PROFILE
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Optional runtime statistics and profiling, see hs_set_scan_stats()
+ * and hs_set_scan_profile().
+ *
+ * When the library is built with SCAN_STATS, the statistics structure
+ * registered with the scratch in use by the current thread is published in a
+ * thread-local pointer for the duration of the API call, so that engines
+ * without access to scratch can still update it. Otherwise, SCAN_STAT_ADD()
+ * compiles to nothing.
+ *
+ * SCAN_PROFILE builds publish the registered profile in the same way. Time is
+ * charged to one bucket at a time: the SCAN_PROFILE_*_BEGIN() macros switch
+ * to the bucket for a Rose program or engine queue, and SCAN_PROFILE_END()
+ * switches back to the bucket that was being charged before. Code without a
+ * bucket of its own is charged to the enclosing one.
+ */
+
+#ifndef SCAN_STATS_H
+#define SCAN_STATS_H
+
+#include "hs_runtime.h"
+#include "ue2common.h"
+
+#if defined(SCAN_STATS) || defined(SCAN_PROFILE)
+#if defined(_MSC_VER)
+#define SCAN_STATS_THREAD_LOCAL __declspec(thread)
+#elif defined(__cplusplus)
+#define SCAN_STATS_THREAD_LOCAL thread_local
+#else
+#define SCAN_STATS_THREAD_LOCAL _Thread_local
+#endif
+#endif
+
+#ifdef SCAN_STATS
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** \brief Statistics for the scan running on this thread, or NULL. */
+extern SCAN_STATS_THREAD_LOCAL hs_scan_stats_t *scan_stats_current;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#define SCAN_STAT_ADD(field, n)                                               \
+    do {                                                                      \
+        hs_scan_stats_t *scan_stats_ = scan_stats_current;                    \
+        if (unlikely(scan_stats_ != NULL)) {                                  \
+            scan_stats_->field += (n);                                        \
+        }                                                                     \
+    } while (0)
+
+#else
+
+#define SCAN_STAT_ADD(field, n)                                               \
+    do {                                                                      \
+    } while (0)
+
+#endif // SCAN_STATS
+
+#ifdef SCAN_PROFILE
+
+#include "util/intrinsics.h"
+
+#if !defined(ARCH_IA32) && !defined(ARCH_X86_64) && \
+    !defined(ARCH_AARCH64) && !defined(ARCH_PPC64EL)
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** \brief Tick counts gathered for a database; see hs_alloc_scan_profile(). */
+struct hs_scan_profile {
+    const void *rose; /**< RoseEngine the buckets describe */
+    const u32 *programs; /**< sorted program offsets, one bucket each */
+    u32 programCount; /**< number of program buckets */
+    u32 queueCount; /**< number of queue buckets, after the programs */
+    u32 current; /**< bucket being charged */
+    u64a last; /**< tick count when current was last charged */
+    u64a *ticks; /**< ticks per bucket; the last is for unattributed time */
+    const u32 *bucketStarts; /**< start of each bucket's run in exprIndex */
+    const u32 *exprIndex; /**< indices into exprIds, by bucket */
+    const u32 *exprIds; /**< sorted distinct expression ids */
+    u32 exprCount; /**< number of entries in exprIds */
+};
+
+/** \brief Profile for the scan running on this thread, or NULL. */
+extern SCAN_STATS_THREAD_LOCAL struct hs_scan_profile *scan_profile_current;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+static really_inline
+u64a scanProfileTicks(void) {
+#if defined(ARCH_IA32) || defined(ARCH_X86_64)
+    return __rdtsc();
+#elif defined(ARCH_AARCH64)
+    u64a ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#elif defined(ARCH_PPC64EL)
+    return __builtin_ppc_get_timebase();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64a)ts.tv_sec * 1000000000ULL + (u64a)ts.tv_nsec;
+#endif
+}
+
+static really_inline
+u32 scanProfileUnattributed(const struct hs_scan_profile *p) {
+    return p->programCount + p->queueCount;
+}
+
+/** \brief Charge the time since the last switch to the current bucket and
+ * make \p bucket current. Returns the previously current bucket. */
+static really_inline
+u32 scanProfileSwitch(struct hs_scan_profile *p, u32 bucket) {
+    u64a now = scanProfileTicks();
+    p->ticks[p->current] += now - p->last;
+    p->last = now;
+    u32 prev = p->current;
+    p->current = bucket;
+    return prev;
+}
+
+/** \brief Start charging time to the unattributed bucket. */
+static really_inline
+void scanProfileStart(struct hs_scan_profile *p) {
+    p->current = scanProfileUnattributed(p);
+    p->last = scanProfileTicks();
+}
+
+/** \brief Charge any outstanding time to the current bucket. */
+static really_inline
+void scanProfileStop(struct hs_scan_profile *p) {
+    scanProfileSwitch(p, scanProfileUnattributed(p));
+}
+
+static really_inline
+u32 scanProfileProgramBucket(const struct hs_scan_profile *p,
+                             const void *rose, u32 programOffset) {
+    if (p->rose != rose) {
+        return p->current;
+    }
+
+    u32 lo = 0;
+    u32 hi = p->programCount;
+    while (lo < hi) {
+        u32 mid = lo + (hi - lo) / 2;
+        if (p->programs[mid] < programOffset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < p->programCount && p->programs[lo] == programOffset) {
+        return lo;
+    }
+    return p->current;
+}
+
+static really_inline
+u32 scanProfileQueueBucket(const struct hs_scan_profile *p, const void *rose,
+                           u32 qi) {
+    if (p->rose != rose || qi >= p->queueCount) {
+        return p->current;
+    }
+    return p->programCount + qi;
+}
+
+#define SCAN_PROFILE_BEGIN_(bucket)                                           \
+    struct hs_scan_profile *scan_profile_ = scan_profile_current;             \
+    u32 scan_profile_prev_ = 0;                                               \
+    if (unlikely(scan_profile_ != NULL)) {                                    \
+        scan_profile_prev_ = scanProfileSwitch(scan_profile_, (bucket));      \
+    }
+
+/** \brief Charge time to the given Rose program until SCAN_PROFILE_END(). */
+#define SCAN_PROFILE_PROGRAM_BEGIN(rose, offset)                              \
+    SCAN_PROFILE_BEGIN_(                                                      \
+        scanProfileProgramBucket(scan_profile_, (rose), (offset)))
+
+/** \brief Charge time to the given engine queue until SCAN_PROFILE_END(). */
+#define SCAN_PROFILE_QUEUE_BEGIN(rose, qi)                                    \
+    SCAN_PROFILE_BEGIN_(scanProfileQueueBucket(scan_profile_, (rose), (qi)))
+
+#define SCAN_PROFILE_END()                                                    \
+    do {                                                                      \
+        if (unlikely(scan_profile_ != NULL)) {                                \
+            scanProfileSwitch(scan_profile_, scan_profile_prev_);             \
+        }                                                                     \
+    } while (0)
+
+#else
+
+#define SCAN_PROFILE_PROGRAM_BEGIN(rose, offset)
+#define SCAN_PROFILE_QUEUE_BEGIN(rose, qi)
+#define SCAN_PROFILE_END()                                                    \
+    do {                                                                      \
+    } while (0)
+
+#endif // SCAN_PROFILE
+
+#endif // SCAN_STATS_H
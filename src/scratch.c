@@ -44,6 +44,14 @@
 #include "rose/rose_internal.h"
 #include "util/fatbit.h"
 
+#ifdef SCAN_STATS
+SCAN_STATS_THREAD_LOCAL hs_scan_stats_t *scan_stats_current = NULL;
+#endif
+
+#ifdef SCAN_PROFILE
+SCAN_STATS_THREAD_LOCAL struct hs_scan_profile *scan_profile_current = NULL;
+#endif
+
 /**
  * Determine the space required for a correctly aligned array of fatbit
  * structure, laid out as:
@@ -402,6 +410,13 @@ hs_error_t HS_CDECL hs_clone_scratch(const hs_scratch_t *src,
         return ret;
     }
 
+#ifdef SCAN_STATS
+    (*dest)->stats = NULL;
+#endif
+#ifdef SCAN_PROFILE
+    (*dest)->profile = NULL;
+#endif
+
     assert(!(*dest)->in_use);
     return HS_SUCCESS;
 }
@@ -430,6 +445,49 @@ hs_error_t HS_CDECL hs_free_scratch(hs_scratch_t *scratch) {
     return HS_SUCCESS;
 }
 
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_set_scan_stats(hs_scratch_t *scratch,
+                                      hs_scan_stats_t *stats) {
+    if (!scratch || !ISALIGNED_CL(scratch) ||
+        scratch->magic != SCRATCH_MAGIC) {
+        return HS_INVALID;
+    }
+
+#ifdef SCAN_STATS
+    if (markScratchInUse(scratch)) {
+        return HS_SCRATCH_IN_USE;
+    }
+    scratch->stats = stats;
+    unmarkScratchInUse(scratch);
+    return HS_SUCCESS;
+#else
+    return stats ? HS_INVALID : HS_SUCCESS;
+#endif
+}
+
+HS_PUBLIC_API
+hs_error_t HS_CDECL hs_set_scan_profile(hs_scratch_t *scratch,
+                                        hs_scan_profile_t *profile) {
+    if (!scratch || !ISALIGNED_CL(scratch) ||
+        scratch->magic != SCRATCH_MAGIC) {
+        return HS_INVALID;
+    }
+
+#ifdef SCAN_PROFILE
+    if (markScratchInUse(scratch)) {
+        return HS_SCRATCH_IN_USE;
+    }
+    scratch->profile = profile;
+    if (profile) {
+        scanProfileStart(profile); /* as unmarking will charge it */
+    }
+    unmarkScratchInUse(scratch);
+    return HS_SUCCESS;
+#else
+    return profile ? HS_INVALID : HS_SUCCESS;
+#endif
+}
+
 HS_PUBLIC_API
 hs_error_t HS_CDECL hs_scratch_size(const hs_scratch_t *scratch, size_t *size) {
     if (!size || !scratch || !ISALIGNED_CL(scratch) ||
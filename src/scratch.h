@@ -37,6 +37,8 @@
 #define SCRATCH_H_DA6D4FC06FF410
 
 #include "hs_common.h"
+#include "hs_runtime.h"
+#include "scan_stats.h"
 #include "ue2common.h"
 #include "rose/rose_types.h"
 
@@ -87,6 +89,16 @@ struct catchup_pq {
 /** \brief Status flag: Unexpected Rose program error. */
 #define STATUS_ERROR        (1U << 3)
 
+/** \brief Destination for matches when scanning with hs_scan_matches(). */
+struct match_array {
+    hs_match_t *matches; /**< user-supplied match records */
+    u32 capacity; /**< number of records in matches */
+    u32 count; /**< number of records written so far */
+    u64a total; /**< number of matches seen so far, written or not */
+    u8 count_all; /**< carry on counting matches once the array is full */
+    u8 full; /**< set when a match arrived with no room left for it */
+};
+
 /** \brief Core information about the current scan, used everywhere. */
 struct core_info {
     void *userContext; /**< user-supplied context */
@@ -107,6 +119,14 @@ struct core_info {
     size_t hlen; /**< length of history buffer in bytes. */
     u64a buf_offset; /**< stream offset, for the base of the buffer */
     u8 status; /**< stream status bitmask, using STATUS_ flags above */
+
+    /** \brief if non-NULL, matches are appended to this array instead of
+     * being passed to userCallback */
+    struct match_array *matchArray;
+
+    /** \brief per-report match counters, indexed by external report id; only
+     * used by count-only (HS_MODE_COUNT) databases */
+    u64a *matchCounts;
 };
 
 /** \brief Rose state information. */
@@ -211,6 +231,14 @@ struct ALIGN_CL_DIRECTIVE hs_scratch {
     u64a *fdr_conf; /**< FDR confirm value */
     u8 fdr_conf_offset; /**< offset where FDR/Teddy front end matches
                          * in buffer */
+#ifdef SCAN_STATS
+    hs_scan_stats_t *stats; /**< user statistics, see hs_set_scan_stats() */
+    hs_scan_stats_t *saved_stats; /**< scan_stats_current on entry */
+#endif
+#ifdef SCAN_PROFILE
+    struct hs_scan_profile *profile; /**< see hs_set_scan_profile() */
+    struct hs_scan_profile *saved_profile; /**< scan_profile_current on entry */
+#endif
 };
 
 /* array of fatbit ptr; TODO: why not an array of fatbits? */
@@ -240,6 +268,39 @@ char internal_matching_error(const struct hs_scratch *scratch) {
     return scratch->core_info.status & STATUS_ERROR;
 }
 
+/**
+ * \brief Hand a match to the user.
+ *
+ * The match is appended to the match array if we are filling one, and passed
+ * to the user callback otherwise. Returns non-zero if matching should cease.
+ */
+static really_inline
+int deliverUserMatch(struct core_info *ci, u32 id, u64a from, u64a to,
+                     u32 flags) {
+    struct match_array *ma = ci->matchArray;
+    if (likely(!ma)) {
+        SCAN_STAT_ADD(reports, 1);
+        return ci->userCallback(id, from, to, flags, ci->userContext);
+    }
+
+    ma->total++;
+
+    if (ma->count == ma->capacity) {
+        DEBUG_PRINTF("match array full\n");
+        ma->full = 1;
+        /* only carry on if the caller wants the total */
+        return !ma->count_all;
+    }
+
+    SCAN_STAT_ADD(reports, 1);
+
+    hs_match_t *m = ma->matches + ma->count++;
+    m->id = id;
+    m->from = from;
+    m->to = to;
+    return 0;
+}
+
 /**
  * \brief Mark scratch as in use.
  *
@@ -254,6 +315,17 @@ char markScratchInUse(struct hs_scratch *scratch) {
         return 1;
     }
     scratch->in_use = 1;
+#ifdef SCAN_STATS
+    scratch->saved_stats = scan_stats_current;
+    scan_stats_current = scratch->stats;
+#endif
+#ifdef SCAN_PROFILE
+    scratch->saved_profile = scan_profile_current;
+    scan_profile_current = scratch->profile;
+    if (scratch->profile) {
+        scanProfileStart(scratch->profile);
+    }
+#endif
     return 0;
 }
 
@@ -266,6 +338,15 @@ void unmarkScratchInUse(struct hs_scratch *scratch) {
     assert(scratch && scratch->magic == SCRATCH_MAGIC);
     assert(scratch->in_use == 1);
     scratch->in_use = 0;
+#ifdef SCAN_STATS
+    scan_stats_current = scratch->saved_stats;
+#endif
+#ifdef SCAN_PROFILE
+    if (scratch->profile) {
+        scanProfileStop(scratch->profile);
+    }
+    scan_profile_current = scratch->saved_profile;
+#endif
 }
 
 #ifdef __cplusplus
@@ -484,8 +484,7 @@ int clearSomLog(struct hs_scratch *scratch, u64a offset, struct fatbit *log,
              it != MMB_INVALID; it = fatbit_iterate(log, dkeyCount, it)) {
         u64a from_offset = starts[it];
         u32 onmatch = dkey_to_report[it];
-        int halt = ci->userCallback(onmatch, from_offset, offset, flags,
-                                    ci->userContext);
+        int halt = deliverUserMatch(ci, onmatch, from_offset, offset, flags);
         if (halt) {
             ci->status |= STATUS_TERMINATED;
             return 1;
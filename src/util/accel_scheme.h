@@ -32,7 +32,9 @@
 #include "util/charreach.h"
 #include "util/flat_containers.h"
 
+#include <array>
 #include <utility>
+#include <vector>
 
 namespace ue2 {
 
@@ -44,6 +46,8 @@ struct AccelScheme {
     CharReach double_cr;
     u32 offset = MAX_ACCEL_DEPTH + 1;
     u32 double_offset = 0;
+    std::vector<std::array<CharReach, 3>> triple; // triple shufti buckets
+    u32 triple_offset = 0;
 };
 
 }
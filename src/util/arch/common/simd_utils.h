@@ -805,4 +805,354 @@ char testbit512(m512 val, unsigned int n) {
 
 #endif // HAVE_SIMD_512_BITS
 
+/****
+ **** 768-bit Primitives
+ ****/
+
+static really_inline m768 and768(m768 a, m768 b) {
+    m768 rv;
+    rv.lo = and256(a.lo, b.lo);
+    rv.mid = and256(a.mid, b.mid);
+    rv.hi = and256(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline m768 or768(m768 a, m768 b) {
+    m768 rv;
+    rv.lo = or256(a.lo, b.lo);
+    rv.mid = or256(a.mid, b.mid);
+    rv.hi = or256(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline m768 xor768(m768 a, m768 b) {
+    m768 rv;
+    rv.lo = xor256(a.lo, b.lo);
+    rv.mid = xor256(a.mid, b.mid);
+    rv.hi = xor256(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline m768 not768(m768 a) {
+    m768 rv;
+    rv.lo = not256(a.lo);
+    rv.mid = not256(a.mid);
+    rv.hi = not256(a.hi);
+    return rv;
+}
+
+static really_inline m768 andnot768(m768 a, m768 b) {
+    m768 rv;
+    rv.lo = andnot256(a.lo, b.lo);
+    rv.mid = andnot256(a.mid, b.mid);
+    rv.hi = andnot256(a.hi, b.hi);
+    return rv;
+}
+
+static really_really_inline
+m768 lshift64_m768(m768 a, unsigned b) {
+    m768 rv;
+    rv.lo = lshift64_m256(a.lo, b);
+    rv.mid = lshift64_m256(a.mid, b);
+    rv.hi = lshift64_m256(a.hi, b);
+    return rv;
+}
+
+static really_inline m768 zeroes768(void) {
+    m768 rv = {zeroes256(), zeroes256(), zeroes256()};
+    return rv;
+}
+
+static really_inline m768 ones768(void) {
+    m768 rv = {ones256(), ones256(), ones256()};
+    return rv;
+}
+
+static really_inline int diff768(m768 a, m768 b) {
+    return diff256(a.lo, b.lo) || diff256(a.mid, b.mid) || diff256(a.hi, b.hi);
+}
+
+static really_inline int isnonzero768(m768 a) {
+    return isnonzero256(or256(or256(a.lo, a.mid), a.hi));
+}
+
+/**
+ * "Rich" version of diff768(). Takes two vectors a and b and returns a 24-bit
+ * mask indicating which 32-bit words contain differences.
+ */
+static really_inline
+u32 diffrich768(m768 a, m768 b) {
+    return diffrich256(a.lo, b.lo) | (diffrich256(a.mid, b.mid) << 8) |
+           (diffrich256(a.hi, b.hi) << 16);
+}
+
+/**
+ * "Rich" version of diff768(), 64-bit variant. Takes two vectors a and b and
+ * returns a 24-bit mask indicating which 64-bit words contain differences.
+ */
+static really_inline u32 diffrich64_768(m768 a, m768 b) {
+    u32 d = diffrich768(a, b);
+    return (d | (d >> 1)) & 0x55555555;
+}
+
+// aligned load
+static really_inline m768 load768(const void *ptr) {
+    assert(ISALIGNED_N(ptr, alignof(m256)));
+    m768 rv = { load256(ptr), load256((const char *)ptr + 32),
+                load256((const char *)ptr + 64) };
+    return rv;
+}
+
+// aligned store
+static really_inline void store768(void *ptr, m768 a) {
+    assert(ISALIGNED_N(ptr, alignof(m256)));
+    m768 *x = (m768 *)ptr;
+    store256(&x->lo, a.lo);
+    store256(&x->mid, a.mid);
+    store256(&x->hi, a.hi);
+}
+
+// unaligned load
+static really_inline m768 loadu768(const void *ptr) {
+    m768 rv = { loadu256(ptr), loadu256((const char *)ptr + 32),
+                loadu256((const char *)ptr + 64) };
+    return rv;
+}
+
+// packed unaligned store of first N bytes
+static really_inline
+void storebytes768(void *ptr, m768 a, unsigned int n) {
+    assert(n <= sizeof(a));
+    memcpy(ptr, &a, n);
+}
+
+// packed unaligned load of first N bytes, pad with zero
+static really_inline
+m768 loadbytes768(const void *ptr, unsigned int n) {
+    m768 a = zeroes768();
+    assert(n <= sizeof(a));
+    memcpy(&a, ptr, n);
+    return a;
+}
+
+// switches on bit N in the given vector.
+static really_inline
+void setbit768(m768 *ptr, unsigned int n) {
+    assert(n < sizeof(*ptr) * 8);
+    m256 *sub;
+    if (n < 256) {
+        sub = &ptr->lo;
+    } else if (n < 512) {
+        sub = &ptr->mid;
+    } else {
+        sub = &ptr->hi;
+    }
+    setbit256(sub, n % 256);
+}
+
+// switches off bit N in the given vector.
+static really_inline
+void clearbit768(m768 *ptr, unsigned int n) {
+    assert(n < sizeof(*ptr) * 8);
+    m256 *sub;
+    if (n < 256) {
+        sub = &ptr->lo;
+    } else if (n < 512) {
+        sub = &ptr->mid;
+    } else {
+        sub = &ptr->hi;
+    }
+    clearbit256(sub, n % 256);
+}
+
+// tests bit N in the given vector.
+static really_inline
+char testbit768(m768 val, unsigned int n) {
+    assert(n < sizeof(val) * 8);
+    m256 sub;
+    if (n < 256) {
+        sub = val.lo;
+    } else if (n < 512) {
+        sub = val.mid;
+    } else {
+        sub = val.hi;
+    }
+    return testbit256(sub, n % 256);
+}
+
+/****
+ **** 1024-bit Primitives
+ ****/
+
+static really_inline
+m1024 zeroes1024(void) {
+    m1024 rv = {zeroes512(), zeroes512()};
+    return rv;
+}
+
+static really_inline
+m1024 ones1024(void) {
+    m1024 rv = {ones512(), ones512()};
+    return rv;
+}
+
+static really_inline
+m1024 and1024(m1024 a, m1024 b) {
+    m1024 rv;
+    rv.lo = and512(a.lo, b.lo);
+    rv.hi = and512(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline
+m1024 or1024(m1024 a, m1024 b) {
+    m1024 rv;
+    rv.lo = or512(a.lo, b.lo);
+    rv.hi = or512(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline
+m1024 xor1024(m1024 a, m1024 b) {
+    m1024 rv;
+    rv.lo = xor512(a.lo, b.lo);
+    rv.hi = xor512(a.hi, b.hi);
+    return rv;
+}
+
+static really_inline
+m1024 not1024(m1024 a) {
+    m1024 rv;
+    rv.lo = not512(a.lo);
+    rv.hi = not512(a.hi);
+    return rv;
+}
+
+static really_inline
+m1024 andnot1024(m1024 a, m1024 b) {
+    m1024 rv;
+    rv.lo = andnot512(a.lo, b.lo);
+    rv.hi = andnot512(a.hi, b.hi);
+    return rv;
+}
+
+static really_really_inline
+m1024 lshift64_m1024(m1024 a, unsigned b) {
+    m1024 rv;
+    rv.lo = lshift64_m512(a.lo, b);
+    rv.hi = lshift64_m512(a.hi, b);
+    return rv;
+}
+
+static really_inline
+int diff1024(m1024 a, m1024 b) {
+    return diff512(a.lo, b.lo) || diff512(a.hi, b.hi);
+}
+
+static really_inline
+int isnonzero1024(m1024 a) {
+    return isnonzero512(or512(a.lo, a.hi));
+}
+
+/**
+ * "Rich" version of diff1024(). Takes two vectors a and b and returns a 32-bit
+ * mask indicating which 32-bit words contain differences.
+ */
+static really_inline
+u32 diffrich1024(m1024 a, m1024 b) {
+    return diffrich512(a.lo, b.lo) | (diffrich512(a.hi, b.hi) << 16);
+}
+
+/**
+ * "Rich" version of diff1024(), 64-bit variant. Takes two vectors a and b and
+ * returns a 32-bit mask indicating which 64-bit words contain differences.
+ */
+static really_inline
+u32 diffrich64_1024(m1024 a, m1024 b) {
+    u32 d = diffrich1024(a, b);
+    return (d | (d >> 1)) & 0x55555555;
+}
+
+// aligned load
+static really_inline
+m1024 load1024(const void *ptr) {
+    assert(ISALIGNED_N(ptr, alignof(m512)));
+    m1024 rv = { load512(ptr), load512((const char *)ptr + 64) };
+    return rv;
+}
+
+// aligned store
+static really_inline
+void store1024(void *ptr, m1024 a) {
+    assert(ISALIGNED_N(ptr, alignof(m512)));
+    m1024 *x = (m1024 *)ptr;
+    store512(&x->lo, a.lo);
+    store512(&x->hi, a.hi);
+}
+
+// unaligned load
+static really_inline
+m1024 loadu1024(const void *ptr) {
+    m1024 rv = { loadu512(ptr), loadu512((const char *)ptr + 64) };
+    return rv;
+}
+
+// packed unaligned store of first N bytes
+static really_inline
+void storebytes1024(void *ptr, m1024 a, unsigned int n) {
+    assert(n <= sizeof(a));
+    memcpy(ptr, &a, n);
+}
+
+// packed unaligned load of first N bytes, pad with zero
+static really_inline
+m1024 loadbytes1024(const void *ptr, unsigned int n) {
+    m1024 a = zeroes1024();
+    assert(n <= sizeof(a));
+    memcpy(&a, ptr, n);
+    return a;
+}
+
+// switches on bit N in the given vector.
+static really_inline
+void setbit1024(m1024 *ptr, unsigned int n) {
+    assert(n < sizeof(*ptr) * 8);
+    m512 *sub;
+    if (n < 512) {
+        sub = &ptr->lo;
+    } else {
+        sub = &ptr->hi;
+        n -= 512;
+    }
+    setbit512(sub, n);
+}
+
+// switches off bit N in the given vector.
+static really_inline
+void clearbit1024(m1024 *ptr, unsigned int n) {
+    assert(n < sizeof(*ptr) * 8);
+    m512 *sub;
+    if (n < 512) {
+        sub = &ptr->lo;
+    } else {
+        sub = &ptr->hi;
+        n -= 512;
+    }
+    clearbit512(sub, n);
+}
+
+// tests bit N in the given vector.
+static really_inline
+char testbit1024(m1024 val, unsigned int n) {
+    assert(n < sizeof(val) * 8);
+    m512 sub;
+    if (n < 512) {
+        sub = val.lo;
+    } else {
+        sub = val.hi;
+        n -= 512;
+    }
+    return testbit512(sub, n);
+}
+
 #endif // ARCH_COMMON_SIMD_UTILS_H
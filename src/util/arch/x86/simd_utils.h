@@ -698,6 +698,8 @@ static really_inline u32 diffrich384(m384 a, m384 b) {
 #define set2x256(a) _mm512_broadcast_i64x4(a)
 #define mask_set2x256(src, k, a) _mm512_mask_broadcast_i64x4(src, k, a)
 #define vpermq512(idx, a) _mm512_permutexvar_epi64(idx, a)
+#define vpermd512(idx, a) _mm512_permutexvar_epi32(idx, a)
+#define vpalignr512(r, l, offset) _mm512_alignr_epi8(r, l, offset)
 
 static really_inline u32 movd512(const m512 in) {
     // NOTE: seems gcc doesn't support _mm512_cvtsi512_si32(in),
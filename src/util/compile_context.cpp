@@ -31,14 +31,25 @@
  */
 #include "compile_context.h"
 #include "grey.h"
+#include "parallel.h"
+#include "traffic_model.h"
+
+using namespace std;
 
 namespace ue2 {
 
 CompileContext::CompileContext(bool in_isStreaming, bool in_isVectored,
                                const target_t &in_target_info,
-                               const Grey &in_grey)
+                               const Grey &in_grey,
+                               bool in_isExistenceOnly, bool in_isCountOnly,
+                               u32 in_numThreads,
+                               shared_ptr<const TrafficModel> in_traffic)
     : streaming(in_isStreaming || in_isVectored),
       vectored(in_isVectored),
+      existenceOnly(in_isExistenceOnly),
+      countOnly(in_isCountOnly),
+      numThreads(resolveThreadCount(in_numThreads)),
+      traffic(std::move(in_traffic)),
       target_info(in_target_info),
       grey(in_grey) {
 }
@@ -35,18 +35,39 @@
 
 #include "target_info.h"
 #include "grey.h"
+#include "ue2common.h"
+
+#include <memory>
 
 namespace ue2 {
 
+class TrafficModel;
+
 /** \brief Structure for describing the compile environment: grey box settings,
  * target arch, mode flags, etc. */
 struct CompileContext {
     CompileContext(bool isStreaming, bool isVectored,
-                   const target_t &target_info, const Grey &grey);
+                   const target_t &target_info, const Grey &grey,
+                   bool isExistenceOnly = false, bool isCountOnly = false,
+                   u32 numThreads = 1,
+                   std::shared_ptr<const TrafficModel> traffic = nullptr);
 
     const bool streaming; /* streaming or vectored mode */
     const bool vectored;
 
+    /** \brief Scanning stops at the first match (HS_MODE_EXISTENCE). */
+    const bool existenceOnly;
+
+    /** \brief Matches are counted per expression id (HS_MODE_COUNT). */
+    const bool countOnly;
+
+    /** \brief Number of threads to use for independent compile work. */
+    const u32 numThreads;
+
+    /** \brief Model of the expected traffic, used to tune the literal
+     * matchers. May be null. */
+    const std::shared_ptr<const TrafficModel> traffic;
+
     /** \brief Target platform info. */
     const target_t target_info;
 
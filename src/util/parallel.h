@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTIL_PARALLEL_H
+#define UTIL_PARALLEL_H
+
+/**
+ * \file
+ * \brief Simple fork-join parallelism for independent compile-time work.
+ */
+
+#include "ue2common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace ue2 {
+
+/**
+ * \brief Resolves a requested compile thread count: zero means one thread per
+ * hardware thread.
+ */
+static inline
+u32 resolveThreadCount(u32 threads) {
+    if (threads) {
+        return threads;
+    }
+    u32 hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+/**
+ * \brief Calls func(i) for each i in [0, count), using up to \a threads
+ * threads (including the calling thread).
+ *
+ * The calls must be independent of each other. If any of them throw, the
+ * exception thrown by the lowest index is rethrown on the calling thread once
+ * all work has stopped, so that errors are reported exactly as they would be
+ * by a serial loop. If threads cannot be created, the remaining work is done
+ * by those that could.
+ */
+template<typename Func>
+void parallel_for(u32 threads, size_t count, Func &&func) {
+    threads = (u32)std::min<size_t>(resolveThreadCount(threads), count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::mutex error_lock;
+    size_t error_index = count; // guarded by error_lock
+    std::exception_ptr error;   // guarded by error_lock
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= count) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (i > error_index) {
+                    // A serial loop would not have got this far.
+                    return;
+                }
+            }
+            try {
+                func(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (i < error_index) {
+                    error_index = i;
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (u32 t = 1; t < threads; t++) {
+        try {
+            pool.emplace_back(worker);
+        } catch (const std::system_error &) {
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto &t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace ue2
+
+#endif // UTIL_PARALLEL_H
@@ -242,6 +242,11 @@ void ReportManager::registerExtReport(ReportID id,
     }
 }
 
+u32 ReportManager::getExpressionIndex(ReportID id) const {
+    assert(contains(externalIdMap, id));
+    return externalIdMap.at(id).first_pattern_index;
+}
+
 Report ReportManager::getBasicInternalReport(const ExpressionInfo &expr,
                                              s32 adj) {
     /* validate that we are not violating highlander constraints, this will
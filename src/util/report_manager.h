@@ -116,6 +116,10 @@ public:
      * thrown). */
     void registerExtReport(ReportID id, const external_report_info &ext);
 
+    /** \brief Index of the first expression registered with the given
+     * external match id. */
+    u32 getExpressionIndex(ReportID id) const;
+
     /** \brief Fetch the ekey associated with the given expression index,
      * assigning one if necessary. */
     u32 getExhaustibleKey(u32 expressionIndex);
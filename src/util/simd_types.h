@@ -56,5 +56,8 @@ typedef struct {m128 lo; m128 mid; m128 hi;} m384;
 typedef struct ALIGN_ATTR(64) {m256 lo; m256 hi;} m512;
 #endif
 
+typedef struct {m256 lo; m256 mid; m256 hi;} m768;
+typedef struct {m512 lo; m512 hi;} m1024;
+
 #endif /* SIMD_TYPES_H */
 
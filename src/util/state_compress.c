@@ -647,3 +647,102 @@ void loadcompressed512(m512 *x, const void *ptr, const m512 *m,
     *x = loadcompressed512_32bit(ptr, *m);
 #endif
 }
+
+/*
+ * 768-bit and 1024-bit store/load. These use the same per-chunk
+ * compress/expand as the smaller sizes, looping over the chunks instead of
+ * unrolling them by hand.
+ */
+
+#if defined(ARCH_64_BIT)
+#define CHUNK_T             u64a
+#define CHUNK_POPCOUNT      popcount64
+#define CHUNK_COMPRESS      compress64
+#define CHUNK_EXPAND        expand64
+#define CHUNK_PACK_BITS     pack_bits_64
+#define CHUNK_UNPACK_BITS   unpack_bits_64
+#else
+#define CHUNK_T             u32
+#define CHUNK_POPCOUNT      popcount32
+#define CHUNK_COMPRESS      compress32
+#define CHUNK_EXPAND        expand32
+#define CHUNK_PACK_BITS     pack_bits_32
+#define CHUNK_UNPACK_BITS   unpack_bits_32
+#endif
+
+#define MAX_CHUNKS (sizeof(m1024) / sizeof(CHUNK_T))
+
+static really_inline
+void storecompressed_chunks(void *ptr, const void *xvec, const void *mvec,
+                            const u32 count) {
+    assert(count <= MAX_CHUNKS);
+
+    // First, decompose our vectors into GPR-sized chunks.
+    CHUNK_T x[MAX_CHUNKS];
+    memcpy(x, xvec, count * sizeof(CHUNK_T));
+    CHUNK_T m[MAX_CHUNKS];
+    memcpy(m, mvec, count * sizeof(CHUNK_T));
+
+    // Count the number of bits of compressed state we're writing out per
+    // chunk, and compress each chunk individually.
+    u32 bits[MAX_CHUNKS];
+    CHUNK_T v[MAX_CHUNKS];
+    for (u32 i = 0; i < count; i++) {
+        bits[i] = CHUNK_POPCOUNT(m[i]);
+        v[i] = CHUNK_COMPRESS(x[i], m[i]);
+    }
+
+    // Write packed data out.
+    CHUNK_PACK_BITS(ptr, v, bits, count);
+}
+
+static really_inline
+void loadcompressed_chunks(void *xvec, const void *ptr, const void *mvec,
+                           const u32 count) {
+    assert(count <= MAX_CHUNKS);
+
+    // First, decompose our vectors into GPR-sized chunks.
+    CHUNK_T m[MAX_CHUNKS];
+    memcpy(m, mvec, count * sizeof(CHUNK_T));
+
+    u32 bits[MAX_CHUNKS];
+    for (u32 i = 0; i < count; i++) {
+        bits[i] = CHUNK_POPCOUNT(m[i]);
+    }
+    CHUNK_T v[MAX_CHUNKS];
+
+    CHUNK_UNPACK_BITS(v, (const u8 *)ptr, bits, count);
+
+    CHUNK_T ALIGN_ATTR(16) x[MAX_CHUNKS];
+#if defined(ARCH_64_BIT) && defined(HAVE_SVE2_BITPERM)
+    for (u32 i = 0; i < count; i += 2) {
+        bdep64x2(&x[i], &v[i], (const m128 *)&m[i]);
+    }
+#else
+    for (u32 i = 0; i < count; i++) {
+        x[i] = CHUNK_EXPAND(v[i], m[i]);
+    }
+#endif
+
+    memcpy(xvec, x, count * sizeof(CHUNK_T));
+}
+
+void storecompressed768(void *ptr, const m768 *x, const m768 *m,
+                        UNUSED u32 bytes) {
+    storecompressed_chunks(ptr, x, m, sizeof(m768) / sizeof(CHUNK_T));
+}
+
+void loadcompressed768(m768 *x, const void *ptr, const m768 *m,
+                       UNUSED u32 bytes) {
+    loadcompressed_chunks(x, ptr, m, sizeof(m768) / sizeof(CHUNK_T));
+}
+
+void storecompressed1024(void *ptr, const m1024 *x, const m1024 *m,
+                         UNUSED u32 bytes) {
+    storecompressed_chunks(ptr, x, m, sizeof(m1024) / sizeof(CHUNK_T));
+}
+
+void loadcompressed1024(m1024 *x, const void *ptr, const m1024 *m,
+                        UNUSED u32 bytes) {
+    loadcompressed_chunks(x, ptr, m, sizeof(m1024) / sizeof(CHUNK_T));
+}
@@ -75,6 +75,12 @@ bool target_t::has_avx512vbmi(void) const {
     return cpu_features & HS_CPU_FEATURES_AVX512VBMI;
 }
 
+bool target_t::has_wide_sheng(void) const {
+    /* AVX2 runs the scalar lookup in sheng_wide.h, which beats McClellan on
+     * the DFAs in benchmarks/dfa_benchmarks.cpp. */
+    return has_avx2() || has_avx512vbmi();
+}
+
 bool target_t::is_atom_class(void) const {
     return tune == HS_TUNE_FAMILY_SLM || tune == HS_TUNE_FAMILY_GLM;
 }
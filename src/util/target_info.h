@@ -44,6 +44,10 @@ struct target_t {
 
     bool has_avx512vbmi(void) const;
 
+    /** \brief True if the runtime for this target implements the 32 and 64
+     * state Sheng engines (Sheng32, Sheng64 and McSheng64). */
+    bool has_wide_sheng(void) const;
+
     bool is_atom_class(void) const;
 
     // This asks: can this target (the object) run on code that was built for
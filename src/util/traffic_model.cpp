@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Byte-level model of the traffic a database is expected to scan.
+ */
+
+#include "traffic_model.h"
+
+#include "crc32.h"
+#include "util/compare.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace ue2 {
+
+/**
+ * \brief Weight of the uniform distribution mixed into the histogram, so that
+ * pairs missing from the sample are unlikely but not impossible.
+ */
+static constexpr double UNIFORM_WEIGHT = 0.01;
+
+TrafficModel::TrafficModel(const unsigned long long *counts)
+    : pairs(256 * 256), nibbles(16 * 2 * 256, 0.0) {
+    assert(counts);
+    crc = Crc32c_ComputeBuf(0, counts, 256 * 256 * sizeof(*counts));
+
+    double total = 0;
+    for (u32 i = 0; i < 256 * 256; i++) {
+        total += (double)counts[i];
+    }
+    assert(total > 0);
+
+    bytes.fill(0.0);
+    for (u32 a = 0; a < 256; a++) {
+        for (u32 b = 0; b < 256; b++) {
+            double &p = pairs[a * 256 + b];
+            p = (1.0 - UNIFORM_WEIGHT) * (double)counts[a * 256 + b] / total +
+                UNIFORM_WEIGHT / (256 * 256);
+            bytes[a] += p;
+        }
+    }
+
+    for (u32 lo = 0; lo < 16; lo++) {
+        for (u32 half = 0; half < 2; half++) {
+            for (u32 v = 0; v < 256; v++) {
+                double p = 0;
+                for (u32 bit = 0; bit < 8; bit++) {
+                    if (v & (1U << bit)) {
+                        u32 hi = half * 8 + bit;
+                        p += bytes[hi << 4 | lo];
+                    }
+                }
+                nibbles[(lo * 2 + half) * 256 + v] = p;
+            }
+        }
+    }
+}
+
+double TrafficModel::nibbleProb(u16 lo, u16 hi) const {
+    double p = 0;
+    for (u32 i = 0; i < 16; i++) {
+        if (!(lo & (1U << i))) {
+            continue;
+        }
+        p += nibbles[(i * 2) * 256 + (hi & 0xff)];
+        p += nibbles[(i * 2 + 1) * 256 + (hi >> 8)];
+    }
+    return p;
+}
+
+double TrafficModel::stringProb(const string &s, bool nocase) const {
+    // Forward pass over a first-order Markov chain, tracking the probability
+    // of each case variant of the current character.
+    u8 prev[2] = {0, 0};
+    double prevProb[2] = {1.0, 0.0};
+    u32 prevCount = 0;
+
+    for (size_t i = 0; i < s.size(); i++) {
+        u8 cur[2];
+        u32 curCount = 0;
+        cur[curCount++] = (u8)s[i];
+        if (nocase && ourisalpha(s[i])) {
+            cur[0] = (u8)mytolower(s[i]);
+            cur[curCount++] = (u8)mytoupper(s[i]);
+        }
+
+        double curProb[2] = {0.0, 0.0};
+        for (u32 j = 0; j < curCount; j++) {
+            if (!prevCount) {
+                curProb[j] = bytes[cur[j]];
+                continue;
+            }
+            for (u32 k = 0; k < prevCount; k++) {
+                curProb[j] += prevProb[k] * nextProb(prev[k], cur[j]);
+            }
+        }
+
+        for (u32 j = 0; j < curCount; j++) {
+            prev[j] = cur[j];
+            prevProb[j] = curProb[j];
+        }
+        prevCount = curCount;
+    }
+
+    if (!prevCount) {
+        return 1.0;
+    }
+    double p = 0;
+    for (u32 j = 0; j < prevCount; j++) {
+        p += prevProb[j];
+    }
+    return p;
+}
+
+vector<double> TrafficModel::domainDist(u32 bits) const {
+    assert(bits <= 16);
+    const u32 mask = (1U << bits) - 1;
+    vector<double> dist(1U << bits, 0.0);
+    for (u32 a = 0; a < 256; a++) {
+        for (u32 b = 0; b < 256; b++) {
+            dist[(a | b << 8) & mask] += pairs[a * 256 + b];
+        }
+    }
+    return dist;
+}
+
+} // namespace ue2
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTIL_TRAFFIC_MODEL_H
+#define UTIL_TRAFFIC_MODEL_H
+
+/**
+ * \file
+ * \brief Byte-level model of the traffic a database is expected to scan.
+ */
+
+#include "ue2common.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace ue2 {
+
+/**
+ * \brief First-order (byte pair) model of scanned traffic, built from a
+ * histogram of adjacent byte pairs in a sample corpus.
+ *
+ * Used at compile time to estimate how often literal matcher components will
+ * fire on real traffic, so that the build can keep hot literals apart from
+ * each other and pick table parameters that minimise confirm work.
+ *
+ * The counts are smoothed, so no byte or pair has zero probability.
+ */
+class TrafficModel {
+public:
+    /**
+     * \brief Builds a model from a 256x256 row-major histogram, where
+     * counts[a * 256 + b] is the number of times byte a was followed by byte
+     * b. The histogram must not be all zeroes.
+     */
+    explicit TrafficModel(const unsigned long long *counts);
+
+    /** \brief Probability of byte \a c at a given offset. */
+    double byteProb(u8 c) const { return bytes[c]; }
+
+    /** \brief Probability of byte \a a followed by byte \a b. */
+    double pairProb(u8 a, u8 b) const { return pairs[a * 256 + b]; }
+
+    /** \brief Probability of byte \a b given that the previous byte is \a a. */
+    double nextProb(u8 a, u8 b) const { return pairs[a * 256 + b] / bytes[a]; }
+
+    /**
+     * \brief Probability that a byte has its low nibble in the set \a lo and
+     * its high nibble in the set \a hi, where bit i of each set represents
+     * nibble value i.
+     */
+    double nibbleProb(u16 lo, u16 hi) const;
+
+    /**
+     * \brief Probability that string \a s occurs at a given offset, with
+     * alphabetic characters matched either way round if \a nocase is set.
+     */
+    double stringProb(const std::string &s, bool nocase) const;
+
+    /**
+     * \brief Distribution of the FDR domain index over the traffic: the low
+     * \a bits bits of the little-endian u16 loaded at a given offset.
+     */
+    std::vector<double> domainDist(u32 bits) const;
+
+    /** \brief Checksum of the source histogram, identifying the model. */
+    u32 digest() const { return crc; }
+
+private:
+    std::vector<double> pairs; //!< 256x256 pair probabilities
+    std::array<double, 256> bytes; //!< leading byte marginals
+
+    /**
+     * \brief Joint nibble probabilities, indexed by low nibble, one byte of
+     * the high nibble set, and which byte it is, so that nibbleProb() needs
+     * at most 32 lookups.
+     */
+    std::vector<double> nibbles;
+
+    u32 crc;
+};
+
+} // namespace ue2
+
+#endif // UTIL_TRAFFIC_MODEL_H
@@ -42,6 +42,9 @@ extern bool forceEditDistance;
 extern unsigned editDistance;
 extern bool printCompressSize;
 extern bool useLiteralApi;
+extern bool displayScanStats;
+extern unsigned profileTop;
+extern unsigned compileThreads;
 
 /** Structure for the result of a single complete scan. */
 struct ResultEntry {
@@ -91,6 +91,11 @@ public:
     virtual void printCsvStats() const = 0;
 
     virtual void sqlStats(SqlDB &db) const = 0;
+
+    // runtime statistics and scan cost profile, summed over the given
+    // per-thread contexts
+    virtual void printScanStats(
+        const std::vector<const EngineContext *> &ctxs) const = 0;
 };
 
 #endif // ENGINE_H
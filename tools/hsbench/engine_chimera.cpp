@@ -201,6 +201,10 @@ void EngineChimera::sqlStats(SqlDB &sqldb) const {
                      compile_stats.peakMemorySize);
 }
 
+void EngineChimera::printScanStats(const vector<const EngineContext *> &) const {
+    // scan statistics are only collected by Hyperscan
+}
+
 unique_ptr<EngineChimera>
 buildEngineChimera(const ExpressionMap &expressions, const string &name,
                    const string &sigs_name) {
@@ -93,6 +93,8 @@ public:
 
     void sqlStats(SqlDB &db) const;
 
+    void printScanStats(const std::vector<const EngineContext *> &ctxs) const;
+
 private:
     ch_database_t *db;
     CompileCHStats compile_stats;
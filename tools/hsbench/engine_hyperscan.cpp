@@ -43,10 +43,13 @@
 #include "hs_runtime.h"
 #include "util/database_util.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iomanip>
+#include <map>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -59,10 +62,25 @@ using namespace std;
 EngineHSContext::EngineHSContext(const hs_database_t *db) {
     hs_alloc_scratch(db, &scratch);
     assert(scratch);
+
+    memset(&stats, 0, sizeof(stats));
+    if (displayScanStats && hs_set_scan_stats(scratch, &stats) != HS_SUCCESS) {
+        printf("Fatal error: scan statistics are not available; rebuild "
+               "with the SCAN_STATS option\n");
+        exit(1);
+    }
+
+    if (profileTop && (hs_alloc_scan_profile(db, &profile) != HS_SUCCESS ||
+                       hs_set_scan_profile(scratch, profile) != HS_SUCCESS)) {
+        printf("Fatal error: scan profiling is not available; rebuild "
+               "with the SCAN_PROFILE option\n");
+        exit(1);
+    }
 }
 
 EngineHSContext::~EngineHSContext() {
     hs_free_scratch(scratch);
+    hs_free_scan_profile(profile);
 }
 
 EngineHSStream::~EngineHSStream() { }
@@ -289,6 +307,101 @@ void EngineHyperscan::sqlStats(SqlDB &sqldb) const {
                      compile_stats.compileSecs, compile_stats.peakMemorySize);
 }
 
+static
+void printScanProfile(const vector<const EngineContext *> &ctxs,
+                      size_t expressionCount) {
+    // merge the costs from each thread by expression id
+    map<unsigned int, unsigned long long> merged;
+    unsigned long long unattributed = 0;
+    vector<hs_expression_cost_t> costs(expressionCount);
+    for (const auto *ectx : ctxs) {
+        const auto *profile =
+            static_cast<const EngineHSContext *>(ectx)->profile;
+        unsigned int count = 0;
+        unsigned long long lost = 0;
+        if (hs_scan_profile_costs(profile, costs.data(),
+                                  static_cast<unsigned int>(costs.size()),
+                                  &count, &lost) != HS_SUCCESS) {
+            printf("Fatal error: unable to read scan profile\n");
+            exit(1);
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            merged[costs[i].id] += costs[i].ticks;
+        }
+        unattributed += lost;
+    }
+
+    vector<pair<unsigned long long, unsigned int>> ranked;
+    unsigned long long total = unattributed;
+    for (const auto &m : merged) {
+        ranked.emplace_back(m.second, m.first);
+        total += m.second;
+    }
+    sort(ranked.begin(), ranked.end(),
+         [](const pair<unsigned long long, unsigned int> &a,
+            const pair<unsigned long long, unsigned int> &b) {
+             return a.first != b.first ? a.first > b.first
+                                       : a.second < b.second;
+         });
+
+    auto percent = [total](unsigned long long ticks) {
+        return total ? 100.0 * ticks / total : 0.0;
+    };
+
+    printf("Scan cost profile (all threads and repeats, %'llu ticks):\n",
+           total);
+    printf("  %10s %20s %8s\n", "Expression", "Ticks", "Share");
+    size_t shown = min(ranked.size(), size_t{profileTop});
+    for (size_t i = 0; i < shown; i++) {
+        printf("  %10u %'20llu %7.2f%%\n", ranked[i].second, ranked[i].first,
+               percent(ranked[i].first));
+    }
+    printf("  %10s %'20llu %7.2f%%\n", "other", unattributed,
+           percent(unattributed));
+    printf("\n");
+}
+
+void EngineHyperscan::printScanStats(
+    const vector<const EngineContext *> &ctxs) const {
+    if (profileTop) {
+        printScanProfile(ctxs, compile_stats.expressionCount);
+    }
+    if (!displayScanStats) {
+        return;
+    }
+
+    hs_scan_stats_t total;
+    memset(&total, 0, sizeof(total));
+    for (const auto *ectx : ctxs) {
+        const auto &s = static_cast<const EngineHSContext *>(ectx)->stats;
+        total.scans += s.scans;
+        total.bytes_scanned += s.bytes_scanned;
+        total.literal_accel_skipped += s.literal_accel_skipped;
+        total.engine_accel_skipped += s.engine_accel_skipped;
+        total.literal_confirms += s.literal_confirms;
+        total.literal_matches += s.literal_matches;
+        total.program_instructions += s.program_instructions;
+        total.catchup_engine_runs += s.catchup_engine_runs;
+        total.delayed_literals += s.delayed_literals;
+        total.reports += s.reports;
+    }
+
+    printf("Scan statistics (all threads and repeats):\n");
+    printf("  Blocks scanned:          %'llu\n", total.scans);
+    printf("  Bytes scanned:           %'llu\n", total.bytes_scanned);
+    printf("  Literal accel skipped:   %'llu bytes\n",
+           total.literal_accel_skipped);
+    printf("  Engine accel skipped:    %'llu bytes\n",
+           total.engine_accel_skipped);
+    printf("  Literal confirms:        %'llu\n", total.literal_confirms);
+    printf("  Literal matches:         %'llu\n", total.literal_matches);
+    printf("  Program instructions:    %'llu\n", total.program_instructions);
+    printf("  Catchup engine runs:     %'llu\n", total.catchup_engine_runs);
+    printf("  Delayed literals:        %'llu\n", total.delayed_literals);
+    printf("  Reports:                 %'llu\n", total.reports);
+    printf("\n");
+}
+
 
 static
 unsigned makeModeFlags(ScanMode scan_mode) {
@@ -338,7 +451,8 @@ string dbFilename(const std::string &name, unsigned mode) {
 std::unique_ptr<EngineHyperscan>
 buildEngineHyperscan(const ExpressionMap &expressions, ScanMode scan_mode,
                      const std::string &name, const std::string &sigs_name,
-                     UNUSED const ue2::Grey &grey) {
+                     UNUSED const ue2::Grey &grey,
+                     const hs_traffic_t *traffic) {
     if (expressions.empty()) {
         assert(0);
         return nullptr;
@@ -409,6 +523,16 @@ buildEngineHyperscan(const ExpressionMap &expressions, ScanMode scan_mode,
         hs_compile_error_t *compile_err;
         Timer timer;
 
+        hs_compile_options_t options;
+        memset(&options, 0, sizeof(options));
+        options.flags = HS_COMPILE_OPT_THREADS;
+        options.threads = compileThreads ? compileThreads
+                                         : HS_COMPILE_THREADS_ALL;
+        if (traffic) {
+            options.flags |= HS_COMPILE_OPT_TRAFFIC;
+            options.traffic = traffic;
+        }
+
 #ifndef RELEASE_BUILD
         if (useLiteralApi) {
             // Pattern length computation should be done before timer start.
@@ -420,14 +544,15 @@ buildEngineHyperscan(const ExpressionMap &expressions, ScanMode scan_mode,
             err = hs_compile_lit_multi_int(patterns.data(), flags.data(),
                                            ids.data(), ext_ptr.data(),
                                            lens.data(), count, full_mode,
-                                           nullptr, &db, &compile_err, grey);
+                                           nullptr, &db, &compile_err, grey,
+                                           &options);
             timer.complete();
         } else {
             timer.start();
             err = hs_compile_multi_int(patterns.data(), flags.data(),
                                        ids.data(), ext_ptr.data(), count,
                                        full_mode, nullptr, &db, &compile_err,
-                                       grey);
+                                       grey, &options);
             timer.complete();
         }
 #else
@@ -438,15 +563,17 @@ buildEngineHyperscan(const ExpressionMap &expressions, ScanMode scan_mode,
                 lens[i] = strlen(patterns[i]);
             }
             timer.start();
-            err = hs_compile_lit_multi(patterns.data(), flags.data(),
-                                       ids.data(), lens.data(), count,
-                                       full_mode, nullptr, &db, &compile_err);
+            err = hs_compile_lit_multi_opts(patterns.data(), flags.data(),
+                                            ids.data(), lens.data(), count,
+                                            full_mode, nullptr, &options, &db,
+                                            &compile_err);
             timer.complete();
         } else {
             timer.start();
-            err = hs_compile_ext_multi(patterns.data(), flags.data(),
-                                       ids.data(), ext_ptr.data(), count,
-                                       full_mode, nullptr, &db, &compile_err);
+            err = hs_compile_ext_multi_opts(patterns.data(), flags.data(),
+                                            ids.data(), ext_ptr.data(), count,
+                                            full_mode, nullptr, &options, &db,
+                                            &compile_err);
             timer.complete();
         }
 #endif
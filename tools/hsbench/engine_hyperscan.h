@@ -31,6 +31,7 @@
 
 #include "expressions.h"
 #include "engine.h"
+#include "hs_compile.h"
 #include "hs_runtime.h"
 
 #include <memory>
@@ -59,6 +60,8 @@ public:
     ~EngineHSContext();
 
     hs_scratch_t *scratch = nullptr;
+    hs_scan_stats_t stats; //!< filled in when displayScanStats is set
+    hs_scan_profile_t *profile = nullptr; //!< allocated when profileTop is set
 };
 
 /** Streaming mode scans have persistent stream state associated with them. */
@@ -102,6 +105,8 @@ public:
 
     void sqlStats(SqlDB &db) const;
 
+    void printScanStats(const std::vector<const EngineContext *> &ctxs) const;
+
 private:
     hs_database_t *db;
     CompileHSStats compile_stats;
@@ -114,6 +119,6 @@ struct Grey;
 std::unique_ptr<EngineHyperscan>
 buildEngineHyperscan(const ExpressionMap &expressions, ScanMode scan_mode,
                      const std::string &name, const std::string &sigs_name,
-                     const ue2::Grey &grey);
+                     const ue2::Grey &grey, const hs_traffic_t *traffic);
 
 #endif // ENGINEHYPERSCAN_H
@@ -240,6 +240,10 @@ void EnginePCRE::sqlStats(SqlDB &sqldb) const {
                      compile_stats.peakMemorySize);
 }
 
+void EnginePCRE::printScanStats(const vector<const EngineContext *> &) const {
+    // scan statistics are only collected by Hyperscan
+}
+
 static
 bool decodeExprPCRE(string &expr, unsigned *flags, struct PcreDB &db) {
     if (expr[0] != '/') {
@@ -101,6 +101,8 @@ public:
 
     void sqlStats(SqlDB &db) const;
 
+    void printScanStats(const std::vector<const EngineContext *> &ctxs) const;
+
 private:
     std::vector<std::unique_ptr<PcreDB>> dbs;
 
@@ -50,8 +50,10 @@
 #include <clocale>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <set>
@@ -81,6 +83,9 @@ bool forceEditDistance = false;
 unsigned editDistance = 0;
 bool printCompressSize = false;
 bool useLiteralApi = false;
+bool displayScanStats = false;
+unsigned profileTop = 0;
+unsigned compileThreads = 1;
 
 // Globals local to this file.
 static bool compressStream = false;
@@ -92,6 +97,7 @@ ScanMode scan_mode = ScanMode::STREAMING;
 bool useHybrid = false;
 bool usePcre = false;
 bool dumpCsvOut = false;
+bool tuneLiterals = false;
 unsigned repeats = 20;
 string exprPath("");
 string corpusFile("");
@@ -208,6 +214,18 @@ void usage(const char *error) {
     printf("  --echo-matches  Display all matches that occur during scan.\n");
     printf("  --sql-out FILE  Output sqlite db.\n");
     printf("  --literal-on    Use Hyperscan pure literal matching.\n");
+    printf("  --scan-stats    Display runtime statistics (requires a library"
+           " built\n"
+           "                  with SCAN_STATS).\n");
+    printf("  --profile N     Display the N expressions with the highest scan"
+           " cost\n"
+           "                  (requires a library built with SCAN_PROFILE).\n");
+    printf("  --tune-literals Tune literal matchers for the corpus when"
+           " compiling.\n");
+    printf("  --compile-threads N\n"
+           "                  Compile with N threads, or one per hardware"
+           " thread if N\n"
+           "                  is zero (default 1).\n");
     printf("  -S NAME         Signature set name (for sqlite db).\n");
     printf("\n\n");
 
@@ -241,6 +259,10 @@ void processArgs(int argc, char *argv[], vector<BenchmarkSigs> &sigSets,
     int do_sql_output = 0;
     int option_index = 0;
     int literalFlag = 0;
+    int do_scan_stats = 0;
+    int do_profile = 0;
+    int do_tune_literals = 0;
+    int do_compile_threads = 0;
     vector<string> sigFiles;
 
     static struct option longopts[] = {
@@ -249,6 +271,10 @@ void processArgs(int argc, char *argv[], vector<BenchmarkSigs> &sigSets,
         {"compress-stream", no_argument, &do_compress, 1},
         {"sql-out", required_argument, &do_sql_output, 1},
         {"literal-on", no_argument, &literalFlag, 1},
+        {"scan-stats", no_argument, &do_scan_stats, 1},
+        {"profile", required_argument, &do_profile, 1},
+        {"tune-literals", no_argument, &do_tune_literals, 1},
+        {"compile-threads", required_argument, &do_compile_threads, 1},
         {nullptr, 0, nullptr, 0}
     };
 
@@ -374,6 +400,22 @@ void processArgs(int argc, char *argv[], vector<BenchmarkSigs> &sigSets,
                 sqloutFile.assign(optarg);
                 do_sql_output = 0;
             }
+            if (do_profile) {
+                if (!fromString(optarg, profileTop) || profileTop == 0) {
+                    usage("Must provide a positive integer argument to "
+                          "'--profile' flag");
+                    exit(1);
+                }
+                do_profile = 0;
+            }
+            if (do_compile_threads) {
+                if (!fromString(optarg, compileThreads)) {
+                    usage("Must provide an integer argument to "
+                          "'--compile-threads' flag");
+                    exit(1);
+                }
+                do_compile_threads = 0;
+            }
             break;
         case 1:
             if (in_sigfile) {
@@ -404,6 +446,12 @@ void processArgs(int argc, char *argv[], vector<BenchmarkSigs> &sigSets,
     if (do_compress_size) {
         printCompressSize = true;
     }
+    if (do_scan_stats) {
+        displayScanStats = true;
+    }
+    if (do_tune_literals) {
+        tuneLiterals = true;
+    }
 
     if (exprPath.empty() && !sigFiles.empty()) {
         /* attempt to infer an expression directory */
@@ -447,7 +495,8 @@ void processArgs(int argc, char *argv[], vector<BenchmarkSigs> &sigSets,
             exit(1);
         }
 
-        if (forceEditDistance || loadDatabases || saveDatabases) {
+        if (forceEditDistance || loadDatabases || saveDatabases ||
+            displayScanStats || profileTop) {
             usage("No extended options are supported in Chimera or PCRE.");
             exit(1);
         }
@@ -482,6 +531,28 @@ void stopTotalTimer(ThreadContext *ctx) {
     totalSecs = totalTimer.seconds();
 }
 
+/** Build a traffic profile from the corpus, or return nullptr if we can't.
+ * The caller frees it with hs_free_traffic(). */
+static
+hs_traffic_t *makeCompileTraffic(const vector<DataBlock> &corpus_blocks) {
+    hs_traffic_t *traffic = nullptr;
+    if (hs_alloc_traffic(&traffic) != HS_SUCCESS) {
+        printf("Unable to tune literals: out of memory.\n");
+        return nullptr;
+    }
+    size_t pairs = 0;
+    for (const DataBlock &block : corpus_blocks) {
+        hs_traffic_add(traffic, block.payload.c_str(), block.payload.size());
+        pairs += block.payload.empty() ? 0 : block.payload.size() - 1;
+    }
+    if (!pairs) {
+        printf("Unable to tune literals: corpus has no byte pairs.\n");
+        hs_free_traffic(traffic);
+        return nullptr;
+    }
+    return traffic;
+}
+
 /** Run a benchmark over a given engine and corpus in block mode. */
 static
 void benchBlock(void *context) {
@@ -976,6 +1047,13 @@ void runBenchmark(const Engine &db,
     } else if (sqloutFile.empty()) {
         // Display global results.
         displayResults(threads, corpus_blocks);
+        if (displayScanStats || profileTop) {
+            vector<const EngineContext *> ctxs;
+            for (const auto &t : threads) {
+                ctxs.push_back(t->enginectx.get());
+            }
+            db.printScanStats(ctxs);
+        }
     } else {
         // write to sqlite file
         sqlResults(threads, corpus_blocks);
@@ -1022,6 +1100,9 @@ int HS_CDECL main(int argc, char *argv[]) {
         printf("Corpus data error: %s\n", e.msg.c_str());
         return 1;
     }
+    unique_ptr<hs_traffic_t, decltype(&hs_free_traffic)> traffic(
+        tuneLiterals ? makeCompileTraffic(corpus_blocks) : nullptr,
+        &hs_free_traffic);
     try {
         if (!sqloutFile.empty()) {
             out_db.open(sqloutFile);
@@ -1042,7 +1123,7 @@ int HS_CDECL main(int argc, char *argv[]) {
 #endif
             } else {
                 engine = buildEngineHyperscan(exprMap, scan_mode, s.name,
-                                              sigName, *grey);
+                                              sigName, *grey, traffic.get());
             }
 
             if (!engine) {
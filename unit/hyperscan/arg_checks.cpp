@@ -475,6 +475,92 @@ TEST(HyperscanArgChecks, ScanStreamNoScratch) {
     hs_free_database(db);
 }
 
+// hs_scan_stream_batch: Call with no stream ID array
+TEST(HyperscanArgChecks, ScanStreamBatchNoStreamIDs) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_STREAM, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    const char *data[] = {"data", "data"};
+    unsigned int len[] = {4, 4};
+    err = hs_scan_stream_batch(nullptr, data, len, 2, 0, scratch, nullptr,
+                               nullptr);
+    EXPECT_NE(HS_SUCCESS, err);
+    EXPECT_NE(HS_SCAN_TERMINATED, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_stream_batch: Call with a null stream ID in the array
+TEST(HyperscanArgChecks, ScanStreamBatchNullStreamID) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_STREAM, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+    hs_stream_t *stream = nullptr;
+    err = hs_open_stream(db, 0, &stream);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(stream != nullptr);
+
+    hs_stream_t *ids[] = {stream, nullptr};
+    const char *data[] = {"data", "data"};
+    unsigned int len[] = {4, 4};
+    err = hs_scan_stream_batch(ids, data, len, 2, 0, scratch, nullptr,
+                               nullptr);
+    EXPECT_NE(HS_SUCCESS, err);
+    EXPECT_NE(HS_SCAN_TERMINATED, err);
+
+    // teardown
+    err = hs_close_stream(stream, scratch, dummy_cb, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_stream_batch: Call with no scratch
+TEST(HyperscanArgChecks, ScanStreamBatchNoScratch) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_STREAM, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_stream_t *stream = nullptr;
+    err = hs_open_stream(db, 0, &stream);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(stream != nullptr);
+
+    hs_stream_t *ids[] = {stream};
+    const char *data[] = {"data"};
+    unsigned int len[] = {4};
+    err = hs_scan_stream_batch(ids, data, len, 1, 0, nullptr, nullptr,
+                               nullptr);
+    EXPECT_NE(HS_SUCCESS, err);
+    EXPECT_NE(HS_SCAN_TERMINATED, err);
+
+    // teardown
+    err = hs_close_stream(stream, nullptr, nullptr, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
 // hs_close_stream: Call with no stream
 TEST(HyperscanArgChecks, CloseStreamNoStream) {
     hs_database_t *db = nullptr;
@@ -1337,6 +1423,257 @@ TEST(HyperscanArgChecks, ScanVectorNoHandler) {
     hs_free_database(db);
 }
 
+// hs_scan_matches: Call with no count
+TEST(HyperscanArgChecks, ScanMatchesNoCount) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    hs_match_t matches[4];
+    err = hs_scan_matches(db, "data", 4, 0, scratch, matches, 4, nullptr,
+                          nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_matches: Call with a capacity but no match array
+TEST(HyperscanArgChecks, ScanMatchesNoArray) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    unsigned int count = 0;
+    err = hs_scan_matches(db, "data", 4, 0, scratch, nullptr, 4, &count,
+                          nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_count: Call with no count array
+TEST(HyperscanArgChecks, ScanCountNoCounts) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK | HS_MODE_COUNT,
+                                nullptr, &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    err = hs_scan_count(db, "data", 4, 0, scratch, nullptr, 1);
+    ASSERT_EQ(HS_INVALID, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_count: Call with a count array smaller than the expression count
+TEST(HyperscanArgChecks, ScanCountSmallCounts) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    const char *expr[] = {"foo", "bar"};
+    const unsigned ids[] = {1, 5};
+    hs_error_t err = hs_compile_multi(expr, nullptr, ids, 2,
+                                      HS_MODE_BLOCK | HS_MODE_COUNT, nullptr,
+                                      &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    unsigned long long counts[2];
+    err = hs_scan_count(db, "data", 4, 0, scratch, counts, 1);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+
+    // counts are indexed by expression, so the ids do not matter
+    err = hs_scan_count(db, "data", 4, 0, scratch, counts, 2);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_count: Call with a database not compiled for counting
+TEST(HyperscanArgChecks, ScanCountNotCountDatabase) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    unsigned long long counts[1];
+    err = hs_scan_count(db, "data", 4, 0, scratch, counts, 1);
+    ASSERT_EQ(HS_DB_MODE_ERROR, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan: Call with a count-only database
+TEST(HyperscanArgChecks, ScanCountDatabase) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK | HS_MODE_COUNT,
+                                nullptr, &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    err = hs_scan(db, "data", 4, 0, scratch, dummy_cb, nullptr);
+    ASSERT_EQ(HS_DB_MODE_ERROR, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_compile: Logical combinations can't be compiled in count mode
+TEST(HyperscanArgChecks, CompileCountCombination) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    const char *expr[] = {"foo", "bar", "101 & 102"};
+    const unsigned flags[] = {HS_FLAG_QUIET, HS_FLAG_QUIET,
+                              HS_FLAG_COMBINATION};
+    const unsigned ids[] = {101, 102, 1};
+    hs_error_t err = hs_compile_multi(expr, flags, ids, 3,
+                                      HS_MODE_BLOCK | HS_MODE_COUNT, nullptr,
+                                      &db, &compile_err);
+    ASSERT_EQ(HS_COMPILER_ERROR, err);
+    ASSERT_TRUE(compile_err != nullptr);
+    EXPECT_EQ(2, compile_err->expression);
+    hs_free_compile_error(compile_err);
+}
+
+// hs_compile: min_length needs SOM, so it can't be compiled in count mode
+TEST(HyperscanArgChecks, CompileCountMinLength) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    const char *expr[] = {"foo.*bar"};
+    const unsigned ids[] = {1};
+    hs_expr_ext ext;
+    memset(&ext, 0, sizeof(ext));
+    ext.flags = HS_EXT_FLAG_MIN_LENGTH;
+    ext.min_length = 10;
+    const hs_expr_ext *exts[] = {&ext};
+    hs_error_t err = hs_compile_ext_multi(expr, nullptr, ids, exts, 1,
+                                          HS_MODE_BLOCK | HS_MODE_COUNT,
+                                          nullptr, &db, &compile_err);
+    ASSERT_EQ(HS_COMPILER_ERROR, err);
+    ASSERT_TRUE(compile_err != nullptr);
+    EXPECT_EQ(0, compile_err->expression);
+    hs_free_compile_error(compile_err);
+}
+
+// hs_scan_count: A count-only database always needs at least one counter
+TEST(HyperscanArgChecks, ScanCountZeroCapacity) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", HS_FLAG_QUIET,
+                                HS_MODE_BLOCK | HS_MODE_COUNT, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    unsigned long long counts[1] = {12345};
+    err = hs_scan_count(db, "foobar", 6, 0, scratch, counts, 0);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+
+    // a quiet expression is never counted
+    err = hs_scan_count(db, "foobar", 6, 0, scratch, counts, 1);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(0ULL, counts[0]);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// hs_scan_parallel: Call with no scratch array
+TEST(HyperscanArgChecks, ScanParallelNoScratch) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_BLOCK, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+
+    err = hs_scan_parallel(db, "data", 4, 0, nullptr, 2, nullptr, nullptr,
+                           dummy_cb, nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+
+    // teardown
+    hs_free_database(db);
+}
+
+// hs_scan_parallel: Call with a streaming database
+TEST(HyperscanArgChecks, ScanParallelStreamingDatabase) {
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile("foobar", 0, HS_MODE_STREAM, nullptr, &db,
+                                &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(scratch != nullptr);
+
+    err = hs_scan_parallel(db, "data", 4, 0, &scratch, 1, nullptr, nullptr,
+                           dummy_cb, nullptr);
+    ASSERT_EQ(HS_DB_MODE_ERROR, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
 // hs_alloc_scratch: Call with no database
 TEST(HyperscanArgChecks, AllocScratchNoDatabase) {
     hs_scratch_t *scratch = nullptr;
@@ -2031,6 +2368,245 @@ TEST(HyperscanArgChecks, ScratchSizeBadScratch) {
     ASSERT_EQ(HS_INVALID, err);
 }
 
+TEST(HyperscanArgChecks, ScanStatsNoScratch) {
+    hs_scan_stats_t stats;
+    hs_error_t err = hs_set_scan_stats(nullptr, &stats);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, ScanStatsBadScratch) {
+    hs_scratch_t *scratch = (hs_scratch_t *)garbage;
+    hs_scan_stats_t stats;
+    hs_error_t err = hs_set_scan_stats(scratch, &stats);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, ScanProfileNoScratch) {
+    hs_error_t err = hs_set_scan_profile(nullptr, nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, ScanProfileAllocNoDatabase) {
+    hs_scan_profile_t *profile = nullptr;
+    hs_error_t err = hs_alloc_scan_profile(nullptr, &profile);
+    ASSERT_EQ(HS_INVALID, err);
+    ASSERT_EQ(nullptr, profile);
+}
+
+TEST(HyperscanArgChecks, ScanProfileCostsNoProfile) {
+    unsigned int count = 0;
+    hs_error_t err = hs_scan_profile_costs(nullptr, nullptr, 0, &count,
+                                           nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, AllocTrafficNoPointer) {
+    hs_error_t err = hs_alloc_traffic(nullptr);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, TrafficAddNoTraffic) {
+    hs_error_t err = hs_traffic_add(nullptr, "foo", 3);
+    ASSERT_EQ(HS_INVALID, err);
+}
+
+TEST(HyperscanArgChecks, TrafficAddNoData) {
+    hs_traffic_t *traffic = nullptr;
+    hs_error_t err = hs_alloc_traffic(&traffic);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(traffic != nullptr);
+    err = hs_traffic_add(traffic, nullptr, 3);
+    ASSERT_EQ(HS_INVALID, err);
+    err = hs_traffic_add(traffic, nullptr, 0);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_traffic(traffic);
+}
+
+TEST(HyperscanArgChecks, FreeTrafficNull) {
+    hs_error_t err = hs_free_traffic(nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+}
+
+// hs_compile_ext_multi_opts: unrecognised option flags
+TEST(HyperscanArgChecks, CompileOptsBogusFlags) {
+    const char *expr[] = {"foobar"};
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_THREADS | (1ULL << 40);
+    options.threads = 2;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr,
+                                               1, HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+    EXPECT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    EXPECT_EQ(-1, compile_err->expression);
+    ASSERT_STREQ("Invalid parameter: unrecognised compile option flags.",
+                 compile_err->message);
+    hs_free_compile_error(compile_err);
+}
+
+// hs_compile_lit_multi_opts: unrecognised option flags
+TEST(HyperscanArgChecks, CompileLitOptsBogusFlags) {
+    const char *expr[] = {"foobar"};
+    const size_t lens[] = {6};
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = 1ULL << 63;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_lit_multi_opts(expr, nullptr, nullptr, lens, 1,
+                                               HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+    EXPECT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    ASSERT_STREQ("Invalid parameter: unrecognised compile option flags.",
+                 compile_err->message);
+    hs_free_compile_error(compile_err);
+}
+
+// hs_compile_ext_multi_opts: a profile without byte pairs is rejected
+TEST(HyperscanArgChecks, CompileTrafficEmpty) {
+    hs_traffic_t *traffic = nullptr;
+    hs_error_t err = hs_alloc_traffic(&traffic);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(traffic != nullptr);
+
+    // a single byte has no pairs
+    err = hs_traffic_add(traffic, "x", 1);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_TRAFFIC;
+    options.traffic = traffic;
+
+    const char *expr[] = {"foobar"};
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    EXPECT_EQ(-1, compile_err->expression);
+    hs_free_compile_error(compile_err);
+
+    // with some pairs it compiles
+    err = hs_traffic_add(traffic, "foo bar", 7);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_free_database(db);
+
+    // the traffic field is not read unless its flag is set
+    options.flags = 0;
+    options.traffic = (const hs_traffic_t *)garbage;
+    err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_free_database(db);
+    hs_free_traffic(traffic);
+}
+
+// hs_compile_lit_multi_opts: takes a traffic profile too
+TEST(HyperscanArgChecks, CompileLitTrafficEmpty) {
+    hs_traffic_t *traffic = nullptr;
+    hs_error_t err = hs_alloc_traffic(&traffic);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(traffic != nullptr);
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_TRAFFIC;
+    options.traffic = traffic;
+
+    const char *expr[] = {"foobar"};
+    const size_t lens[] = {6};
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    err = hs_compile_lit_multi_opts(expr, nullptr, nullptr, lens, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    hs_free_compile_error(compile_err);
+
+    err = hs_traffic_add(traffic, "foo bar", 7);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_compile_lit_multi_opts(expr, nullptr, nullptr, lens, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_free_database(db);
+    hs_free_traffic(traffic);
+}
+
+// hs_compile_ext_multi_opts: a cache directory flag with no directory
+TEST(HyperscanArgChecks, CompileCacheDirNull) {
+    const char *expr[] = {"foobar"};
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_CACHE_DIR;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr,
+                                               1, HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+    EXPECT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    EXPECT_EQ(-1, compile_err->expression);
+    ASSERT_STREQ("Invalid parameter: cache directory is NULL.",
+                 compile_err->message);
+    hs_free_compile_error(compile_err);
+
+    // the cache_dir field is not read unless its flag is set
+    options.flags = 0;
+    options.cache_dir = (const char *)garbage;
+    err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr, 1,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(db != nullptr);
+    hs_free_database(db);
+}
+
+// hs_compile_lit_multi_opts: a cache directory flag with no directory
+TEST(HyperscanArgChecks, CompileLitCacheDirNull) {
+    const char *expr[] = {"foobar"};
+    const size_t lens[] = {6};
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_CACHE_DIR;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_lit_multi_opts(expr, nullptr, nullptr, lens, 1,
+                                               HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+    EXPECT_EQ(HS_COMPILER_ERROR, err);
+    EXPECT_EQ(nullptr, db);
+    ASSERT_TRUE(compile_err != nullptr);
+    ASSERT_STREQ("Invalid parameter: cache directory is NULL.",
+                 compile_err->message);
+    hs_free_compile_error(compile_err);
+}
+
 // hs_clone_scratch: bad scratch arg
 TEST(HyperscanArgChecks, CloneBadScratch) {
     // Try cloning the scratch
@@ -2644,6 +3220,13 @@ static const unsigned badModeValues[] = {
     HS_MODE_STREAM | HS_MODE_SOM_HORIZON_LARGE | HS_MODE_SOM_HORIZON_SMALL,
     HS_MODE_STREAM | HS_MODE_SOM_HORIZON_LARGE | HS_MODE_SOM_HORIZON_MEDIUM,
     HS_MODE_STREAM | HS_MODE_SOM_HORIZON_MEDIUM | HS_MODE_SOM_HORIZON_SMALL,
+    // Existence and count modes are only accepted in block mode.
+    HS_MODE_STREAM | HS_MODE_EXISTENCE,
+    HS_MODE_STREAM | HS_MODE_COUNT,
+    HS_MODE_VECTORED | HS_MODE_EXISTENCE,
+    HS_MODE_VECTORED | HS_MODE_COUNT,
+    // Can't specify both existence and count modes.
+    HS_MODE_BLOCK | HS_MODE_EXISTENCE | HS_MODE_COUNT,
 };
 
 INSTANTIATE_TEST_CASE_P(HyperscanArgChecks, BadModeTest,
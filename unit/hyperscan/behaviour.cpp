@@ -74,6 +74,14 @@ int countHandler(unsigned, unsigned long long, unsigned long long,
     return 0;
 }
 
+// Counter callback that also records the end of the last match
+int countLastHandler(unsigned, unsigned long long, unsigned long long to,
+                     unsigned, void *) {
+    matchCount++;
+    lastMatchTo = to;
+    return 0;
+}
+
 // Stop handler: take one match and tell Hyperscan to not deliver any more.
 int stopHandler(unsigned, unsigned long long, unsigned long long,
                 unsigned, void *) {
@@ -392,6 +400,79 @@ TEST(HyperscanTestBehaviour, BlockThereCanBeOnlyOne) {
     hs_free_database(db);
 }
 
+// The second literal of these patterns is in a literal group that is only
+// switched on once the first has matched, so it must still be found however
+// far the first literal is behind it.
+class HyperscanGroupOnTest : public TestWithParam<const char *> {};
+
+static const size_t group_on_gaps[] = {1, 2, 28, 29, 64, 100, 4096};
+
+TEST_P(HyperscanGroupOnTest, Block) {
+    hs_database_t *db = buildDB(GetParam(), 0, 1, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    for (size_t gap : group_on_gaps) {
+        SCOPED_TRACE(gap);
+        for (size_t tail : {0U, 100U}) {
+            const string data = "foo" + string(gap, 'x') + "bar" +
+                                string(tail, 'y');
+            matchCount = 0;
+            lastMatchTo = 0;
+            err = hs_scan(db, data.c_str(), data.size(), 0, scratch,
+                          countLastHandler, nullptr);
+            ASSERT_EQ(HS_SUCCESS, err);
+            EXPECT_EQ(1U, matchCount);
+            EXPECT_EQ(gap + 6, lastMatchTo);
+        }
+    }
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST_P(HyperscanGroupOnTest, Streaming) {
+    hs_database_t *db = buildDB(GetParam(), 0, 1, HS_MODE_STREAM);
+    ASSERT_TRUE(db != nullptr);
+
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    for (size_t gap : group_on_gaps) {
+        SCOPED_TRACE(gap);
+        const string data = "foo" + string(gap, 'x') + "bar" +
+                            string(100, 'y');
+        hs_stream_t *stream = nullptr;
+        err = hs_open_stream(db, 0, &stream);
+        ASSERT_EQ(HS_SUCCESS, err);
+
+        // split the data just after "foo", so the group is switched on in
+        // one write and the second literal found in the next
+        matchCount = 0;
+        err = hs_scan_stream(stream, data.c_str(), 4, 0, scratch,
+                             countHandler, nullptr);
+        ASSERT_EQ(HS_SUCCESS, err);
+        err = hs_scan_stream(stream, data.c_str() + 4, data.size() - 4, 0,
+                             scratch, countHandler, nullptr);
+        ASSERT_EQ(HS_SUCCESS, err);
+        err = hs_close_stream(stream, scratch, countHandler, nullptr);
+        ASSERT_EQ(HS_SUCCESS, err);
+        EXPECT_EQ(1U, matchCount);
+    }
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+INSTANTIATE_TEST_CASE_P(HyperscanGroupOn, HyperscanGroupOnTest,
+                        Values("foo.*bar", "foo[a-z]*bar", "fo+.*bar"));
+
 class HyperscanLiteralLengthTest : public TestWithParam<size_t> {
 protected:
     virtual void SetUp() {
@@ -1176,6 +1257,384 @@ TEST(HyperscanTestBehaviour, Vectored7) {
     hs_free_database(db);
 }
 
+TEST(HyperscanTestBehaviour, ScanMatches1) {
+    hs_error_t err;
+
+    // build a database
+    vector<pattern> patterns = {pattern("foo", 0, 1), pattern("bar", 0, 2)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_TRUE(scratch != nullptr);
+
+    const string data("foo bar foo");
+    hs_match_t matches[8];
+    unsigned int count = 0;
+    err = hs_scan_matches(db, data.c_str(), data.size(), 0, scratch, matches,
+                          8, &count, nullptr);
+
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(3U, count);
+    EXPECT_EQ(1U, matches[0].id);
+    EXPECT_EQ(3U, matches[0].to);
+    EXPECT_EQ(2U, matches[1].id);
+    EXPECT_EQ(7U, matches[1].to);
+    EXPECT_EQ(1U, matches[2].id);
+    EXPECT_EQ(11U, matches[2].to);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, ScanMatchesTotal) {
+    hs_error_t err;
+
+    // build a database
+    hs_database_t *db = buildDB("a", 0, 0, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_TRUE(scratch != nullptr);
+
+    // ten matches, but only room for three: we get the first three and the
+    // total
+    const string data(10, 'a');
+    vector<hs_match_t> matches(3);
+    unsigned int count = 0;
+    unsigned long long total = 0;
+    err = hs_scan_matches(db, data.c_str(), data.size(), 0, scratch,
+                          matches.data(), matches.size(), &count, &total);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+    ASSERT_EQ(3U, count);
+    EXPECT_EQ(10ULL, total);
+    for (unsigned int i = 0; i < count; i++) {
+        EXPECT_EQ(i + 1, matches[i].to);
+    }
+
+    // one more scan with an array of that size gets them all
+    matches.resize(total);
+    err = hs_scan_matches(db, data.c_str(), data.size(), 0, scratch,
+                          matches.data(), matches.size(), &count, &total);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(10U, count);
+    EXPECT_EQ(10ULL, total);
+    for (unsigned int i = 0; i < count; i++) {
+        EXPECT_EQ(i + 1, matches[i].to);
+    }
+
+    // with no room at all, we only learn whether there is a match, and how
+    // many if we ask
+    err = hs_scan_matches(db, data.c_str(), data.size(), 0, scratch, nullptr,
+                          0, &count, nullptr);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+    EXPECT_EQ(0U, count);
+
+    err = hs_scan_matches(db, data.c_str(), data.size(), 0, scratch, nullptr,
+                          0, &count, &total);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+    EXPECT_EQ(0U, count);
+    EXPECT_EQ(10ULL, total);
+
+    err = hs_scan_matches(db, "bbb", 3, 0, scratch, nullptr, 0, &count,
+                          &total);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(0U, count);
+    EXPECT_EQ(0ULL, total);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, Existence1) {
+    hs_error_t err;
+
+    // build a database
+    vector<pattern> patterns = {pattern("foo", 0, 1), pattern("b.r", 0, 2)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK | HS_MODE_EXISTENCE);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_TRUE(scratch != nullptr);
+
+    // the callback is never called
+    CallBackContext c;
+    const string data("xxxx bar foo");
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch, record_cb,
+                  (void *)&c);
+    ASSERT_EQ(HS_SCAN_TERMINATED, err);
+    EXPECT_EQ(0U, c.matches.size());
+
+    err = hs_scan(db, "xxxx", 4, 0, scratch, nullptr, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, Count1) {
+    hs_error_t err;
+
+    // build a database
+    vector<pattern> patterns = {pattern("foo", 0, 1),
+                                pattern("a+", 0, 3),
+                                pattern("b.r", HS_FLAG_SINGLEMATCH, 4)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK | HS_MODE_COUNT);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_TRUE(scratch != nullptr);
+
+    // counts are indexed by expression, and spare entries are zeroed
+    const string data("foo bar aaa foo bzr");
+    unsigned long long counts[4];
+    memset(counts, 0xff, sizeof(counts));
+    err = hs_scan_count(db, data.c_str(), data.size(), 0, scratch, counts, 4);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(2ULL, counts[0]);
+    EXPECT_EQ(4ULL, counts[1]);
+    EXPECT_EQ(1ULL, counts[2]);
+    EXPECT_EQ(0ULL, counts[3]);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, CountLargeIds) {
+    hs_error_t err;
+
+    // the largest valid id and a sparse one need no more counters than there
+    // are expressions; a repeated id is counted against its first expression
+    vector<pattern> patterns = {pattern("foo", 0, UINT_MAX),
+                                pattern("bar", 0, 0x7fffffffU),
+                                pattern("baz", 0, 0),
+                                pattern("qux", 0, UINT_MAX)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK | HS_MODE_COUNT);
+    ASSERT_TRUE(db != nullptr);
+
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_TRUE(scratch != nullptr);
+
+    const string data("foo bar baz qux foo bar");
+    unsigned long long counts[4];
+    err = hs_scan_count(db, data.c_str(), data.size(), 0, scratch, counts, 2);
+    ASSERT_EQ(HS_INSUFFICIENT_SPACE, err);
+
+    memset(counts, 0xff, sizeof(counts));
+    err = hs_scan_count(db, data.c_str(), data.size(), 0, scratch, counts, 4);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(3ULL, counts[0]);
+    EXPECT_EQ(2ULL, counts[1]);
+    EXPECT_EQ(1ULL, counts[2]);
+    EXPECT_EQ(0ULL, counts[3]);
+
+    // teardown
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// Executor that runs its tasks back to front, to check that the order in
+// which chunks are scanned doesn't matter.
+static
+void HS_CDECL reverseExecutor(hs_task_t task, void *task_context,
+                              unsigned int count, void *context) {
+    unsigned int *calls = (unsigned int *)context;
+    for (unsigned int i = count; i > 0; i--) {
+        task(task_context, i - 1);
+        (*calls)++;
+    }
+}
+
+TEST(HyperscanTestBehaviour, Parallel1) {
+    hs_error_t err;
+
+    // build a database of bounded-width patterns, including some assertions
+    // that must not be satisfied at chunk boundaries
+    vector<pattern> patterns = {pattern("foo[0-9]{2}", 0, 1),
+                                pattern("\\bbar\\b", 0, 2),
+                                pattern("^xyz", 0, 3),
+                                pattern("end$", 0, 4)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    const unsigned int num_scratch = 4;
+    hs_scratch_t *scratch[num_scratch] = {nullptr};
+    err = hs_alloc_scratch(db, &scratch[0]);
+    ASSERT_EQ(HS_SUCCESS, err);
+    for (unsigned int i = 1; i < num_scratch; i++) {
+        err = hs_clone_scratch(scratch[0], &scratch[i]);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+
+    string data("xyz");
+    while (data.size() < 128 * 1024) {
+        data += "foo42 xyz bar end barn foo7x end\n";
+    }
+    data += "end";
+
+    CallBackContext c_seq;
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch[0], record_cb,
+                  (void *)&c_seq);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_FALSE(c_seq.matches.empty());
+
+    CallBackContext c_par;
+    unsigned int calls = 0;
+    err = hs_scan_parallel(db, data.c_str(), data.size(), 0, scratch,
+                           num_scratch, reverseExecutor, &calls, record_cb,
+                           (void *)&c_par);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(num_scratch, calls);
+    EXPECT_EQ(c_seq.matches, c_par.matches);
+
+    // without an executor, chunks are scanned on this thread
+    c_par.clear();
+    err = hs_scan_parallel(db, data.c_str(), data.size(), 0, scratch,
+                           num_scratch, nullptr, nullptr, record_cb,
+                           (void *)&c_par);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(c_seq.matches, c_par.matches);
+
+    // termination from the callback
+    c_par.clear();
+    c_par.halt = true;
+    err = hs_scan_parallel(db, data.c_str(), data.size(), 0, scratch,
+                           num_scratch, nullptr, nullptr, record_cb,
+                           (void *)&c_par);
+    ASSERT_EQ(HS_SCAN_TERMINATED, err);
+    EXPECT_EQ(1U, c_par.matches.size());
+
+    // teardown
+    for (auto *s : scratch) {
+        err = hs_free_scratch(s);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, Parallel2) {
+    hs_error_t err;
+
+    // patterns of assorted bounded widths, so that matches near a chunk
+    // boundary come from several different engines
+    vector<pattern> patterns = {pattern("ab", 0, 1),
+                                pattern("a[bc]{3,40}d", 0, 2),
+                                pattern("c.{10,60}a", HS_FLAG_DOTALL, 3),
+                                pattern("(ab|ba){2,8}c", 0, 4),
+                                pattern("d[^a]{5}b", HS_FLAG_SOM_LEFTMOST, 5),
+                                pattern("bcdabcda", 0, 6),
+                                pattern("\\bd", 0, 7)};
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    const unsigned int num_scratch = 8;
+    hs_scratch_t *scratch[num_scratch] = {nullptr};
+    err = hs_alloc_scratch(db, &scratch[0]);
+    ASSERT_EQ(HS_SUCCESS, err);
+    for (unsigned int i = 1; i < num_scratch; i++) {
+        err = hs_clone_scratch(scratch[0], &scratch[i]);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+
+    // pseudo-random data over a small alphabet, so there are many matches
+    string data;
+    unsigned int seed = 1;
+    while (data.size() < 256 * 1024) {
+        seed = seed * 1103515245 + 12345;
+        data += "abcd \n"[(seed >> 16) % 6];
+    }
+
+    auto by_end = [](const MatchRecord &a, const MatchRecord &b) {
+        return a.to != b.to ? a.to < b.to : a.id < b.id;
+    };
+
+    CallBackContext c_seq;
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch[0], record_cb,
+                  (void *)&c_seq);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_FALSE(c_seq.matches.empty());
+    sort(c_seq.matches.begin(), c_seq.matches.end(), by_end);
+
+    for (unsigned int n = 2; n <= num_scratch; n++) {
+        CallBackContext c_par;
+        unsigned int calls = 0;
+        err = hs_scan_parallel(db, data.c_str(), data.size(), 0, scratch, n,
+                               reverseExecutor, &calls, record_cb,
+                               (void *)&c_par);
+        ASSERT_EQ(HS_SUCCESS, err);
+        EXPECT_EQ(n, calls);
+        sort(c_par.matches.begin(), c_par.matches.end(), by_end);
+        ASSERT_EQ(c_seq.matches, c_par.matches) << "with " << n << " chunks";
+    }
+
+    // teardown
+    for (auto *s : scratch) {
+        err = hs_free_scratch(s);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+    hs_free_database(db);
+}
+
+TEST(HyperscanTestBehaviour, ParallelUnbounded) {
+    hs_error_t err;
+
+    // unbounded width: the block can't be split
+    hs_database_t *db = buildDB("foo.*bar", 0, 1, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr);
+
+    // alloc some scratch
+    const unsigned int num_scratch = 2;
+    hs_scratch_t *scratch[num_scratch] = {nullptr};
+    err = hs_alloc_scratch(db, &scratch[0]);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_clone_scratch(scratch[0], &scratch[1]);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    string data = "foo" + string(64 * 1024, 'x') + "bar";
+
+    CallBackContext c;
+    unsigned int calls = 0;
+    err = hs_scan_parallel(db, data.c_str(), data.size(), 0, scratch,
+                           num_scratch, reverseExecutor, &calls, record_cb,
+                           (void *)&c);
+    ASSERT_EQ(HS_SUCCESS, err);
+    EXPECT_EQ(0U, calls);
+    ASSERT_EQ(1U, c.matches.size());
+    EXPECT_EQ(MatchRecord(data.size(), 1), c.matches[0]);
+
+    // teardown
+    for (auto *s : scratch) {
+        err = hs_free_scratch(s);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+    hs_free_database(db);
+}
+
 TEST(HyperscanTestBehaviour, MultiStream1) {
     hs_error_t err;
 
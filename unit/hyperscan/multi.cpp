@@ -28,7 +28,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -367,3 +370,136 @@ TEST(MMRoseLiteralPath, issue_141) {
     err = hs_free_scratch(scratch);
     ASSERT_EQ(HS_SUCCESS, err);
 }
+
+static
+string toBytes(hs_database_t *db) {
+    char *bytes = nullptr;
+    size_t len = 0;
+    hs_error_t err = hs_serialize_database(db, &bytes, &len);
+    EXPECT_EQ(HS_SUCCESS, err);
+    string s(bytes, len);
+    free(bytes);
+    hs_free_database(db);
+    return s;
+}
+
+static
+string compileToBytes(const vector<const char *> &expr,
+                      const vector<unsigned> &flags, unsigned mode,
+                      unsigned threads) {
+    vector<unsigned> ids(expr.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        ids[i] = i + 1;
+    }
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_THREADS;
+    options.threads = threads;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr.data(), flags.data(),
+                                               ids.data(), nullptr,
+                                               expr.size(), mode, nullptr,
+                                               &options, &db, &compile_err);
+    EXPECT_EQ(HS_SUCCESS, err);
+    if (err != HS_SUCCESS) {
+        hs_free_compile_error(compile_err);
+        return string();
+    }
+    return toBytes(db);
+}
+
+TEST(MultiThreadedCompile, SameDatabase) {
+    // A mix of literals, outfixes and rose suffixes.
+    const vector<const char *> expr = {
+        "foobar", "abc[0-9]+def", "x.*y.*z", "^hello world",
+        "[a-f]{4,12}q", "teakettle.{3,20}badger", "(ab|cd)*ef$",
+        "onlyliteral", "a[^b]{10}c", "zz[0-9]{3}yy.*ww",
+    };
+    const vector<unsigned> flags(expr.size(), HS_FLAG_DOTALL);
+
+    for (unsigned mode : {HS_MODE_BLOCK, HS_MODE_STREAM}) {
+        string serial = compileToBytes(expr, flags, mode, 1);
+        ASSERT_FALSE(serial.empty());
+
+        string parallel = compileToBytes(expr, flags, mode, 4);
+        ASSERT_EQ(serial, parallel);
+    }
+}
+
+TEST(MultiThreadedCompile, Literal) {
+    const char *expr[] = {"foo", "a.c", "bar?", "teakettle", "x\0y"};
+    const size_t lens[] = {3, 3, 4, 9, 3};
+    const unsigned ids[] = {1, 2, 3, 4, 5};
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_lit_multi(expr, nullptr, ids, lens, 5,
+                                          HS_MODE_BLOCK, nullptr, &db,
+                                          &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    string serial = toBytes(db);
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_THREADS;
+    options.threads = 4;
+    err = hs_compile_lit_multi_opts(expr, nullptr, ids, lens, 5,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(serial, toBytes(db));
+}
+
+TEST(MultiThreadedCompile, FirstError) {
+    // Errors must be reported against the same expression as a serial
+    // compile, even when later expressions fail to parse first.
+    const char *expr[] = {"foo", "bar", "(unclosed", "baz", "[z-a]", "qux"};
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_THREADS;
+    options.threads = 4;
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+
+    hs_error_t err = hs_compile_ext_multi_opts(expr, nullptr, nullptr, nullptr,
+                                               6, HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+
+    ASSERT_EQ(HS_COMPILER_ERROR, err);
+    ASSERT_EQ(nullptr, db);
+    ASSERT_NE(nullptr, compile_err);
+    EXPECT_EQ(2, compile_err->expression);
+    hs_free_compile_error(compile_err);
+}
+
+TEST(MultiThreadedCompile, Concurrent) {
+    // The thread count belongs to each compile call: serial and parallel
+    // compiles running at the same time do not affect each other.
+    const vector<const char *> expr = {
+        "foobar", "abc[0-9]+def", "x.*y.*z", "[a-f]{4,12}q",
+        "teakettle.{3,20}badger", "zz[0-9]{3}yy.*ww",
+    };
+    const vector<unsigned> flags(expr.size(), HS_FLAG_DOTALL);
+
+    string expected = compileToBytes(expr, flags, HS_MODE_BLOCK, 1);
+    ASSERT_FALSE(expected.empty());
+
+    const vector<unsigned> threads = {1, 4, HS_COMPILE_THREADS_ALL, 0, 2};
+    vector<string> out(threads.size());
+    vector<thread> workers;
+    for (size_t i = 0; i < threads.size(); i++) {
+        workers.emplace_back([&, i] {
+            out[i] = compileToBytes(expr, flags, HS_MODE_BLOCK, threads[i]);
+        });
+    }
+    for (auto &t : workers) {
+        t.join();
+    }
+
+    for (const auto &s : out) {
+        ASSERT_EQ(expected, s);
+    }
+}
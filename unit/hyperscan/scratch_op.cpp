@@ -291,4 +291,115 @@ TEST(scratch, damagedScratch) {
     hs_free_database(db);
 }
 
+TEST(scratch, scanStats) {
+    hs_database_t *db = buildDB("foobar", 0, 0, HS_MODE_BLOCK, nullptr);
+    ASSERT_NE(nullptr, db);
+
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    hs_scan_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    err = hs_set_scan_stats(scratch, &stats);
+#ifdef SCAN_STATS
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    const string data("xxfoobarxxxxfoobarxx");
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch, dummy_cb,
+                  nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(1, stats.scans);
+    ASSERT_EQ(data.size(), stats.bytes_scanned);
+    ASSERT_EQ(2, stats.reports);
+
+    // Clones do not inherit the registration.
+    hs_scratch_t *clone = nullptr;
+    err = hs_clone_scratch(scratch, &clone);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_scan(db, data.c_str(), data.size(), 0, clone, dummy_cb, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(1, stats.scans);
+    hs_free_scratch(clone);
+
+    // Nor is anything counted once unregistered.
+    err = hs_set_scan_stats(scratch, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch, dummy_cb,
+                  nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(1, stats.scans);
+#else
+    ASSERT_EQ(HS_INVALID, err);
+    err = hs_set_scan_stats(scratch, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+#endif
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(scratch, scanProfile) {
+    const vector<pattern> patterns = {
+        pattern("foobar", 0, 10),
+        pattern("abc.*def", HS_FLAG_DOTALL, 20),
+    };
+    hs_database_t *db = buildDB(patterns, HS_MODE_BLOCK);
+    ASSERT_NE(nullptr, db);
+
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    hs_scan_profile_t *profile = nullptr;
+    err = hs_alloc_scan_profile(db, &profile);
+#ifdef SCAN_PROFILE
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, profile);
+
+    err = hs_set_scan_profile(scratch, profile);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    string data(10000, 'x');
+    data += "abcfoobarxxdefxxfoobar";
+    err = hs_scan(db, data.c_str(), data.size(), 0, scratch, dummy_cb,
+                  nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    hs_expression_cost_t costs[4];
+    unsigned int count = 0;
+    unsigned long long unattributed = 0;
+    err = hs_scan_profile_costs(profile, costs, 4, &count, &unattributed);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_GE(2U, count);
+
+    unsigned long long total = unattributed;
+    for (unsigned int i = 0; i < count; i++) {
+        ASSERT_TRUE(costs[i].id == 10 || costs[i].id == 20);
+        ASSERT_LT(0ULL, costs[i].ticks);
+        if (i) {
+            ASSERT_GE(costs[i - 1].ticks, costs[i].ticks);
+        }
+        total += costs[i].ticks;
+    }
+    ASSERT_LT(0ULL, total);
+
+    // Profiles must be unregistered before they are freed.
+    err = hs_set_scan_profile(scratch, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+    err = hs_free_scan_profile(profile);
+    ASSERT_EQ(HS_SUCCESS, err);
+#else
+    ASSERT_EQ(HS_INVALID, err);
+    ASSERT_EQ(nullptr, profile);
+    err = hs_set_scan_profile(scratch, nullptr);
+    ASSERT_EQ(HS_SUCCESS, err);
+#endif
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
 } // namespace
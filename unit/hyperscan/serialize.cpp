@@ -36,10 +36,19 @@
 #include "hs_internal.h"
 #include "test_util.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 using namespace std;
@@ -237,6 +246,72 @@ TEST_P(SerializeP, DeserializeAtFromAnyAlignment) {
     delete[] mem;
 }
 
+// Check that an image can be used in place once suitably aligned, and that the
+// database it yields is usable and consistent with the original
+TEST_P(SerializeP, DeserializeInPlace) {
+    const unsigned mode = get<0>(GetParam());
+    const pattern &pat = get<1>(GetParam());
+    SCOPED_TRACE(mode);
+    SCOPED_TRACE(pat);
+
+    hs_error_t err;
+    hs_database_t *db = buildDB(pat, mode);
+    ASSERT_TRUE(db != nullptr) << "database build failed.";
+
+    char *original_info = nullptr;
+    err = hs_database_info(db, &original_info);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    size_t db_len;
+    err = hs_database_size(db, &db_len);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    char *bytes = nullptr;
+    size_t length = 0;
+    err = hs_serialize_database_image(db, &bytes, &length);
+    ASSERT_EQ(HS_SUCCESS, err) << "serialize failed.";
+    ASSERT_NE(nullptr, bytes);
+    ASSERT_EQ(db_len, length);
+
+    hs_free_database(db);
+    db = nullptr;
+
+    const size_t align = 64;
+    char *copy = new char[length + 2 * align];
+    char *aligned = (char *)(((uintptr_t)copy + align - 1) & ~(align - 1));
+
+    // Misaligned images are rejected.
+    for (size_t i = 1; i < align; i *= 2) {
+        SCOPED_TRACE(i);
+        memcpy(aligned + i, bytes, length);
+        const hs_database_t *in_place = nullptr;
+        err = hs_deserialize_database_in_place(aligned + i, length, &in_place);
+        ASSERT_EQ(HS_BAD_ALIGN, err);
+        ASSERT_EQ(nullptr, in_place);
+    }
+
+    memcpy(aligned, bytes, length);
+    const hs_database_t *in_place = nullptr;
+    err = hs_deserialize_database_in_place(aligned, length, &in_place);
+    ASSERT_EQ(HS_SUCCESS, err) << "deserialize failed.";
+    ASSERT_EQ((const hs_database_t *)aligned, in_place);
+
+    char *info = nullptr;
+    err = hs_database_info(in_place, &info);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_STREQ(original_info, info);
+    free(info);
+
+    hs_scratch_t *scratch = nullptr;
+    err = hs_alloc_scratch(in_place, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_scratch(scratch);
+
+    free(original_info);
+    free(bytes);
+    delete[] copy;
+}
+
 INSTANTIATE_TEST_CASE_P(Serialize, SerializeP,
                         Combine(ValuesIn(validModes), ValuesIn(testPatterns)));
 
@@ -570,4 +645,274 @@ TEST(Serialize, DeserializeGarbage) {
     free(bytes);
 }
 
+TEST(Serialize, DeserializeInPlaceGarbage) {
+    static const char *pat = "hatstand.*(badgerbrush|teakettle)";
+    hs_database_t *db = buildDB(pat, 0, 1000, HS_MODE_BLOCK);
+    ASSERT_TRUE(db != nullptr) << "database build failed.";
+
+    char *bytes = nullptr;
+    size_t length = 0;
+    hs_error_t err = hs_serialize_database_image(db, &bytes, &length);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    char *ser = nullptr;
+    size_t ser_len = 0;
+    err = hs_serialize_database(db, &ser, &ser_len);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+
+    const size_t align = 64;
+    size_t max_len = max(length, ser_len);
+    char *copy = new char[max_len + align];
+    char *aligned = (char *)(((uintptr_t)copy + align - 1) & ~(align - 1));
+    const hs_database_t *in_place = nullptr;
+
+    // The output of hs_serialize_database is not an image.
+    memcpy(aligned, ser, ser_len);
+    err = hs_deserialize_database_in_place(aligned, ser_len, &in_place);
+    ASSERT_NE(HS_SUCCESS, err);
+    ASSERT_EQ(nullptr, in_place);
+
+    // Wrong lengths.
+    memcpy(aligned, bytes, length);
+    err = hs_deserialize_database_in_place(aligned, length - 1, &in_place);
+    ASSERT_NE(HS_SUCCESS, err);
+    err = hs_deserialize_database_in_place(aligned, 10, &in_place);
+    ASSERT_NE(HS_SUCCESS, err);
+
+    // Corrupt bytecode fails the checksum.
+    aligned[length / 2] ^= 0x1;
+    err = hs_deserialize_database_in_place(aligned, length, &in_place);
+    ASSERT_EQ(HS_INVALID, err);
+    ASSERT_EQ(nullptr, in_place);
+
+    free(bytes);
+    free(ser);
+    delete[] copy;
+}
+
+#if !defined(_WIN32)
+static
+vector<string> listDir(const string &dir) {
+    vector<string> names;
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        return names;
+    }
+    while (struct dirent *e = readdir(d)) {
+        if (e->d_name[0] != '.') {
+            names.push_back(dir + "/" + e->d_name);
+        }
+    }
+    closedir(d);
+    return names;
+}
+
+static
+string serializeToString(const hs_database_t *db) {
+    char *bytes = nullptr;
+    size_t len = 0;
+    hs_error_t err = hs_serialize_database(db, &bytes, &len);
+    EXPECT_EQ(HS_SUCCESS, err);
+    string s(bytes, len);
+    free(bytes);
+    return s;
+}
+
+TEST(Serialize, CompileCached) {
+    char tmpl[] = "/tmp/hs_cache_XXXXXX";
+    const char *dir = mkdtemp(tmpl);
+    ASSERT_NE(nullptr, dir);
+
+    const char *expr[] = {"foo.*bar", "badger{2,10}"};
+    const unsigned flags[] = {0, HS_FLAG_CASELESS};
+    const unsigned ids[] = {1, 2};
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_CACHE_DIR;
+    options.cache_dir = dir;
+
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr, flags, ids, nullptr, 2,
+                                               HS_MODE_BLOCK, nullptr,
+                                               &options, &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    vector<string> files = listDir(dir);
+    ASSERT_EQ(1U, files.size());
+    string orig = serializeToString(db);
+    hs_free_database(db);
+
+    // Same inputs: loaded from the cache, no new file.
+    db = nullptr;
+    err = hs_compile_ext_multi_opts(expr, flags, ids, nullptr, 2,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    ASSERT_EQ(1U, listDir(dir).size());
+    ASSERT_EQ(orig, serializeToString(db));
+    hs_free_database(db);
+
+    // Different flags: a separate cache entry.
+    const unsigned flags2[] = {HS_FLAG_DOTALL, HS_FLAG_CASELESS};
+    db = nullptr;
+    err = hs_compile_ext_multi_opts(expr, flags2, ids, nullptr, 2,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    hs_free_database(db);
+    files = listDir(dir);
+    ASSERT_EQ(2U, files.size());
+
+    // A traffic profile: a separate cache entry.
+    hs_traffic_t *traffic = nullptr;
+    ASSERT_EQ(HS_SUCCESS, hs_alloc_traffic(&traffic));
+    const char sample[] = "foo bar badger badger";
+    ASSERT_EQ(HS_SUCCESS,
+              hs_traffic_add(traffic, sample, sizeof(sample) - 1));
+    hs_compile_options_t traffic_options = options;
+    traffic_options.flags |= HS_COMPILE_OPT_TRAFFIC;
+    traffic_options.traffic = traffic;
+    db = nullptr;
+    err = hs_compile_ext_multi_opts(expr, flags, ids, nullptr, 2,
+                                    HS_MODE_BLOCK, nullptr, &traffic_options,
+                                    &db, &compile_err);
+    hs_free_traffic(traffic);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    hs_free_database(db);
+    files = listDir(dir);
+    ASSERT_EQ(3U, files.size());
+
+    // The same strings as pure literals: a separate cache entry.
+    const size_t lens[] = {strlen(expr[0]), strlen(expr[1])};
+    db = nullptr;
+    err = hs_compile_lit_multi_opts(expr, flags, ids, lens, 2, HS_MODE_BLOCK,
+                                    nullptr, &options, &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    string lit = serializeToString(db);
+    ASSERT_NE(orig, lit);
+    hs_free_database(db);
+    files = listDir(dir);
+    ASSERT_EQ(4U, files.size());
+
+    db = nullptr;
+    err = hs_compile_lit_multi_opts(expr, flags, ids, lens, 2, HS_MODE_BLOCK,
+                                    nullptr, &options, &db, &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    ASSERT_EQ(4U, listDir(dir).size());
+    ASSERT_EQ(lit, serializeToString(db));
+    hs_free_database(db);
+
+    // A corrupt cache file is ignored and rewritten.
+    for (const auto &f : files) {
+        FILE *fp = fopen(f.c_str(), "r+b");
+        ASSERT_NE(nullptr, fp);
+        fputs("garbage", fp);
+        fclose(fp);
+    }
+    db = nullptr;
+    err = hs_compile_ext_multi_opts(expr, flags, ids, nullptr, 2,
+                                    HS_MODE_BLOCK, nullptr, &options, &db,
+                                    &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    ASSERT_EQ(orig, serializeToString(db));
+    hs_free_database(db);
+
+    for (const auto &f : listDir(dir)) {
+        unlink(f.c_str());
+    }
+    rmdir(dir);
+}
+
+TEST(Serialize, CompileCachedConcurrent) {
+    char tmpl[] = "/tmp/hs_cache_XXXXXX";
+    const char *dir = mkdtemp(tmpl);
+    ASSERT_NE(nullptr, dir);
+
+    const char *expr[] = {"foo.*bar", "badger{2,10}"};
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_CACHE_DIR;
+    options.cache_dir = dir;
+
+    // Threads compiling the same key all write the same cache file; each
+    // must write its own temporary file, so every write is complete.
+    const unsigned num_threads = 8;
+    vector<string> out(num_threads);
+    vector<hs_error_t> errs(num_threads, HS_INVALID);
+    vector<thread> threads;
+    for (unsigned i = 0; i < num_threads; i++) {
+        threads.emplace_back([&, i] {
+            hs_database_t *db = nullptr;
+            hs_compile_error_t *compile_err = nullptr;
+            errs[i] = hs_compile_ext_multi_opts(expr, nullptr, nullptr,
+                                                nullptr, 2, HS_MODE_BLOCK,
+                                                nullptr, &options, &db,
+                                                &compile_err);
+            if (errs[i] == HS_SUCCESS) {
+                out[i] = serializeToString(db);
+                hs_free_database(db);
+            } else {
+                hs_free_compile_error(compile_err);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (unsigned i = 0; i < num_threads; i++) {
+        ASSERT_EQ(HS_SUCCESS, errs[i]);
+        ASSERT_EQ(out[0], out[i]);
+    }
+
+    // One cache file, no temporary files left behind, and it loads.
+    vector<string> files = listDir(dir);
+    ASSERT_EQ(1U, files.size());
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr, nullptr, nullptr,
+                                               nullptr, 2, HS_MODE_BLOCK,
+                                               nullptr, &options, &db,
+                                               &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(out[0], serializeToString(db));
+    hs_free_database(db);
+
+    for (const auto &f : listDir(dir)) {
+        unlink(f.c_str());
+    }
+    rmdir(dir);
+}
+
+TEST(Serialize, CompileCachedBadDir) {
+    const char *expr[] = {"foo.*bar"};
+
+    hs_compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.flags = HS_COMPILE_OPT_CACHE_DIR;
+    options.cache_dir = "/nonexistent/hs_cache";
+
+    // An unusable cache directory does not prevent compilation.
+    hs_database_t *db = nullptr;
+    hs_compile_error_t *compile_err = nullptr;
+    hs_error_t err = hs_compile_ext_multi_opts(expr, nullptr, nullptr,
+                                               nullptr, 1, HS_MODE_BLOCK,
+                                               nullptr, &options, &db,
+                                               &compile_err);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_NE(nullptr, db);
+    hs_free_database(db);
+}
+#endif
+
 }
@@ -26,11 +26,15 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cctype>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "hs.h"
 #include "test_util.h"
+#include "rose/stream_long_lit_hash.h"
 
 using namespace std;
 
@@ -823,4 +827,278 @@ TEST(StreamUtil, StreamAllocUsage) {
     ASSERT_EQ(0, alloc3_called);
 }
 
+
+// Batch callback: records matches into the CallBackContext for that entry.
+int record_batch_cb(unsigned index, unsigned id, unsigned long long,
+                    unsigned long long to, unsigned, void *ctxt) {
+    vector<CallBackContext> *c = (vector<CallBackContext> *)ctxt;
+
+    (*c)[index].matches.emplace_back(to, id);
+
+    return (int)(*c)[index].halt;
+}
+
+TEST(StreamUtil, ScanBatch) {
+    hs_error_t err;
+    hs_scratch_t *scratch = nullptr;
+    hs_database_t *db = buildDBAndScratch("foo.*bar", 0, 0, HS_MODE_STREAM,
+                                          &scratch);
+    ASSERT_NE(nullptr, db);
+
+    hs_stream_t *streams[3] = {nullptr, nullptr, nullptr};
+    for (auto &stream : streams) {
+        err = hs_open_stream(db, 0, &stream);
+        ASSERT_EQ(HS_SUCCESS, err);
+        ASSERT_TRUE(stream != nullptr);
+    }
+
+    vector<CallBackContext> c(4);
+
+    // First write: the middle stream sees a complete match, the others only
+    // the start of one. The last entry writes to the first stream again.
+    hs_stream_t *ids[] = {streams[0], streams[1], streams[2], streams[0]};
+    const char *data[] = {"xxfoo", "foobar", "foo", "xxbar"};
+    unsigned int len[] = {5, 6, 3, 5};
+
+    err = hs_scan_stream_batch(ids, data, len, 4, 0, scratch, record_batch_cb,
+                               (void *)&c);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(0U, c[0].matches.size());
+    ASSERT_EQ(1U, c[1].matches.size());
+    ASSERT_EQ(MatchRecord(6, 0), c[1].matches[0]);
+    ASSERT_EQ(0U, c[2].matches.size());
+    ASSERT_EQ(1U, c[3].matches.size());
+    ASSERT_EQ(MatchRecord(10, 0), c[3].matches[0]);
+
+    for (auto &cc : c) {
+        cc.clear();
+    }
+
+    // Second write: stream offsets carry over from the first batch.
+    const char *data2[] = {"bar", "bar", "bar"};
+    unsigned int len2[] = {3, 3, 3};
+
+    err = hs_scan_stream_batch(streams, data2, len2, 3, 0, scratch,
+                               record_batch_cb, (void *)&c);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_EQ(1U, c[0].matches.size());
+    ASSERT_EQ(MatchRecord(13, 0), c[0].matches[0]);
+    ASSERT_EQ(1U, c[1].matches.size());
+    ASSERT_EQ(MatchRecord(9, 0), c[1].matches[0]);
+    ASSERT_EQ(1U, c[2].matches.size());
+    ASSERT_EQ(MatchRecord(6, 0), c[2].matches[0]);
+
+    for (auto &stream : streams) {
+        err = hs_close_stream(stream, scratch, nullptr, nullptr);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+TEST(StreamUtil, ScanBatchTerminate) {
+    hs_error_t err;
+    hs_scratch_t *scratch = nullptr;
+    hs_database_t *db = buildDBAndScratch("foo", 0, 0, HS_MODE_STREAM,
+                                          &scratch);
+    ASSERT_NE(nullptr, db);
+
+    hs_stream_t *streams[2] = {nullptr, nullptr};
+    for (auto &stream : streams) {
+        err = hs_open_stream(db, 0, &stream);
+        ASSERT_EQ(HS_SUCCESS, err);
+        ASSERT_TRUE(stream != nullptr);
+    }
+
+    vector<CallBackContext> c(2);
+    c[0].halt = true;
+
+    // Halting the first stream must not stop the second one being scanned.
+    const char *data[] = {"foofoo", "foofoo"};
+    unsigned int len[] = {6, 6};
+
+    err = hs_scan_stream_batch(streams, data, len, 2, 0, scratch,
+                               record_batch_cb, (void *)&c);
+    ASSERT_EQ(HS_SCAN_TERMINATED, err);
+    ASSERT_EQ(1U, c[0].matches.size());
+    ASSERT_EQ(2U, c[1].matches.size());
+
+    // The first stream stays terminated, as with hs_scan_stream.
+    err = hs_scan_stream(streams[0], "foo", 3, 0, scratch, record_cb,
+                         (void *)&c[0]);
+    ASSERT_EQ(HS_SCAN_TERMINATED, err);
+    ASSERT_EQ(1U, c[0].matches.size());
+
+    for (auto &stream : streams) {
+        err = hs_close_stream(stream, scratch, nullptr, nullptr);
+        ASSERT_EQ(HS_SUCCESS, err);
+    }
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// A set of plain literals gets a long literal threshold of 33 bytes, so
+// literals of this length have a single hashed position (at offset one) in
+// the long literal table, and the table holds their first 33 bytes.
+static const size_t SHORT_LONG_LIT_LEN = 34;
+
+// Smallest long literal hash table, used for up to 88 hashed positions.
+static const u32 MIN_LONG_LIT_BUCKETS = 128;
+
+static
+string randomLit(mt19937 &prng, size_t len) {
+    string s;
+    for (size_t i = 0; i < len; i++) {
+        s.push_back('a' + prng() % 26);
+    }
+    return s;
+}
+
+// Random literals whose hashed position lands in one of the last four
+// buckets of the table, so that they form one probe chain that runs past the
+// end of the table and wraps around.
+static
+vector<string> makeCollidingLits(mt19937 &prng, size_t count, bool nocase) {
+    vector<string> lits;
+    while (lits.size() < count) {
+        string s = randomLit(prng, SHORT_LONG_LIT_LEN);
+        u32 hash = hashLongLiteral((const u8 *)s.c_str() + 1,
+                                   LONG_LIT_HASH_LEN, nocase);
+        if (hash % MIN_LONG_LIT_BUCKETS >= MIN_LONG_LIT_BUCKETS - 4) {
+            lits.push_back(s);
+        }
+    }
+    return lits;
+}
+
+// Flip the case of every other character, for caseless literals.
+static
+string mixCase(string s) {
+    for (size_t i = 0; i < s.size(); i += 2) {
+        s[i] = toupper(s[i]);
+    }
+    return s;
+}
+
+// Scan data in a new stream, with a write boundary at each of the given
+// offsets.
+static
+void scanSplit(const hs_database_t *db, hs_scratch_t *scratch,
+               const string &data, const vector<size_t> &splits,
+               CallBackContext &c) {
+    hs_stream_t *stream = nullptr;
+    hs_error_t err = hs_open_stream(db, 0, &stream);
+    ASSERT_EQ(HS_SUCCESS, err);
+    ASSERT_TRUE(stream != nullptr);
+
+    size_t start = 0;
+    for (size_t i = 0; i <= splits.size(); i++) {
+        size_t end = i < splits.size() ? splits[i] : data.size();
+        ASSERT_LT(start, end);
+        err = hs_scan_stream(stream, data.c_str() + start, end - start, 0,
+                             scratch, record_cb, (void *)&c);
+        ASSERT_EQ(HS_SUCCESS, err);
+        start = end;
+    }
+
+    err = hs_close_stream(stream, scratch, record_cb, (void *)&c);
+    ASSERT_EQ(HS_SUCCESS, err);
+}
+
+// Caseful and caseless long literals that all share the last few buckets of
+// their hash tables, so that looking them up walks a probe chain longer than
+// one window of tags and through the tags mirrored at the end of the table.
+TEST(StreamUtil, LongLitProbeChain) {
+    mt19937 prng(15);
+    const size_t count = 24;
+    const vector<string> case_lits = makeCollidingLits(prng, count, false);
+    const vector<string> nocase_lits = makeCollidingLits(prng, count, true);
+
+    vector<pattern> patterns;
+    for (size_t i = 0; i < count; i++) {
+        patterns.emplace_back(case_lits[i], 0, i);
+        patterns.emplace_back(nocase_lits[i], HS_FLAG_CASELESS, count + i);
+    }
+
+    hs_database_t *db = buildDB(patterns, HS_MODE_STREAM);
+    ASSERT_NE(nullptr, db);
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    for (size_t i = 0; i < 2 * count; i++) {
+        bool nocase = i >= count;
+        const string &lit = nocase ? nocase_lits[i - count] : case_lits[i];
+        string data = nocase ? mixCase(lit) : lit;
+
+        // The literal ends in its own write, after the whole prefix held in
+        // the table has been written in two pieces.
+        vector<size_t> splits = {1 + prng() % 32, SHORT_LONG_LIT_LEN - 1};
+
+        CallBackContext c;
+        scanSplit(db, scratch, data, splits, c);
+        ASSERT_EQ(1U, c.matches.size());
+        ASSERT_EQ(MatchRecord(SHORT_LONG_LIT_LEN, i), c.matches[0]);
+
+        // A different first byte is outside the hashed bytes, so it finds the
+        // same chain and tag but must fail to confirm.
+        data[0] = lit[0] == 'a' ? 'b' : 'a';
+        c.clear();
+        scanSplit(db, scratch, data, splits, c);
+        ASSERT_EQ(0U, c.matches.size());
+    }
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
+// Longer literals split across two and three writes at every point, so that
+// the stream state holds prefixes at all of their hashed positions.
+TEST(StreamUtil, LongLitSplitWrites) {
+    mt19937 prng(16);
+    const size_t len = 80;
+    const string pre(10, '-');
+
+    vector<pattern> patterns;
+    vector<string> data;
+    for (unsigned i = 0; i < 4; i++) {
+        bool nocase = i % 2;
+        string lit = randomLit(prng, len);
+        patterns.emplace_back(lit, nocase ? HS_FLAG_CASELESS : 0, i);
+        data.push_back(pre + (nocase ? mixCase(lit) : lit) + pre);
+    }
+
+    hs_database_t *db = buildDB(patterns, HS_MODE_STREAM);
+    ASSERT_NE(nullptr, db);
+    hs_scratch_t *scratch = nullptr;
+    hs_error_t err = hs_alloc_scratch(db, &scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+
+    const size_t end = pre.size() + len;
+    for (unsigned i = 0; i < data.size(); i++) {
+        for (size_t split = 1; split < data[i].size(); split++) {
+            CallBackContext c;
+            scanSplit(db, scratch, data[i], {split}, c);
+            ASSERT_EQ(1U, c.matches.size());
+            ASSERT_EQ(MatchRecord(end, i), c.matches[0]);
+
+            size_t second = split + 1 + prng() % (len / 2);
+            if (second >= data[i].size()) {
+                continue;
+            }
+            c.clear();
+            scanSplit(db, scratch, data[i], {split, second}, c);
+            ASSERT_EQ(1U, c.matches.size());
+            ASSERT_EQ(MatchRecord(end, i), c.matches[0]);
+        }
+    }
+
+    err = hs_free_scratch(scratch);
+    ASSERT_EQ(HS_SUCCESS, err);
+    hs_free_database(db);
+}
+
 }
@@ -38,6 +38,7 @@
 #include "fdr/teddy_engine_description.h"
 #include "hwlm/hwlm_internal.h"
 #include "util/alloc.h"
+#include "util/traffic_model.h"
 
 #include "database.h"
 #include "scratch.h"
@@ -153,8 +154,10 @@ bytecode_ptr<FDR> buildFDREngineHinted(std::vector<hwlmLiteral> &lits,
 static
 bytecode_ptr<FDR> buildFDREngine(std::vector<hwlmLiteral> &lits,
                                  bool make_small, const target_t &target,
-                                 const Grey &grey) {
-    auto proto = fdrBuildProto(HWLM_ENGINE_FDR, lits, make_small, target, grey);
+                                 const Grey &grey,
+                                 const TrafficModel *traffic = nullptr) {
+    auto proto = fdrBuildProto(HWLM_ENGINE_FDR, lits, make_small, target, grey,
+                               traffic);
     if (!proto) {
         return nullptr;
     }
@@ -243,6 +246,43 @@ TEST_P(FDRp, MultiLocation) {
     }
 }
 
+TEST_P(FDRp, ManyBuckets) {
+    const u32 hint = GetParam();
+    SCOPED_TRACE(hint);
+
+    // Enough distinct literals to occupy every bucket of the widest Teddy.
+    const u32 numLits = 32;
+    vector<hwlmLiteral> lits;
+    for (u32 i = 0; i < numLits; i++) {
+        string s = "wb";
+        s += (char)('A' + i / 8);
+        s += (char)('a' + i % 8);
+        lits.push_back(hwlmLiteral(s, 0, i));
+    }
+
+    auto fdr = buildFDREngineHinted(lits, false, hint, get_current_target(),
+                                    Grey());
+    CHECK_WITH_TEDDY_OK_TO_FAIL(fdr, hint);
+
+    const u32 testSize = 96;
+    vector<u8> data(testSize, 0);
+
+    struct hs_scratch scratch;
+    scratch.fdr_conf = NULL;
+    for (u32 id = 0; id < numLits; id++) {
+        const string &s = lits[id].s;
+        for (u32 i = 0; i + s.size() <= testSize; i += 7) {
+            memcpy(data.data() + i, s.c_str(), s.size());
+            fdrExec(fdr.get(), data.data(), testSize, 0, decentCallback,
+                    &scratch, HWLM_ALL_GROUPS);
+            ASSERT_EQ(1U, matches.size());
+            EXPECT_EQ(match(i + s.size() - 1, id), matches[0]);
+            memset(data.data() + i, 0, s.size());
+            matches.clear();
+        }
+    }
+}
+
 TEST_P(FDRp, NoRepeat1) {
     const u32 hint = GetParam();
     SCOPED_TRACE(hint);
@@ -742,3 +782,53 @@ TEST(FDR, FDRTermB) {
     ASSERT_EQ(1U, matches.size());
     matches.clear();
 }
+
+TEST(FDR, TrafficTuned) {
+    // Tuning for traffic must only change performance, never the matches.
+    string data;
+    for (u32 i = 0; i < 200; i++) {
+        data += "GET /index.html HTTP/1.1\r\nHost: www" + to_string(i) +
+                ".example.com\r\n\r\n";
+    }
+
+    vector<unsigned long long> hist(256 * 256, 0);
+    for (size_t i = 1; i < data.size(); i++) {
+        hist[(u8)data[i - 1] * 256 + (u8)data[i]]++;
+    }
+    TrafficModel traffic(hist.data());
+
+    vector<hwlmLiteral> small_lits;
+    small_lits.push_back(hwlmLiteral("HTTP", 0, 0));
+    small_lits.push_back(hwlmLiteral("host", 1, 1));
+    small_lits.push_back(hwlmLiteral("www1", 0, 2));
+    small_lits.push_back(hwlmLiteral("zzyzx", 0, 3));
+
+    vector<hwlmLiteral> large_lits = small_lits;
+    for (u32 i = 0; i < 300; i++) {
+        large_lits.push_back(hwlmLiteral("q" + to_string(i * 7919), 0,
+                                         4 + i));
+    }
+    large_lits.push_back(hwlmLiteral("example", 0, 1000));
+    large_lits.push_back(hwlmLiteral("w9", 0, 1001));
+
+    const TrafficModel *models[] = {nullptr, &traffic};
+    for (const auto &lits : {small_lits, large_lits}) {
+        vector<vector<match>> results;
+        for (const TrafficModel *t : models) {
+            auto build_lits = lits;
+            auto fdr = buildFDREngine(build_lits, false, get_current_target(),
+                                      Grey(), t);
+            ASSERT_TRUE(fdr != nullptr);
+
+            struct hs_scratch scratch;
+            scratch.fdr_conf = NULL;
+            fdrExec(fdr.get(), (const u8 *)data.data(), data.size(), 0,
+                    decentCallback, &scratch, HWLM_ALL_GROUPS);
+            sort(matches.begin(), matches.end());
+            results.push_back(matches);
+            matches.clear();
+        }
+        ASSERT_FALSE(results[0].empty());
+        EXPECT_EQ(results[0], results[1]);
+    }
+}
@@ -39,7 +39,12 @@
 #include "nfagraph/ng_limex.h"
 #include "nfagraph/ng_util.h"
 #include "util/bytecode_ptr.h"
+#include "util/ng_find_matches.h"
 #include "util/target_info.h"
+#include "hs.h"
+
+#include <random>
+#include <set>
 
 using namespace std;
 using namespace testing;
@@ -133,6 +138,10 @@ INSTANTIATE_TEST_CASE_P(
     LimEx, LimExModelTest,
     Range((int)LIMEX_NFA_32, (int)LIMEX_NFA_512));
 
+INSTANTIATE_TEST_CASE_P(
+    LimExLarge, LimExModelTest,
+    Values((int)LIMEX_NFA_768, (int)LIMEX_NFA_1024));
+
 TEST_P(LimExModelTest, StateSize) {
     ASSERT_TRUE(nfa != nullptr);
 
@@ -336,6 +345,8 @@ protected:
 
 INSTANTIATE_TEST_CASE_P(LimExReverse, LimExReverseTest,
                         Range((int)LIMEX_NFA_32, (int)LIMEX_NFA_512));
+INSTANTIATE_TEST_CASE_P(LimExReverseLarge, LimExReverseTest,
+                        Values((int)LIMEX_NFA_768, (int)LIMEX_NFA_1024));
 
 TEST_P(LimExReverseTest, BlockExecReverse) {
     ASSERT_TRUE(nfa != nullptr);
@@ -425,6 +436,8 @@ protected:
 
 INSTANTIATE_TEST_CASE_P(LimExZombie, LimExZombieTest,
                         Range((int)LIMEX_NFA_32, (int)LIMEX_NFA_512));
+INSTANTIATE_TEST_CASE_P(LimExZombieLarge, LimExZombieTest,
+                        Values((int)LIMEX_NFA_768, (int)LIMEX_NFA_1024));
 
 TEST_P(LimExZombieTest, GetZombieStatus) {
     ASSERT_TRUE(nfa != nullptr);
@@ -448,3 +461,202 @@ TEST_P(LimExZombieTest, GetZombieStatus) {
     // The .* at the end of the pattern should have turned us into a zombie...
     ASSERT_EQ(NFA_ZOMBIE_ALWAYS_YES, nfaGetZombieStatus(nfa.get(), &q, end));
 }
+
+// Patterns too large for the 512 state model, which used to be rejected by
+// the NFA builder. Matches are checked against the reference matcher, both
+// for the NFA on its own and for the whole database.
+
+static
+int onMatchEnd(u64a, u64a end, ReportID, void *ctx) {
+    auto *ends = (set<u64a> *)ctx;
+    ends->insert(end);
+    return MO_CONTINUE_MATCHING;
+}
+
+static
+int HS_CDECL onHsMatchEnd(unsigned, unsigned long long,
+                          unsigned long long end, unsigned, void *ctx) {
+    auto *ends = (set<u64a> *)ctx;
+    ends->insert(end);
+    return 0;
+}
+
+struct LargeExprParams {
+    u32 alternatives; // each of LARGE_ALT_LEN positions
+    int type; // expected LimEx model
+};
+
+static const u32 LARGE_ALT_LEN = 5;
+static const size_t LARGE_SCAN_LEN = 4096;
+
+class LimExLargeExprTest : public TestWithParam<LargeExprParams> {
+protected:
+    virtual void SetUp() {
+        // An unanchored alternation of short random sequences of characters
+        // and two character classes over a small alphabet: no repeats and no
+        // useful literals, so every position is a state.
+        mt19937 prng(GetParam().alternatives);
+        expr = "(";
+        for (u32 i = 0; i < GetParam().alternatives; i++) {
+            if (i) {
+                expr += "|";
+            }
+            for (u32 j = 0; j < LARGE_ALT_LEN; j++) {
+                char c = 'a' + prng() % 8;
+                if (prng() % 2) {
+                    expr += string("[") + c + (char)('a' + prng() % 8) + "]";
+                } else {
+                    expr += c;
+                }
+            }
+        }
+        expr += ")";
+
+        data.resize(LARGE_SCAN_LEN);
+        for (auto &c : data) {
+            c = 'a' + prng() % 8;
+        }
+
+        CompileContext cc(false, false, get_current_target(), Grey());
+        ReportManager rm(cc.grey);
+        ParsedExpression parsed(0, expr.c_str(), 0, 0);
+        auto built_expr = buildGraph(rm, cc, parsed);
+        ASSERT_TRUE(built_expr.g != nullptr);
+
+        set<pair<size_t, size_t>> matches;
+        ASSERT_TRUE(findMatches(*built_expr.g, rm, data, matches, 0, 0, false,
+                                false));
+        for (const auto &m : matches) {
+            expected.insert(m.second);
+        }
+        ASSERT_FALSE(expected.empty());
+    }
+
+    bytecode_ptr<NFA> buildNFA(bool streaming) {
+        CompileContext cc(streaming, false, get_current_target(), Grey());
+        ReportManager rm(cc.grey);
+        ParsedExpression parsed(0, expr.c_str(), 0, 0);
+        auto built_expr = buildGraph(rm, cc, parsed);
+        const auto &g = built_expr.g;
+        if (!g) {
+            return nullptr;
+        }
+        clearReports(*g);
+        rm.setProgramOffset(0, MATCH_REPORT);
+
+        const map<u32, u32> fixed_depth_tops;
+        const map<u32, vector<vector<CharReach>>> triggers;
+        bool fast_nfa = false;
+        return constructNFA(*g, &rm, fixed_depth_tops, triggers, streaming,
+                            fast_nfa, cc);
+    }
+
+    // Runs the NFA over the data in writes of at most chunk bytes,
+    // compressing and expanding the state between writes.
+    set<u64a> scanNFA(const NFA *nfa, size_t chunk) {
+        set<u64a> ends;
+        auto full_state = make_bytecode_ptr<char>(nfa->scratchStateSize, 64);
+        auto stream_state = make_bytecode_ptr<char>(nfa->streamStateSize);
+        const u8 *buf = (const u8 *)data.c_str();
+
+        struct mq q;
+        q.nfa = nfa;
+        q.state = full_state.get();
+        q.streamState = stream_state.get();
+        q.history = nullptr;
+        q.hlength = 0;
+        q.scratch = nullptr; /* limex does not use scratch */
+        q.report_current = 0;
+        q.cb = onMatchEnd;
+        q.context = &ends;
+
+        for (size_t pos = 0; pos < data.size(); pos += chunk) {
+            size_t len = min(chunk, data.size() - pos);
+            q.cur = 0;
+            q.end = 0;
+            q.offset = pos;
+            q.buffer = buf + pos;
+            q.length = len;
+            if (!pos) {
+                nfaQueueInitState(nfa, &q);
+                pushQueue(&q, MQE_START, 0);
+                pushQueue(&q, MQE_TOP, 0);
+            } else {
+                q.history = buf;
+                q.hlength = pos;
+                nfaExpandState(nfa, q.state, q.streamState, q.offset,
+                               queue_prev_byte(&q, 0));
+                pushQueue(&q, MQE_START, 0);
+            }
+            pushQueue(&q, MQE_END, len);
+            nfaQueueExec(nfa, &q, len);
+            nfaQueueCompressState(nfa, &q, len);
+        }
+        return ends;
+    }
+
+    string expr;
+    string data;
+    set<u64a> expected;
+};
+
+static const LargeExprParams largeExprParams[] = {
+    {120, LIMEX_NFA_768}, {180, LIMEX_NFA_1024},
+};
+
+INSTANTIATE_TEST_CASE_P(LimExLargeExpr, LimExLargeExprTest,
+                        ValuesIn(largeExprParams));
+
+TEST_P(LimExLargeExprTest, BlockNFA) {
+    auto nfa = buildNFA(false);
+    ASSERT_TRUE(nfa != nullptr);
+    ASSERT_EQ(GetParam().type, (int)nfa->type);
+    ASSERT_EQ(expected, scanNFA(nfa.get(), data.size()));
+}
+
+TEST_P(LimExLargeExprTest, StreamingNFA) {
+    auto nfa = buildNFA(true);
+    ASSERT_TRUE(nfa != nullptr);
+    ASSERT_EQ(GetParam().type, (int)nfa->type);
+    for (size_t chunk : {1, 7, 64, 1000}) {
+        ASSERT_EQ(expected, scanNFA(nfa.get(), chunk)) << "chunk " << chunk;
+    }
+}
+
+TEST_P(LimExLargeExprTest, Database) {
+    const char *e = expr.c_str();
+    for (unsigned mode : {HS_MODE_BLOCK, HS_MODE_STREAM}) {
+        hs_database_t *db = nullptr;
+        hs_compile_error_t *compile_err = nullptr;
+        hs_error_t err = hs_compile(e, 0, mode, nullptr, &db, &compile_err);
+        ASSERT_EQ(HS_SUCCESS, err);
+        ASSERT_TRUE(db != nullptr);
+
+        hs_scratch_t *scratch = nullptr;
+        err = hs_alloc_scratch(db, &scratch);
+        ASSERT_EQ(HS_SUCCESS, err);
+
+        set<u64a> ends;
+        if (mode == HS_MODE_BLOCK) {
+            err = hs_scan(db, data.c_str(), data.size(), 0, scratch,
+                          onHsMatchEnd, &ends);
+            ASSERT_EQ(HS_SUCCESS, err);
+        } else {
+            hs_stream_t *stream = nullptr;
+            err = hs_open_stream(db, 0, &stream);
+            ASSERT_EQ(HS_SUCCESS, err);
+            for (size_t pos = 0; pos < data.size(); pos += 100) {
+                size_t len = min((size_t)100, data.size() - pos);
+                err = hs_scan_stream(stream, data.c_str() + pos, len, 0,
+                                     scratch, onHsMatchEnd, &ends);
+                ASSERT_EQ(HS_SUCCESS, err);
+            }
+            err = hs_close_stream(stream, scratch, onHsMatchEnd, &ends);
+            ASSERT_EQ(HS_SUCCESS, err);
+        }
+        EXPECT_EQ(expected, ends) << "mode " << mode;
+
+        hs_free_scratch(scratch);
+        hs_free_database(db);
+    }
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "ue2common.h"
+#include "grey.h"
+#include "nfa/callback.h"
+#include "nfa/mcclellan.h"
+#include "nfa/mcclellancompile.h"
+#include "nfa/nfa_internal.h"
+#include "nfa/rdfa.h"
+#include "util/bytecode_ptr.h"
+#include "util/compile_context.h"
+#include "util/report_manager.h"
+#include "util/target_info.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace ue2;
+
+namespace {
+
+static const u32 REPORT_COUNT = 3;
+static const u32 MATCH_REPORT = 100;
+
+struct collector {
+    vector<pair<u64a, ReportID>> matches;
+    size_t halt_after = ~size_t{0};
+};
+
+int onMatch(u64a, u64a end, ReportID id, void *ctx) {
+    auto *c = static_cast<collector *>(ctx);
+    c->matches.emplace_back(end, id);
+    return c->matches.size() >= c->halt_after ? MO_HALT_MATCHING
+                                              : MO_CONTINUE_MATCHING;
+}
+
+// Random anchored DFA: a few byte classes, random transitions with optional
+// dead ends and self-loops (to give the accelerator something to do).
+bytecode_ptr<NFA> makeRandomDfa(mt19937 &prng, u32 nstates, u32 report_rate,
+                                bool dead_ends, const CompileContext &cc,
+                                const ReportManager &rm) {
+    raw_dfa r(NFA_OUTFIX);
+    u32 nclass = 2 + prng() % 14;
+    r.alpha_size = nclass + 1;
+    for (u32 c = 0; c < N_CHARS; c++) {
+        r.alpha_remap[c] = prng() % nclass;
+    }
+    r.alpha_remap[TOP] = nclass;
+
+    for (u32 s = 0; s < nstates; s++) {
+        dstate d(r.alpha_size);
+        if (s != DEAD_STATE) {
+            bool self_loop = prng() % 4 == 0;
+            for (u32 a = 0; a < nclass; a++) {
+                if (dead_ends && prng() % 40 == 0) {
+                    d.next[a] = DEAD_STATE;
+                } else if (self_loop && a) {
+                    d.next[a] = s;
+                } else {
+                    d.next[a] = 1 + prng() % (nstates - 1);
+                }
+            }
+            d.next[nclass] = 1;
+            if (prng() % report_rate == 0) {
+                d.reports.insert(prng() % REPORT_COUNT);
+            }
+            if (prng() % (4 * report_rate) == 0) {
+                d.reports_eod.insert(prng() % REPORT_COUNT);
+            }
+        }
+        r.states.push_back(d);
+    }
+    r.start_anchored = 1;
+    r.start_floating = DEAD_STATE;
+    return mcclellanCompile(r, cc, rm, false);
+}
+
+void scanSingle(const NFA *nfa, u64a offset, const vector<u8> &buf,
+                collector *c) {
+    if (nfa->type == MCCLELLAN_NFA_8) {
+        nfaExecMcClellan8_B(nfa, offset, buf.data(), buf.size(), onMatch, c);
+    } else {
+        ASSERT_EQ(MCCLELLAN_NFA_16, nfa->type);
+        nfaExecMcClellan16_B(nfa, offset, buf.data(), buf.size(), onMatch, c);
+    }
+}
+
+class McClellanMultiTest : public ::testing::Test {
+protected:
+    McClellanMultiTest()
+        : target(get_current_target()), cc(false, false, target, grey),
+          rm(grey) {
+        for (u32 i = 0; i < REPORT_COUNT; i++) {
+            rm.getInternalId(makeCallback(i, 0));
+            rm.setProgramOffset(i, MATCH_REPORT + i);
+        }
+    }
+
+    // Scans every block with nfaExecMcClellanMulti_B and one at a time, and
+    // checks that each block saw exactly the same matches.
+    void check(const vector<const NFA *> &nfas,
+               const vector<vector<u8>> &bufs,
+               const vector<size_t> &halt_after) {
+        size_t count = nfas.size();
+        vector<collector> expected(count), actual(count);
+        vector<mcclellan_multi_block> blocks;
+        for (size_t k = 0; k < count; k++) {
+            u64a offset = 10 * k;
+            expected[k].halt_after = halt_after[k];
+            actual[k].halt_after = halt_after[k];
+            scanSingle(nfas[k], offset, bufs[k], &expected[k]);
+            blocks.push_back({nfas[k], offset, bufs[k].data(), bufs[k].size(),
+                              onMatch, &actual[k]});
+        }
+
+        nfaExecMcClellanMulti_B(blocks.data(), count);
+
+        for (size_t k = 0; k < count; k++) {
+            ASSERT_EQ(expected[k].matches, actual[k].matches)
+                << "block " << k << " of " << count;
+        }
+    }
+
+    Grey grey;
+    target_t target;
+    CompileContext cc;
+    ReportManager rm;
+};
+
+} // namespace
+
+TEST_F(McClellanMultiTest, Empty) {
+    nfaExecMcClellanMulti_B(nullptr, 0);
+}
+
+TEST_F(McClellanMultiTest, SharedDfa) {
+    mt19937 prng(17);
+    auto nfa = makeRandomDfa(prng, 40, 5, false, cc, rm);
+    ASSERT_TRUE(nfa != nullptr);
+
+    for (u32 count = 1; count <= MCCLELLAN_MULTI_MAX + 3; count++) {
+        vector<const NFA *> nfas(count, nfa.get());
+        vector<vector<u8>> bufs;
+        for (u32 k = 0; k < count; k++) {
+            bufs.emplace_back(prng() % 2000);
+            for (auto &c : bufs.back()) {
+                c = prng();
+            }
+        }
+        check(nfas, bufs, vector<size_t>(count, ~size_t{0}));
+    }
+}
+
+TEST_F(McClellanMultiTest, Random) {
+    mt19937 prng(7);
+    for (u32 iter = 0; iter < 300; iter++) {
+        u32 count = 1 + prng() % 13;
+        vector<bytecode_ptr<NFA>> owned;
+        vector<const NFA *> nfas;
+        vector<vector<u8>> bufs;
+        vector<size_t> halt_after;
+        bool shared = count > 1 && prng() % 2;
+        for (u32 k = 0; k < count; k++) {
+            if (!shared || !k) {
+                // Mostly 8-bit DFAs, with some large enough to need 16 bits.
+                u32 nstates = prng() % 3 ? 3 + prng() % 200
+                                         : 250 + prng() % 600;
+                owned.push_back(makeRandomDfa(prng, nstates, 1 + prng() % 30,
+                                              prng() % 2, cc, rm));
+                ASSERT_TRUE(owned.back() != nullptr);
+            }
+            nfas.push_back(owned.back().get());
+
+            // Include empty and tiny blocks, and narrow alphabets that keep
+            // the DFA out of its dead state for longer.
+            bufs.emplace_back(prng() % 5 ? prng() % 3000 : prng() % 5);
+            u32 range = prng() % 4 ? 256 : 4;
+            for (auto &c : bufs.back()) {
+                c = prng() % range;
+            }
+            halt_after.push_back(prng() % 6 ? ~size_t{0} : 1 + prng() % 20);
+        }
+        check(nfas, bufs, halt_after);
+    }
+}
@@ -31,6 +31,7 @@
 #include "ue2common.h"
 #include "hwlm/noodle_build.h"
 #include "hwlm/noodle_engine.h"
+#include "hwlm/noodle_internal.h"
 #include "hwlm/hwlm.h"
 #include "hwlm/hwlm_literal.h"
 #include "scratch.h"
@@ -38,9 +39,12 @@
 #include "util/ue2string.h"
 
 #include <cstring>
+#include <random>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 
+using std::string;
 using std::unique_ptr;
 using std::vector;
 using namespace ue2;
@@ -260,3 +264,209 @@ TEST(Noodle, noodCutoverDouble) {
     ctxt.clear();
 }
 
+
+static
+hwlmcb_rv_t hlmTerminateCallback(size_t to, u32 id,
+                                 UNUSED struct hs_scratch *scratch) {
+    ctxt.push_back(hlmMatchEntry(to, id));
+    return HWLM_TERMINATE_MATCHING;
+}
+
+// Groups returned by hlmGroupsCallback, as Rose returns the groups that are on
+// after each literal.
+static hwlm_group_t cbGroups;
+
+static
+hwlmcb_rv_t hlmGroupsCallback(size_t to, u32 id,
+                              UNUSED struct hs_scratch *scratch) {
+    ctxt.push_back(hlmMatchEntry(to, id));
+    return cbGroups;
+}
+
+// Brute force matches for lits in data, in end order and then literal order,
+// for literals beginning at or after start.
+static
+vector<hlmMatchEntry> multiReference(const string &data,
+                                     const vector<hwlmLiteral> &lits,
+                                     size_t start = 0) {
+    vector<hlmMatchEntry> expected;
+    for (size_t end = 0; end < data.size(); end++) {
+        for (const auto &lit : lits) {
+            const size_t len = lit.s.size();
+            if (end + 1 < start + len) {
+                continue;
+            }
+            string s = data.substr(end + 1 - len, len);
+            string l = lit.s;
+            if (lit.nocase) {
+                upperString(s);
+                upperString(l);
+            }
+            if (s == l) {
+                expected.push_back(hlmMatchEntry(end, lit.id));
+            }
+        }
+    }
+    return expected;
+}
+
+static
+void expectMatches(const vector<hlmMatchEntry> &expected) {
+    ASSERT_EQ(expected.size(), ctxt.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i].to, ctxt[i].to);
+        ASSERT_EQ(expected[i].id, ctxt[i].id);
+    }
+}
+
+static
+string randomString(std::mt19937 &rng, size_t len) {
+    const string alphabet = "abAB1";
+    string s;
+    for (size_t i = 0; i < len; i++) {
+        s += alphabet[rng() % alphabet.size()];
+    }
+    return s;
+}
+
+static
+vector<hwlmLiteral> randomMultiLits(std::mt19937 &rng) {
+    vector<hwlmLiteral> lits;
+    u32 count = 2 + rng() % (NOOD_MULTI_MAX - 1);
+    for (u32 i = 0; i < count; i++) {
+        lits.push_back(hwlmLiteral(randomString(rng, 1 + rng() % 8),
+                                   rng() % 2, false, 1000 + i, 1ULL << i, {},
+                                   {}));
+    }
+    return lits;
+}
+
+TEST(Noodle, noodMultiBlock) {
+    std::mt19937 rng(1);
+    for (u32 iter = 0; iter < 500; iter++) {
+        auto lits = randomMultiLits(rng);
+        auto nm = noodBuildMultiTable(lits);
+        ASSERT_TRUE(nm != nullptr);
+
+        string data = randomString(rng, rng() % 300);
+        size_t start = data.empty() ? 0 : rng() % (data.size() / 4 + 1);
+
+        ctxt.clear();
+        struct hs_scratch scratch;
+        hwlm_error_t rv = noodMultiExec(nm.get(), (const u8 *)data.data(),
+                                        data.size(), start, hlmSimpleCallback,
+                                        &scratch, HWLM_ALL_GROUPS);
+        ASSERT_EQ(HWLM_SUCCESS, rv);
+        expectMatches(multiReference(data, lits, start));
+    }
+    ctxt.clear();
+}
+
+TEST(Noodle, noodMultiStreaming) {
+    std::mt19937 rng(2);
+    for (u32 iter = 0; iter < 100; iter++) {
+        auto lits = randomMultiLits(rng);
+        auto nm = noodBuildMultiTable(lits);
+        ASSERT_TRUE(nm != nullptr);
+
+        string data = randomString(rng, 1 + rng() % 100);
+        auto expected = multiReference(data, lits);
+
+        // Split the data at every point, with up to 8 bytes of history.
+        for (size_t split = 0; split < data.size(); split++) {
+            const u8 *d = (const u8 *)data.data();
+            size_t hlen = std::min(split, size_t{8});
+
+            ctxt.clear();
+            struct hs_scratch scratch;
+            noodMultiExec(nm.get(), d, split, 0, hlmSimpleCallback, &scratch,
+                          HWLM_ALL_GROUPS);
+            size_t first = ctxt.size();
+            hwlm_error_t rv = noodMultiExecStreaming(
+                nm.get(), d + split - hlen, hlen, d + split, data.size() - split,
+                hlmSimpleCallback, &scratch, HWLM_ALL_GROUPS);
+            ASSERT_EQ(HWLM_SUCCESS, rv);
+            for (size_t i = first; i < ctxt.size(); i++) {
+                ctxt[i].to += split;
+            }
+            expectMatches(expected);
+        }
+    }
+    ctxt.clear();
+}
+
+TEST(Noodle, noodMultiGroups) {
+    vector<hwlmLiteral> lits;
+    lits.push_back(hwlmLiteral("abc", false, false, 1, 0x1, {}, {}));
+    lits.push_back(hwlmLiteral("bc", false, false, 2, 0x2, {}, {}));
+    lits.push_back(hwlmLiteral("C", true, false, 3, 0x4, {}, {}));
+    auto nm = noodBuildMultiTable(lits);
+    ASSERT_TRUE(nm != nullptr);
+
+    const string data = "xxabcxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxbcxxc";
+    struct hs_scratch scratch;
+
+    ctxt.clear();
+    cbGroups = 0x5;
+    noodMultiExec(nm.get(), (const u8 *)data.data(), data.size(), 0,
+                  hlmGroupsCallback, &scratch, 0x5);
+    expectMatches({{4, 1}, {4, 3}, {36, 3}, {39, 3}});
+
+    ctxt.clear();
+    noodMultiExec(nm.get(), (const u8 *)data.data(), data.size(), 0,
+                  hlmGroupsCallback, &scratch, 0x8);
+    ASSERT_EQ(0U, ctxt.size());
+
+    ctxt.clear();
+    hwlm_error_t rv = noodMultiExec(nm.get(), (const u8 *)data.data(),
+                                    data.size(), 0, hlmTerminateCallback,
+                                    &scratch, HWLM_ALL_GROUPS);
+    ASSERT_EQ(HWLM_TERMINATED, rv);
+    expectMatches({{4, 1}});
+    ctxt.clear();
+}
+
+// The callback's return value is the set of groups that are on from then on:
+// literals switched on mid-scan must be reported, and literals switched off
+// must not be.
+TEST(Noodle, noodMultiGroupsFromCallback) {
+    vector<hwlmLiteral> lits;
+    lits.push_back(hwlmLiteral("abc", false, false, 1, 0x1, {}, {}));
+    lits.push_back(hwlmLiteral("bc", false, false, 2, 0x2, {}, {}));
+    auto nm = noodBuildMultiTable(lits);
+    ASSERT_TRUE(nm != nullptr);
+
+    const string gap(100, 'x');
+    const string data = "bc" + gap + "abc" + gap + "bc";
+    const u8 *d = (const u8 *)data.data();
+    struct hs_scratch scratch;
+
+    // "abc" switches on the group for "bc", which is then reported at the
+    // same end offset and later.
+    ctxt.clear();
+    cbGroups = 0x3;
+    hwlm_error_t rv = noodMultiExec(nm.get(), d, data.size(), 0,
+                                    hlmGroupsCallback, &scratch, 0x1);
+    ASSERT_EQ(HWLM_SUCCESS, rv);
+    expectMatches({{104, 1}, {104, 2}, {206, 2}});
+
+    // "abc" switches off every group but its own.
+    ctxt.clear();
+    cbGroups = 0x1;
+    rv = noodMultiExec(nm.get(), d, data.size(), 0, hlmGroupsCallback,
+                       &scratch, 0x3);
+    ASSERT_EQ(HWLM_SUCCESS, rv);
+    expectMatches({{1, 2}, {104, 1}});
+
+    // In streaming mode, with "abc" split between history and the new data.
+    const string hist = gap + "ab";
+    const string buf = "c" + gap + "bc";
+    ctxt.clear();
+    cbGroups = 0x3;
+    rv = noodMultiExecStreaming(nm.get(), (const u8 *)hist.data(),
+                                hist.size(), (const u8 *)buf.data(),
+                                buf.size(), hlmGroupsCallback, &scratch, 0x1);
+    ASSERT_EQ(HWLM_SUCCESS, rv);
+    expectMatches({{0, 1}, {0, 2}, {102, 2}});
+    ctxt.clear();
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "ue2common.h"
+#include "grey.h"
+#include "nfa/callback.h"
+#include "nfa/mcclellancompile.h"
+#include "nfa/mcsheng_compile.h"
+#include "nfa/nfa_api.h"
+#include "nfa/nfa_api_queue.h"
+#include "nfa/nfa_api_util.h"
+#include "nfa/nfa_internal.h"
+#include "nfa/rdfa.h"
+#include "nfa/shengcompile.h"
+#include "util/bytecode_ptr.h"
+#include "util/compile_context.h"
+#include "util/report_manager.h"
+#include "util/target_info.h"
+#include "util/random_dfa.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace ue2;
+
+namespace {
+
+static const u32 REPORT_COUNT = 3;
+static const u32 REPORT_RATE = 8;
+static const u32 EOD_RATE = 16;
+static const u32 DFAS_PER_SHAPE = 40;
+
+using Matches = vector<pair<u64a, ReportID>>;
+
+int onMatch(u64a, u64a end, ReportID id, void *ctx) {
+    auto *matches = static_cast<Matches *>(ctx);
+    matches->emplace_back(end, id);
+    return MO_CONTINUE_MATCHING;
+}
+
+raw_dfa makeDfa(u32 core, u32 tail, mt19937 &prng) {
+    return makeRandomDfa(core, tail, REPORT_COUNT, REPORT_RATE, EOD_RATE,
+                         prng);
+}
+
+// Scans buf through the queue API in writes of at most chunk bytes,
+// compressing and expanding the state between writes as streaming mode does,
+// then checks for EOD matches.
+Matches scan(const NFA *nfa, const vector<u8> &buf, size_t chunk) {
+    Matches matches;
+    auto full_state = make_bytecode_ptr<char>(nfa->scratchStateSize, 64);
+    auto stream_state = make_bytecode_ptr<char>(nfa->streamStateSize);
+
+    struct mq q;
+    q.nfa = nfa;
+    q.state = full_state.get();
+    q.streamState = stream_state.get();
+    q.history = nullptr;
+    q.hlength = 0;
+    q.scratch = nullptr; /* outfix DFAs do not use scratch */
+    q.report_current = 0;
+    q.cb = onMatch;
+    q.context = &matches;
+
+    for (size_t pos = 0; pos < buf.size(); pos += chunk) {
+        size_t len = min(chunk, buf.size() - pos);
+        q.cur = 0;
+        q.end = 0;
+        q.offset = pos;
+        q.buffer = buf.data() + pos;
+        q.length = len;
+        if (!pos) {
+            nfaQueueInitState(nfa, &q);
+            pushQueue(&q, MQE_START, 0);
+            pushQueue(&q, MQE_TOP, 0);
+        } else {
+            q.history = buf.data();
+            q.hlength = pos;
+            nfaExpandState(nfa, q.state, q.streamState, q.offset,
+                           queue_prev_byte(&q, 0));
+            pushQueue(&q, MQE_START, 0);
+        }
+        pushQueue(&q, MQE_END, len);
+        nfaQueueExec(nfa, &q, len);
+        nfaQueueCompressState(nfa, &q, len);
+    }
+
+    nfaCheckFinalState(nfa, q.state, q.streamState, buf.size(), onMatch,
+                       &matches);
+    return matches;
+}
+
+class WideShengTest : public ::testing::Test {
+protected:
+    WideShengTest()
+        : target(get_current_target()), cc(false, false, target, grey),
+          rm(grey), prng(21) {
+        for (u32 i = 0; i < REPORT_COUNT; i++) {
+            rm.getInternalId(makeCallback(i, 0));
+            rm.setProgramOffset(i, i);
+        }
+    }
+
+    vector<u8> randomData(size_t len) {
+        vector<u8> buf(len);
+        for (auto &c : buf) {
+            c = prng();
+        }
+        return buf;
+    }
+
+    // Checks that the wide engine finds exactly the matches of the McClellan
+    // DFA built from the same raw DFA, both in one write and split across
+    // writes of random sizes.
+    void check(const NFA *wide, raw_dfa &raw) {
+        auto mcclellan = mcclellanCompile(raw, cc, rm, false);
+        ASSERT_TRUE(mcclellan != nullptr);
+        ASSERT_TRUE(isMcClellanType(mcclellan->type));
+
+        auto buf = randomData(2048);
+        Matches expected = scan(mcclellan.get(), buf, buf.size());
+        ASSERT_EQ(expected, scan(wide, buf, buf.size()));
+        for (u32 i = 0; i < 4; i++) {
+            size_t chunk = 1 + prng() % 200;
+            ASSERT_EQ(expected, scan(wide, buf, chunk));
+        }
+    }
+
+    Grey grey;
+    target_t target;
+    CompileContext cc;
+    ReportManager rm;
+    mt19937 prng;
+};
+
+} // namespace
+
+TEST_F(WideShengTest, Sheng32) {
+    u32 tested = 0;
+    for (u32 i = 0; i < DFAS_PER_SHAPE; i++) {
+        raw_dfa raw = makeDfa(17 + prng() % 16, 0, prng);
+        raw_dfa mc_raw = raw;
+        auto nfa = sheng32Compile(raw, cc, rm, false);
+        if (!target.has_wide_sheng()) {
+            ASSERT_TRUE(nfa == nullptr);
+            continue;
+        }
+        if (!nfa) {
+            continue;
+        }
+        ASSERT_EQ(SHENG_NFA_32, nfa->type);
+        check(nfa.get(), mc_raw);
+        tested++;
+    }
+    if (target.has_wide_sheng()) {
+        ASSERT_LT(0U, tested);
+    }
+}
+
+TEST_F(WideShengTest, Sheng64) {
+    u32 tested = 0;
+    for (u32 i = 0; i < DFAS_PER_SHAPE; i++) {
+        raw_dfa raw = makeDfa(33 + prng() % 32, 0, prng);
+        raw_dfa mc_raw = raw;
+        auto nfa = sheng64Compile(raw, cc, rm, false);
+        if (!target.has_wide_sheng()) {
+            ASSERT_TRUE(nfa == nullptr);
+            continue;
+        }
+        if (!nfa) {
+            continue;
+        }
+        ASSERT_EQ(SHENG_NFA_64, nfa->type);
+        check(nfa.get(), mc_raw);
+        tested++;
+    }
+    if (target.has_wide_sheng()) {
+        ASSERT_LT(0U, tested);
+    }
+}
+
+TEST_F(WideShengTest, McSheng64) {
+    u32 tested = 0;
+    for (u32 i = 0; i < DFAS_PER_SHAPE; i++) {
+        raw_dfa raw = makeDfa(17 + prng() % 48, 30 + prng() % 200, prng);
+        raw_dfa mc_raw = raw;
+        auto nfa = mcshengCompile64(raw, cc, rm);
+        if (!target.has_wide_sheng()) {
+            ASSERT_TRUE(nfa == nullptr);
+            continue;
+        }
+        if (!nfa) {
+            continue;
+        }
+        ASSERT_TRUE(nfa->type == MCSHENG_64_NFA_8 ||
+                    nfa->type == MCSHENG_64_NFA_16);
+        check(nfa.get(), mc_raw);
+        tested++;
+    }
+    if (target.has_wide_sheng()) {
+        ASSERT_LT(0U, tested);
+    }
+}
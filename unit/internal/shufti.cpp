@@ -29,7 +29,9 @@
 
 #include "config.h"
 
+#include <array>
 #include <set>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "nfa/shufti.h"
@@ -903,6 +905,216 @@ TEST(DoubleShufti, ExecMatchMixed3) {
     }
 }
 
+static
+std::array<CharReach, 3> makeTriple(const CharReach &a, const CharReach &b,
+                                    const CharReach &c) {
+    return {{a, b, c}};
+}
+
+TEST(TripleShufti, BuildMask1) {
+    m128 lo1m, hi1m, lo2m, hi2m, lo3m, hi3m;
+
+    std::vector<std::array<CharReach, 3>> triples;
+    triples.push_back(makeTriple(CharReach('a'), CharReach('B'),
+                                 CharReach('z')));
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1m, (u8 *)&hi1m,
+                                      (u8 *)&lo2m, (u8 *)&hi2m,
+                                      (u8 *)&lo3m, (u8 *)&hi3m);
+    ASSERT_TRUE(ret);
+
+    const u8 *lo1 = (const u8 *)&lo1m;
+    const u8 *hi1 = (const u8 *)&hi1m;
+    const u8 *lo2 = (const u8 *)&lo2m;
+    const u8 *hi2 = (const u8 *)&hi2m;
+    const u8 *lo3 = (const u8 *)&lo3m;
+    const u8 *hi3 = (const u8 *)&hi3m;
+    for (int i = 0; i < 16; i++) {
+        ASSERT_EQ(i == 'a' % 16 ? 254 : 255, lo1[i]);
+        ASSERT_EQ(i == 'a' >> 4 ? 254 : 255, hi1[i]);
+        ASSERT_EQ(i == 'B' % 16 ? 254 : 255, lo2[i]);
+        ASSERT_EQ(i == 'B' >> 4 ? 254 : 255, hi2[i]);
+        ASSERT_EQ(i == 'z' % 16 ? 254 : 255, lo3[i]);
+        ASSERT_EQ(i == 'z' >> 4 ? 254 : 255, hi3[i]);
+    }
+}
+
+TEST(TripleShufti, BuildMask2) {
+    m128 lo1m, hi1m, lo2m, hi2m, lo3m, hi3m;
+
+    // triples differing only in the middle class are merged, but not beyond
+    // what the nibble masks can represent exactly
+    std::vector<std::array<CharReach, 3>> triples;
+    for (u8 c = 'a'; c <= 'z'; c++) {
+        triples.push_back(makeTriple(CharReach('x'), CharReach(c),
+                                     CharReach('y')));
+    }
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1m, (u8 *)&hi1m,
+                                      (u8 *)&lo2m, (u8 *)&hi2m,
+                                      (u8 *)&lo3m, (u8 *)&hi3m);
+    ASSERT_TRUE(ret);
+
+    const u8 *lo1 = (const u8 *)&lo1m;
+    const u8 *hi1 = (const u8 *)&hi1m;
+    const u8 *lo2 = (const u8 *)&lo2m;
+    const u8 *hi2 = (const u8 *)&hi2m;
+    const u8 *lo3 = (const u8 *)&lo3m;
+    const u8 *hi3 = (const u8 *)&hi3m;
+
+    // two buckets, 'p'-'z' and 'a'-'o', which share the outer classes
+    for (int i = 0; i < 16; i++) {
+        ASSERT_EQ(i == 'x' % 16 ? 0xfc : 0xff, lo1[i]);
+        ASSERT_EQ(i == 'x' >> 4 ? 0xfc : 0xff, hi1[i]);
+        ASSERT_EQ(i == 'y' % 16 ? 0xfc : 0xff, lo3[i]);
+        ASSERT_EQ(i == 'y' >> 4 ? 0xfc : 0xff, hi3[i]);
+        ASSERT_EQ(0xff & ~(i <= 0xa ? 1 : 0) & ~(i >= 1 ? 2 : 0), lo2[i]);
+        ASSERT_EQ(i == 7 ? 0xfe : i == 6 ? 0xfd : 0xff, hi2[i]);
+    }
+
+    for (u8 c = 'a'; c <= 'z'; c++) {
+        ASSERT_NE(0xff, lo1['x' % 16] | hi1['x' >> 4] | lo2[c % 16] |
+                        hi2[c >> 4] | lo3['y' % 16] | hi3['y' >> 4]);
+    }
+    // inside the nibble hull of [a-z], but in neither bucket
+    ASSERT_EQ(0xff, lo1['x' % 16] | hi1['x' >> 4] | lo2['`' % 16] |
+                    hi2['`' >> 4] | lo3['y' % 16] | hi3['y' >> 4]);
+    ASSERT_EQ(0xff, lo1['x' % 16] | hi1['x' >> 4] | lo2['{' % 16] |
+                    hi2['{' >> 4] | lo3['y' % 16] | hi3['y' >> 4]);
+    ASSERT_EQ(0xff, lo1['w' % 16] | hi1['w' >> 4] | lo2['m' % 16] |
+                    hi2['m' >> 4] | lo3['y' % 16] | hi3['y' >> 4]);
+    ASSERT_EQ(0xff, lo1['x' % 16] | hi1['x' >> 4] | lo2['m' % 16] |
+                    hi2['m' >> 4] | lo3['z' % 16] | hi3['z' >> 4]);
+}
+
+TEST(TripleShufti, BuildMaskTooMany) {
+    m128 lo1, hi1, lo2, hi2, lo3, hi3;
+
+    std::vector<std::array<CharReach, 3>> triples;
+    for (u8 i = 0; i < 9; i++) {
+        triples.push_back(makeTriple(CharReach('a' + i), CharReach('A' + i),
+                                     CharReach('0' + i)));
+    }
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                      (u8 *)&lo2, (u8 *)&hi2,
+                                      (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_FALSE(ret);
+
+    triples.pop_back();
+    ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                 (u8 *)&lo2, (u8 *)&hi2,
+                                 (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_TRUE(ret);
+}
+
+TEST(TripleShufti, ExecNoMatch1) {
+    m128 lo1, hi1, lo2, hi2, lo3, hi3;
+
+    std::vector<std::array<CharReach, 3>> triples;
+    triples.push_back(makeTriple(CharReach('a'), CharReach('b'),
+                                 CharReach('c')));
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                      (u8 *)&lo2, (u8 *)&hi2,
+                                      (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_TRUE(ret);
+
+    // near misses everywhere
+    char t1[] = "abbxbcaxcabbxbcaxcabbxbcaxcabbxbcaxcabbxbcaxcabbxbcaxcabbxbcaxc";
+    const u8 *end = (u8 *)t1 + strlen(t1) - 2;
+
+    for (size_t i = 0; i < 16; i++) {
+        const u8 *rv = shuftiTripleExec(lo1, hi1, lo2, hi2, lo3, hi3,
+                                        (u8 *)t1 + i, end);
+
+        ASSERT_EQ(end, rv);
+    }
+}
+
+TEST(TripleShufti, ExecMatch1) {
+    m128 lo1, hi1, lo2, hi2, lo3, hi3;
+
+    std::vector<std::array<CharReach, 3>> triples;
+    triples.push_back(makeTriple(CharReach('a'), CharReach('b'),
+                                 CharReach('c')));
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                      (u8 *)&lo2, (u8 *)&hi2,
+                                      (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_TRUE(ret);
+
+    /*          0123456789012345678901234567890 */
+    char t1[] = "bbbbbbbbbbbbbbbbbabbabcbbbbbbbbbbbbbbbbbbbbbbbbbbbbabcbbbbbbbbbbb";
+
+    for (size_t i = 0; i < 16; i++) {
+        const u8 *rv = shuftiTripleExec(lo1, hi1, lo2, hi2, lo3, hi3,
+                                        (u8 *)t1 + i,
+                                        (u8 *)t1 + strlen(t1) - 2);
+
+        ASSERT_EQ((const u8 *)t1 + 20, rv);
+    }
+}
+
+TEST(TripleShufti, ExecMatchClasses) {
+    m128 lo1, hi1, lo2, hi2, lo3, hi3;
+
+    // [ab] followed by anything, then [xy]
+    CharReach ab;
+    ab.set('a');
+    ab.set('b');
+    CharReach xy;
+    xy.set('x');
+    xy.set('y');
+    std::vector<std::array<CharReach, 3>> triples;
+    triples.push_back(makeTriple(ab, CharReach::dot(), xy));
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                      (u8 *)&lo2, (u8 *)&hi2,
+                                      (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_TRUE(ret);
+
+    const int len = 420;
+    char t1[len + 2];
+    memset(t1, 'c', len + 2);
+
+    for (size_t i = 2; i < 400; i++) {
+        t1[len - i] = i % 2 ? 'a' : 'b';
+        t1[len - i + 2] = i % 3 ? 'y' : 'x';
+        const u8 *rv = shuftiTripleExec(lo1, hi1, lo2, hi2, lo3, hi3,
+                                        (u8 *)t1, (u8 *)t1 + len);
+
+        ASSERT_EQ((const u8 *)&t1[len - i], rv);
+        t1[len - i + 2] = 'c';
+    }
+}
+
+TEST(TripleShufti, ExecMatchTail) {
+    m128 lo1, hi1, lo2, hi2, lo3, hi3;
+
+    std::vector<std::array<CharReach, 3>> triples;
+    triples.push_back(makeTriple(CharReach('x'), CharReach('y'),
+                                 CharReach('z')));
+
+    bool ret = shuftiBuildTripleMasks(triples, (u8 *)&lo1, (u8 *)&hi1,
+                                      (u8 *)&lo2, (u8 *)&hi2,
+                                      (u8 *)&lo3, (u8 *)&hi3);
+    ASSERT_TRUE(ret);
+
+    // a triple may start at any position before buf_end, even if it ends
+    // beyond it
+    for (size_t len = 1; len < 140; len++) {
+        std::vector<u8> t1(len + 2, 'b');
+        t1[len - 1] = 'x';
+        t1[len] = 'y';
+        t1[len + 1] = 'z';
+        const u8 *rv = shuftiTripleExec(lo1, hi1, lo2, hi2, lo3, hi3,
+                                        t1.data(), t1.data() + len);
+
+        ASSERT_EQ(t1.data() + len - 1, rv);
+    }
+}
+
 TEST(ReverseShufti, ExecNoMatch1) {
     m128 lo, hi;
 
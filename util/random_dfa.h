@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024, VectorCamp PC
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file
+ * \brief Random DFA generator shared by the wide sheng unit tests and
+ * benchmarks.
+ */
+
+#ifndef RANDOM_DFA_H
+#define RANDOM_DFA_H
+
+#include "ue2common.h"
+#include "nfa/rdfa.h"
+
+#include <random>
+
+/**
+ * \brief Random anchored DFA. States 1..core are dense; the rest are left
+ * for one in three transitions, and entered from the core on one class.
+ *
+ * One state in \p report_rate raises one of \p report_count reports, and one
+ * in \p eod_rate raises one at EOD; an \p eod_rate of zero gives no EOD
+ * reports. With a tail, the class entering it is a single byte and only tail
+ * states report, so that the core is a sheng region McSheng can use.
+ */
+inline
+ue2::raw_dfa makeRandomDfa(u32 core, u32 tail, u32 report_count,
+                           u32 report_rate, u32 eod_rate, std::mt19937 &prng) {
+    u32 nstates = 1 + core + tail;
+    ue2::raw_dfa r(ue2::NFA_OUTFIX);
+    u32 nclass = 4 + prng() % 12;
+    r.alpha_size = nclass + 1;
+    for (u32 c = 0; c < N_CHARS; c++) {
+        r.alpha_remap[c] = tail ? 1 + prng() % (nclass - 1) : prng() % nclass;
+    }
+    if (tail) {
+        r.alpha_remap[prng() % N_CHARS] = 0;
+    }
+    r.alpha_remap[ue2::TOP] = nclass;
+
+    auto pick_core = [&]() { return 1 + prng() % core; };
+    auto pick_tail = [&]() { return core + 1 + prng() % tail; };
+    for (u32 s = 0; s < nstates; s++) {
+        ue2::dstate d(r.alpha_size);
+        if (s != ue2::DEAD_STATE) {
+            bool in_core = s <= core;
+            for (u32 a = 0; a < nclass; a++) {
+                if (tail && in_core && !a && prng() % 3 == 0) {
+                    d.next[a] = pick_tail();
+                } else if (in_core || prng() % 3) {
+                    d.next[a] = pick_core();
+                } else {
+                    d.next[a] = pick_tail();
+                }
+            }
+            d.next[nclass] = 1;
+            bool can_report = !tail || !in_core;
+            if (can_report && prng() % report_rate == 0) {
+                d.reports.insert(prng() % report_count);
+            }
+            if (can_report && eod_rate && prng() % eod_rate == 0) {
+                d.reports_eod.insert(prng() % report_count);
+            }
+        }
+        r.states.push_back(d);
+    }
+    r.start_anchored = 1;
+    r.start_floating = ue2::DEAD_STATE;
+    return r;
+}
+
+#endif // RANDOM_DFA_H